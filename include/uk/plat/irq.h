@@ -56,6 +56,16 @@ typedef int (*irq_handler_func_t)(void *);
  */
 int ukplat_irq_register(unsigned long irq, irq_handler_func_t func, void *arg);
 
+/**
+ * Unregisters an interrupt handler
+ * @param irq Interrupt number
+ * @param func Interrupt function that was registered
+ * @param arg Extra argument that was registered with the function
+ * @return 0 on success, -ENOENT if the handler was not registered
+ */
+int ukplat_irq_unregister(unsigned long irq, irq_handler_func_t func,
+			  void *arg);
+
 #ifdef __cplusplus
 }
 #endif
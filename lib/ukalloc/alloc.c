@@ -64,6 +64,10 @@ int uk_alloc_register(struct uk_alloc *a)
 {
 	struct uk_alloc *this = _uk_alloc_head;
 
+#if CONFIG_LIBUKALLOC_IFSTATS
+	memset(&a->_stats, 0, sizeof(a->_stats));
+#endif
+
 	if (!_uk_alloc_head) {
 		_uk_alloc_head = a;
 		a->next = NULL;
@@ -77,6 +81,68 @@ int uk_alloc_register(struct uk_alloc *a)
 	return 0;
 }
 
+int uk_alloc_unregister(struct uk_alloc *a)
+{
+	struct uk_alloc *this = _uk_alloc_head;
+
+	UK_ASSERT(a);
+
+	if (_uk_alloc_head == a) {
+		_uk_alloc_head = a->next;
+		a->next = NULL;
+		return 0;
+	}
+
+	while (this && this->next != a)
+		this = this->next;
+	if (!this)
+		return -ENOENT;
+	this->next = a->next;
+	a->next = NULL;
+	return 0;
+}
+
+int uk_alloc_set_default(struct uk_alloc *a)
+{
+	struct uk_alloc *this = _uk_alloc_head;
+
+	UK_ASSERT(a);
+
+	if (_uk_alloc_head == a)
+		return 0;
+
+	/* unlink allocator from its current position */
+	while (this && this->next != a)
+		this = this->next;
+	if (!this)
+		return -ENOENT;
+	this->next = a->next;
+
+	/* and prepend it to the list */
+	a->next = _uk_alloc_head;
+	_uk_alloc_head = a;
+	return 0;
+}
+
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP || CONFIG_LIBUKALLOC_PROFILE_DUMP
+void uk_alloc_shutdown_dump(void)
+{
+	static int dumped;
+
+	/* A crash while dumping must not dump again */
+	if (dumped)
+		return;
+	dumped = 1;
+
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP
+	uk_alloc_stats_dump_all();
+#endif
+#if CONFIG_LIBUKALLOC_PROFILE_DUMP
+	uk_alloc_prof_dump(NULL, NULL);
+#endif
+}
+#endif
+
 struct metadata_ifpages {
 	unsigned long	num_pages;
 	void		*base;
@@ -125,6 +191,11 @@ static size_t uk_getmallocsize(const void *ptr)
 	       __PAGE_SIZE - (size_t)ptr;
 }
 
+size_t uk_getsize_ifpages(struct uk_alloc *a __unused, const void *ptr)
+{
+	return uk_getmallocsize(ptr);
+}
+
 void *uk_malloc_ifpages(struct uk_alloc *a, size_t size)
 {
 	uintptr_t intptr;
@@ -138,7 +209,7 @@ void *uk_malloc_ifpages(struct uk_alloc *a, size_t size)
 		return NULL;
 
 	num_pages = size_to_num_pages(realsize);
-	intptr = (uintptr_t)uk_palloc(a, num_pages);
+	intptr = (uintptr_t)a->palloc(a, num_pages);
 
 	if (!intptr)
 		return NULL;
@@ -162,13 +233,45 @@ void uk_free_ifpages(struct uk_alloc *a, void *ptr)
 
 	UK_ASSERT(metadata->base != NULL);
 	UK_ASSERT(metadata->num_pages != 0);
-	uk_pfree(a, metadata->base, metadata->num_pages);
+	a->pfree(a, metadata->base, metadata->num_pages);
+}
+
+void *uk_calloc_ifpages(struct uk_alloc *a, size_t nmemb, size_t size)
+{
+	uintptr_t intptr;
+	unsigned long num_pages;
+	struct metadata_ifpages *metadata;
+	size_t tlen = nmemb * size;
+	size_t realsize = sizeof(*metadata) + tlen;
+
+	UK_ASSERT(a);
+	if (!a->pzalloc)
+		return uk_calloc_compat(a, nmemb, size);
+
+	/* check for invalid size and overflow */
+	if (!tlen || nmemb > (~(size_t)0)/size || realsize < tlen)
+		return NULL;
+
+	/* pages come zeroed already, only the metadata is written */
+	num_pages = size_to_num_pages(realsize);
+	intptr = (uintptr_t)a->pzalloc(a, num_pages);
+
+	if (!intptr)
+		return NULL;
+
+	metadata = (struct metadata_ifpages *) intptr;
+	metadata->num_pages = num_pages;
+	metadata->base = (void *) intptr;
+
+	return (void *)(intptr + sizeof(*metadata));
 }
 
 void *uk_realloc_ifpages(struct uk_alloc *a, void *ptr, size_t size)
 {
+	struct metadata_ifpages *metadata;
+	unsigned long num_pages;
 	void *retptr;
-	size_t mallocsize;
+	size_t mallocsize, realsize;
 
 	UK_ASSERT(a);
 	if (!ptr)
@@ -179,6 +282,23 @@ void *uk_realloc_ifpages(struct uk_alloc *a, void *ptr, size_t size)
 		return NULL;
 	}
 
+	/* try to grow or shrink the allocation in place first */
+	if (a->presize) {
+		metadata = uk_get_metadata(ptr);
+		realsize = ((uintptr_t) ptr - (uintptr_t) metadata->base)
+			   + size;
+		if (realsize > size) {
+			num_pages = size_to_num_pages(realsize);
+			if (num_pages == metadata->num_pages)
+				return ptr;
+			if (a->presize(a, metadata->base, metadata->num_pages,
+				       num_pages) == 0) {
+				metadata->num_pages = num_pages;
+				return ptr;
+			}
+		}
+	}
+
 	retptr = uk_malloc_ifpages(a, size);
 	if (!retptr)
 		return NULL;
@@ -253,7 +373,7 @@ int uk_posix_memalign_ifpages(struct uk_alloc *a,
 		return EINVAL;
 
 	num_pages = size_to_num_pages(realsize);
-	intptr = (uintptr_t) uk_palloc(a, num_pages);
+	intptr = (uintptr_t) a->palloc(a, num_pages);
 
 	if (!intptr)
 		return ENOMEM;
@@ -296,6 +416,11 @@ static size_t uk_getmallocsize_ifmalloc(const void *ptr)
 			 (uintptr_t) ptr);
 }
 
+size_t uk_getsize_ifmalloc(struct uk_alloc *a __unused, const void *ptr)
+{
+	return uk_getmallocsize_ifmalloc(ptr);
+}
+
 void uk_free_ifmalloc(struct uk_alloc *a, void *ptr)
 {
 	struct metadata_ifmalloc *metadata;
@@ -421,7 +546,7 @@ void uk_pfree_compat(struct uk_alloc *a, void *ptr,
 	/* if the object is not page aligned it was clearly not from us */
 	UK_ASSERT(page_off(ptr) == 0);
 
-	uk_free(a, ptr);
+	a->free(a, ptr);
 }
 
 void *uk_palloc_compat(struct uk_alloc *a, unsigned long num_pages)
@@ -434,7 +559,7 @@ void *uk_palloc_compat(struct uk_alloc *a, unsigned long num_pages)
 	if (num_pages > (~(size_t)0)/__PAGE_SIZE)
 		return NULL;
 
-	if (uk_posix_memalign(a, &ptr, __PAGE_SIZE, num_pages * __PAGE_SIZE))
+	if (a->posix_memalign(a, &ptr, __PAGE_SIZE, num_pages * __PAGE_SIZE))
 		return NULL;
 
 	return ptr;
@@ -446,20 +571,20 @@ void *uk_realloc_compat(struct uk_alloc *a, void *ptr, size_t size)
 
 	UK_ASSERT(a);
 	if (!ptr)
-		return uk_malloc(a, size);
+		return a->malloc(a, size);
 
 	if (ptr && !size) {
-		uk_free(a, ptr);
+		a->free(a, ptr);
 		return NULL;
 	}
 
-	retptr = uk_malloc(a, size);
+	retptr = a->malloc(a, size);
 	if (!retptr)
 		return NULL;
 
 	memcpy(retptr, ptr, size);
 
-	uk_free(a, ptr);
+	a->free(a, ptr);
 	return retptr;
 }
 
@@ -473,7 +598,7 @@ void *uk_calloc_compat(struct uk_alloc *a, size_t nmemb, size_t size)
 		return NULL;
 
 	UK_ASSERT(a);
-	ptr = uk_malloc(a, tlen);
+	ptr = a->malloc(a, tlen);
 	if (!ptr)
 		return NULL;
 
@@ -486,7 +611,7 @@ void *uk_memalign_compat(struct uk_alloc *a, size_t align, size_t size)
 	void *ptr;
 
 	UK_ASSERT(a);
-	if (uk_posix_memalign(a, &ptr, align, size) != 0)
+	if (a->posix_memalign(a, &ptr, align, size) != 0)
 		return NULL;
 
 	return ptr;
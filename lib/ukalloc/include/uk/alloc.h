@@ -41,6 +41,7 @@
 #include <uk/config.h>
 #include <uk/assert.h>
 #include <uk/essentials.h>
+#include <uk/arch/limits.h>
 
 struct uk_alloc;
 
@@ -67,11 +68,37 @@ typedef void* (*uk_alloc_palloc_func_t)
 		(struct uk_alloc *a, unsigned long num_pages);
 typedef void  (*uk_alloc_pfree_func_t)
 		(struct uk_alloc *a, void *ptr, unsigned long num_pages);
+typedef void* (*uk_alloc_pzalloc_func_t)
+		(struct uk_alloc *a, unsigned long num_pages);
+typedef int   (*uk_alloc_presize_func_t)
+		(struct uk_alloc *a, void *ptr, unsigned long num_pages,
+		 unsigned long new_num_pages);
 typedef int   (*uk_alloc_addmem_func_t)
 		(struct uk_alloc *a, void *base, size_t size);
+typedef size_t (*uk_alloc_getsize_func_t)
+		(struct uk_alloc *a, const void *ptr);
 #if CONFIG_LIBUKALLOC_IFSTATS
 typedef ssize_t (*uk_alloc_availmem_func_t)
 		(struct uk_alloc *a);
+typedef void  (*uk_alloc_dumpstats_func_t)
+		(struct uk_alloc *a);
+
+struct uk_alloc_stats {
+	size_t last_alloc_size;   /* size of the last allocation */
+	size_t max_alloc_size;    /* biggest satisfied allocation */
+	size_t min_alloc_size;    /* smallest satisfied allocation */
+
+	unsigned long tot_nb_allocs; /* number of satisfied allocations */
+	unsigned long tot_nb_frees;  /* number of free operations */
+	long cur_nb_allocs;          /* number of live allocations */
+	long max_nb_allocs;          /* peak of live allocations */
+
+	/* Only counted if the allocator implements getsize */
+	ssize_t cur_mem_use;      /* bytes currently handed out */
+	ssize_t max_mem_use;      /* peak of bytes handed out */
+
+	unsigned long nb_enomem;  /* number of failed allocations */
+};
 #endif
 
 struct uk_alloc {
@@ -91,30 +118,119 @@ struct uk_alloc {
 	/* page allocation interface */
 	uk_alloc_palloc_func_t palloc;
 	uk_alloc_pfree_func_t pfree;
+	/* optional interface */
+	uk_alloc_pzalloc_func_t pzalloc;
+	uk_alloc_presize_func_t presize;
 #if CONFIG_LIBUKALLOC_IFSTATS
 	/* optional interface */
 	uk_alloc_availmem_func_t availmem;
+	uk_alloc_dumpstats_func_t dumpstats;
 #endif
 	/* optional interface */
 	uk_alloc_addmem_func_t addmem;
+	uk_alloc_getsize_func_t getsize;
 
 	/* internal */
 	struct uk_alloc *next;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	struct uk_alloc_stats _stats;
+#endif
 	int8_t priv[];
 };
 
 extern struct uk_alloc *_uk_alloc_head;
 
+/* Iterate over all registered allocators */
+#define uk_alloc_foreach(iter)						\
+	for (iter = _uk_alloc_head;					\
+	     iter != NULL;						\
+	     iter = iter->next)
+
 static inline struct uk_alloc *uk_alloc_get_default(void)
 {
 	return _uk_alloc_head;
 }
 
+/**
+ * Returns the usable size of an allocated object.
+ *
+ * @param a
+ *   Allocator that was used for allocating the object
+ * @param ptr
+ *   Pointer to the object
+ * @return
+ *   Usable size (bytes), 0 if ptr is NULL or the allocator
+ *   does not support this operation
+ */
+static inline size_t uk_alloc_size(struct uk_alloc *a, const void *ptr)
+{
+	UK_ASSERT(a);
+	if (!ptr || !a->getsize)
+		return 0;
+	return a->getsize(a, ptr);
+}
+
+#if CONFIG_LIBUKALLOC_IFSTATS
+void _uk_alloc_stats_count_alloc(struct uk_alloc *a, void *ptr, size_t size);
+void _uk_alloc_stats_count_free(struct uk_alloc *a, void *ptr, size_t size);
+void _uk_alloc_stats_count_enomem(struct uk_alloc *a, size_t size);
+
+/* Size that is accounted for an object: the real size if the allocator
+ * knows it, the requested size otherwise
+ */
+static inline size_t _uk_alloc_stats_objsize(struct uk_alloc *a,
+					     const void *ptr, size_t size)
+{
+	if (ptr && a->getsize)
+		return a->getsize(a, ptr);
+	return size;
+}
+#else
+#define _uk_alloc_stats_count_alloc(a, ptr, size) do {} while (0)
+#define _uk_alloc_stats_count_free(a, ptr, size) do {} while (0)
+#define _uk_alloc_stats_count_enomem(a, size) do {} while (0)
+#endif /* CONFIG_LIBUKALLOC_IFSTATS */
+
+#if CONFIG_LIBUKALLOC_PROFILE
+/* bytes left until the next sample, LONG_MAX while profiling is stopped */
+extern long _uk_alloc_prof_left;
+/* number of sampled allocations that are still live */
+extern unsigned long _uk_alloc_prof_nr_live;
+
+void _uk_alloc_prof_sample(void *ptr, size_t size);
+void _uk_alloc_prof_release(void *ptr);
+
+static inline void _uk_alloc_prof_count_alloc(void *ptr, size_t size)
+{
+	if (unlikely(!ptr))
+		return;
+
+	_uk_alloc_prof_left -= (long) size;
+	if (unlikely(_uk_alloc_prof_left < 0))
+		_uk_alloc_prof_sample(ptr, size);
+}
+
+static inline void _uk_alloc_prof_count_free(void *ptr)
+{
+	if (unlikely(_uk_alloc_prof_nr_live != 0) && ptr)
+		_uk_alloc_prof_release(ptr);
+}
+#else
+#define _uk_alloc_prof_count_alloc(ptr, size) do {} while (0)
+#define _uk_alloc_prof_count_free(ptr) do {} while (0)
+#endif /* CONFIG_LIBUKALLOC_PROFILE */
+
 /* wrapper functions */
 static inline void *uk_do_malloc(struct uk_alloc *a, size_t size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->malloc(a, size);
+	ptr = a->malloc(a, size);
+	_uk_alloc_stats_count_alloc(a, ptr,
+				    _uk_alloc_stats_objsize(a, ptr, size));
+	_uk_alloc_prof_count_alloc(ptr, size);
+	return ptr;
 }
 
 static inline void *uk_malloc(struct uk_alloc *a, size_t size)
@@ -129,8 +245,15 @@ static inline void *uk_malloc(struct uk_alloc *a, size_t size)
 static inline void *uk_do_calloc(struct uk_alloc *a,
 				 size_t nmemb, size_t size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->calloc(a, nmemb, size);
+	ptr = a->calloc(a, nmemb, size);
+	_uk_alloc_stats_count_alloc(a, ptr,
+				    _uk_alloc_stats_objsize(a, ptr,
+							    nmemb * size));
+	_uk_alloc_prof_count_alloc(ptr, nmemb * size);
+	return ptr;
 }
 
 static inline void *uk_calloc(struct uk_alloc *a,
@@ -146,8 +269,29 @@ static inline void *uk_calloc(struct uk_alloc *a,
 static inline void *uk_do_realloc(struct uk_alloc *a,
 				  void *ptr, size_t size)
 {
+#if CONFIG_LIBUKALLOC_IFSTATS
+	size_t old_size;
+#endif
+	void *retptr;
+
 	UK_ASSERT(a);
-	return a->realloc(a, ptr, size);
+#if CONFIG_LIBUKALLOC_IFSTATS
+	old_size = uk_alloc_size(a, ptr);
+#endif
+	retptr = a->realloc(a, ptr, size);
+
+	/* a reallocation is accounted as free and allocation */
+	if (ptr && (retptr || !size)) {
+		_uk_alloc_stats_count_free(a, ptr, old_size);
+		_uk_alloc_prof_count_free(ptr);
+	}
+	if (size) {
+		_uk_alloc_stats_count_alloc(a, retptr,
+					    _uk_alloc_stats_objsize(a, retptr,
+								    size));
+		_uk_alloc_prof_count_alloc(retptr, size);
+	}
+	return retptr;
 }
 
 static inline void *uk_realloc(struct uk_alloc *a, void *ptr, size_t size)
@@ -162,8 +306,19 @@ static inline void *uk_realloc(struct uk_alloc *a, void *ptr, size_t size)
 static inline int uk_do_posix_memalign(struct uk_alloc *a, void **memptr,
 				       size_t align, size_t size)
 {
+	int ret;
+
 	UK_ASSERT(a);
-	return a->posix_memalign(a, memptr, align, size);
+	ret = a->posix_memalign(a, memptr, align, size);
+	if (ret == 0) {
+		_uk_alloc_stats_count_alloc(a, *memptr,
+					    _uk_alloc_stats_objsize(a, *memptr,
+								    size));
+		_uk_alloc_prof_count_alloc(*memptr, size);
+	} else if (ret == ENOMEM) {
+		_uk_alloc_stats_count_enomem(a, size);
+	}
+	return ret;
 }
 
 static inline int uk_posix_memalign(struct uk_alloc *a, void **memptr,
@@ -179,8 +334,14 @@ static inline int uk_posix_memalign(struct uk_alloc *a, void **memptr,
 static inline void *uk_do_memalign(struct uk_alloc *a,
 				   size_t align, size_t size)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->memalign(a, align, size);
+	ptr = a->memalign(a, align, size);
+	_uk_alloc_stats_count_alloc(a, ptr,
+				    _uk_alloc_stats_objsize(a, ptr, size));
+	_uk_alloc_prof_count_alloc(ptr, size);
+	return ptr;
 }
 
 static inline void *uk_memalign(struct uk_alloc *a,
@@ -194,6 +355,8 @@ static inline void *uk_memalign(struct uk_alloc *a,
 static inline void uk_do_free(struct uk_alloc *a, void *ptr)
 {
 	UK_ASSERT(a);
+	_uk_alloc_stats_count_free(a, ptr, uk_alloc_size(a, ptr));
+	_uk_alloc_prof_count_free(ptr);
 	a->free(a, ptr);
 }
 
@@ -204,8 +367,12 @@ static inline void uk_free(struct uk_alloc *a, void *ptr)
 
 static inline void *uk_do_palloc(struct uk_alloc *a, unsigned long num_pages)
 {
+	void *ptr;
+
 	UK_ASSERT(a);
-	return a->palloc(a, num_pages);
+	ptr = a->palloc(a, num_pages);
+	_uk_alloc_stats_count_alloc(a, ptr, num_pages << __PAGE_SHIFT);
+	return ptr;
 }
 
 static inline void *uk_palloc(struct uk_alloc *a, unsigned long num_pages)
@@ -219,6 +386,7 @@ static inline void uk_do_pfree(struct uk_alloc *a, void *ptr,
 			       unsigned long num_pages)
 {
 	UK_ASSERT(a);
+	_uk_alloc_stats_count_free(a, ptr, num_pages << __PAGE_SHIFT);
 	a->pfree(a, ptr, num_pages);
 }
 
@@ -228,6 +396,66 @@ static inline void uk_pfree(struct uk_alloc *a, void *ptr,
 	uk_do_pfree(a, ptr, num_pages);
 }
 
+/**
+ * Allocates zeroed pages. Only available if the allocator implements
+ * pzalloc (see uk_alloc_has_pzalloc()).
+ *
+ * @param a
+ *   Allocator instance
+ * @param num_pages
+ *   Number of pages
+ * @return
+ *   - (NULL): Out of memory
+ *   - Pointer to the first page
+ */
+static inline void *uk_pzalloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	void *ptr;
+
+	UK_ASSERT(a);
+	UK_ASSERT(a->pzalloc);
+	ptr = a->pzalloc(a, num_pages);
+	_uk_alloc_stats_count_alloc(a, ptr, num_pages << __PAGE_SHIFT);
+	return ptr;
+}
+
+#define uk_alloc_has_pzalloc(a) ((a)->pzalloc != NULL)
+
+/**
+ * Resizes a page allocation in place.
+ *
+ * @param a
+ *   Allocator that was used for allocating the pages
+ * @param ptr
+ *   Pointer to the first page
+ * @param num_pages
+ *   Number of pages that were requested with uk_palloc()
+ * @param new_num_pages
+ *   New number of pages
+ * @return
+ *   - (0): Allocation resized, it has to be freed with new_num_pages
+ *   - (-ENOMEM): Allocation cannot be resized in place
+ *   - (-ENOTSUP): Allocator does not support resizing in place
+ */
+static inline int uk_presize(struct uk_alloc *a, void *ptr,
+			     unsigned long num_pages,
+			     unsigned long new_num_pages)
+{
+	int ret;
+
+	UK_ASSERT(a);
+	if (!a->presize)
+		return -ENOTSUP;
+
+	ret = a->presize(a, ptr, num_pages, new_num_pages);
+	if (ret == 0) {
+		_uk_alloc_stats_count_free(a, ptr, num_pages << __PAGE_SHIFT);
+		_uk_alloc_stats_count_alloc(a, ptr,
+					    new_num_pages << __PAGE_SHIFT);
+	}
+	return ret;
+}
+
 static inline int uk_alloc_addmem(struct uk_alloc *a, void *base,
 				  size_t size)
 {
@@ -245,8 +473,83 @@ static inline ssize_t uk_alloc_availmem(struct uk_alloc *a)
 		return (ssize_t) -ENOTSUP;
 	return a->availmem(a);
 }
+
+/**
+ * Retrieves a snapshot of the statistics of an allocator.
+ *
+ * @param a
+ *   Allocator instance
+ * @param dst
+ *   Destination for the statistics
+ */
+void uk_alloc_stats_get(struct uk_alloc *a, struct uk_alloc_stats *dst);
+
+/**
+ * Resets the statistics of an allocator. Current values (live allocations
+ * and memory in use) are kept, peak values are set to current values.
+ *
+ * @param a
+ *   Allocator instance
+ */
+void uk_alloc_stats_reset(struct uk_alloc *a);
+
+/**
+ * Prints the statistics of an allocator with the kernel console, including
+ * allocator-specific details (e.g., free chunk counts).
+ *
+ * @param a
+ *   Allocator instance
+ */
+void uk_alloc_stats_dump(struct uk_alloc *a);
+
+/**
+ * Prints the statistics of all registered allocators.
+ */
+void uk_alloc_stats_dump_all(void);
 #endif /* CONFIG_LIBUKALLOC_IFSTATS */
 
+#if CONFIG_LIBUKALLOC_PROFILE
+/* Output function for profile dumps */
+typedef void (*uk_alloc_prof_out_func_t)(void *arg, const char *buf,
+					 size_t len);
+
+/**
+ * (Re)starts the heap profiler. Previously collected samples are kept.
+ *
+ * @param rate
+ *   Average number of allocated bytes between two samples,
+ *   0 selects the configured default rate
+ */
+void uk_alloc_prof_start(size_t rate);
+
+/**
+ * Stops taking new samples. Sampled allocations that are freed
+ * are still accounted.
+ */
+void uk_alloc_prof_stop(void);
+
+/**
+ * Writes the collected samples in the legacy pprof heap profile
+ * format (heap_v2). The profile can be inspected with pprof together
+ * with the debug image of the unikernel, e.g., as a flame graph with
+ * `pprof -http=: <unikernel.dbg> <profile>`.
+ *
+ * @param out
+ *   Output function, NULL prints to the kernel console
+ * @param arg
+ *   Argument that is handed over to the output function
+ */
+void uk_alloc_prof_dump(uk_alloc_prof_out_func_t out, void *arg);
+#endif /* CONFIG_LIBUKALLOC_PROFILE */
+
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP || CONFIG_LIBUKALLOC_PROFILE_DUMP
+/**
+ * Prints the allocator statistics and the heap profile, as configured.
+ * Called by the platforms when the system shuts down.
+ */
+void uk_alloc_shutdown_dump(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
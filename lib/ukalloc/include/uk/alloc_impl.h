@@ -47,6 +47,31 @@ extern "C" {
 
 int uk_alloc_register(struct uk_alloc *a);
 
+/**
+ * Removes an allocator from the list of registered allocators.
+ * If it was the default allocator, the next registered allocator
+ * becomes the default.
+ *
+ * @param a
+ *  Registered allocator.
+ * @return
+ *  - (0): Success.
+ *  - (-ENOENT): Allocator is not registered.
+ */
+int uk_alloc_unregister(struct uk_alloc *a);
+
+/**
+ * Makes an already registered allocator the default allocator
+ * (returned by uk_alloc_get_default()).
+ *
+ * @param a
+ *  Registered allocator.
+ * @return
+ *  - (0): Success.
+ *  - (-ENOENT): Allocator is not registered.
+ */
+int uk_alloc_set_default(struct uk_alloc *a);
+
 /**
  * Compatibility functions that can be used by allocator implementations to
  * fill out callback functions in `struct uk_alloc` when just a subset of the
@@ -55,10 +80,12 @@ int uk_alloc_register(struct uk_alloc *a);
 
 /* Functions that can be used by allocators that implement palloc(), pfree() only */
 void *uk_malloc_ifpages(struct uk_alloc *a, size_t size);
+void *uk_calloc_ifpages(struct uk_alloc *a, size_t num, size_t len);
 void *uk_realloc_ifpages(struct uk_alloc *a, void *ptr, size_t size);
 int uk_posix_memalign_ifpages(struct uk_alloc *a, void **memptr,
 				size_t align, size_t size);
 void uk_free_ifpages(struct uk_alloc *a, void *ptr);
+size_t uk_getsize_ifpages(struct uk_alloc *a, const void *ptr);
 
 #if CONFIG_LIBUKALLOC_IFMALLOC
 void *uk_malloc_ifmalloc(struct uk_alloc *a, size_t size);
@@ -66,6 +93,7 @@ void *uk_realloc_ifmalloc(struct uk_alloc *a, void *ptr, size_t size);
 int uk_posix_memalign_ifmalloc(struct uk_alloc *a, void **memptr,
 				     size_t align, size_t size);
 void uk_free_ifmalloc(struct uk_alloc *a, void *ptr);
+size_t uk_getsize_ifmalloc(struct uk_alloc *a, const void *ptr);
 #endif
 
 /* Functionality that is provided based on malloc() and posix_memalign() */
@@ -75,6 +103,18 @@ void *uk_memalign_compat(struct uk_alloc *a, size_t align, size_t len);
 void *uk_palloc_compat(struct uk_alloc *a, unsigned long num_pages);
 void uk_pfree_compat(struct uk_alloc *a, void *ptr, unsigned long num_pages);
 
+/* Clears the optional statistics interface of an allocator */
+#if CONFIG_LIBUKALLOC_IFSTATS
+#define _uk_alloc_init_ifstats(a)					\
+	do {								\
+		(a)->availmem       = NULL;				\
+		(a)->dumpstats      = NULL;				\
+	} while (0)
+#else
+#define _uk_alloc_init_ifstats(a)					\
+	do {} while (0)
+#endif
+
 /* Shortcut for doing a registration of an allocator that does not implement
  * palloc() or pfree()
  */
@@ -89,7 +129,11 @@ void uk_pfree_compat(struct uk_alloc *a, void *ptr, unsigned long num_pages);
 		(a)->free           = (free_f);				\
 		(a)->palloc         = uk_palloc_compat;			\
 		(a)->pfree          = uk_pfree_compat;			\
+		(a)->pzalloc        = NULL;				\
+		(a)->presize        = NULL;				\
 		(a)->addmem         = (addmem_f);			\
+		(a)->getsize        = NULL;				\
+		_uk_alloc_init_ifstats((a));				\
 									\
 		uk_alloc_register((a));					\
 	} while (0)
@@ -107,7 +151,11 @@ void uk_pfree_compat(struct uk_alloc *a, void *ptr, unsigned long num_pages);
 		(a)->free           = uk_free_ifmalloc;			\
 		(a)->palloc         = uk_palloc_compat;			\
 		(a)->pfree          = uk_pfree_compat;			\
+		(a)->pzalloc        = NULL;				\
+		(a)->presize        = NULL;				\
 		(a)->addmem         = (addmem_f);			\
+		(a)->getsize        = uk_getsize_ifmalloc;		\
+		_uk_alloc_init_ifstats((a));				\
 									\
 		uk_alloc_register((a));					\
 	} while (0)
@@ -119,14 +167,18 @@ void uk_pfree_compat(struct uk_alloc *a, void *ptr, unsigned long num_pages);
 #define uk_alloc_init_palloc(a, palloc_func, pfree_func, addmem_func)	\
 	do {								\
 		(a)->malloc         = uk_malloc_ifpages;		\
-		(a)->calloc         = uk_calloc_compat;			\
+		(a)->calloc         = uk_calloc_ifpages;		\
 		(a)->realloc        = uk_realloc_ifpages;		\
 		(a)->posix_memalign = uk_posix_memalign_ifpages;	\
 		(a)->memalign       = uk_memalign_compat;		\
 		(a)->free           = uk_free_ifpages;			\
 		(a)->palloc         = (palloc_func);			\
 		(a)->pfree          = (pfree_func);			\
+		(a)->pzalloc        = NULL;				\
+		(a)->presize        = NULL;				\
 		(a)->addmem         = (addmem_func);			\
+		(a)->getsize        = uk_getsize_ifpages;		\
+		_uk_alloc_init_ifstats((a));				\
 									\
 		uk_alloc_register((a));					\
 	} while (0)
@@ -0,0 +1,321 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Sampling heap profiler
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Every allocation that crosses the sampling threshold is recorded together
+ * with its call stack. The distance between two samples follows an
+ * exponential distribution with a mean of `rate` bytes so that pprof can
+ * estimate the real heap usage from the samples (heap_v2 format).
+ *
+ * Call stacks are taken by walking the frame records of the current stack
+ * (the same scheme as stack_walk() in plat/common/x86/trace.c). This
+ * requires frame pointers, which Unikraft enables by default.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <uk/alloc_impl.h>
+#include <uk/plat/console.h>
+#include <uk/print.h>
+
+#define PROF_DEPTH	CONFIG_LIBUKALLOC_PROFILE_DEPTH
+#define PROF_NR_STACKS	(1UL << CONFIG_LIBUKALLOC_PROFILE_STACKS_ORDER)
+#define PROF_NR_LIVE	(1UL << CONFIG_LIBUKALLOC_PROFILE_LIVE_ORDER)
+
+/* frames larger than this terminate the stack walk */
+#define PROF_MAX_FRAME	(1UL << 20)
+
+struct prof_stack {
+	unsigned long alloc_objs;
+	unsigned long alloc_bytes;
+	unsigned long inuse_objs;
+	unsigned long inuse_bytes;
+	unsigned int depth;
+	uintptr_t pc[PROF_DEPTH];
+};
+
+struct prof_live {
+	void *ptr;
+	size_t size;
+	struct prof_stack *stack;
+};
+
+long _uk_alloc_prof_left = CONFIG_LIBUKALLOC_PROFILE_RATE;
+unsigned long _uk_alloc_prof_nr_live;
+
+static size_t prof_rate = CONFIG_LIBUKALLOC_PROFILE_RATE;
+static int prof_stopped;
+static __u64 prof_rand = 0x2545f4914f6cdd1dULL;
+static unsigned long prof_dropped;
+
+static struct prof_stack prof_stacks[PROF_NR_STACKS];
+static struct prof_live prof_live[PROF_NR_LIVE];
+
+/* Draws the distance to the next sample from an exponential distribution:
+ * -ln(U) * rate with U uniformly distributed in (0, 1]. The logarithm is
+ * approximated in fixed point (16 fractional bits) to avoid floating point
+ * operations.
+ */
+static long prof_next_interval(void)
+{
+	__u64 q, log2q, neglog2u, interval;
+	unsigned int l;
+
+	/* xorshift64 */
+	prof_rand ^= prof_rand << 13;
+	prof_rand ^= prof_rand >> 7;
+	prof_rand ^= prof_rand << 17;
+
+	/* U = q / 2^26 */
+	q = (prof_rand >> 38) + 1;
+	l = 63 - __builtin_clzll(q);
+	log2q = ((__u64) l << 16) | (((q << (63 - l)) >> 47) & 0xffff);
+	neglog2u = (26ULL << 16) - log2q;
+
+	/* ln(2) = 45426 / 2^16 */
+	interval = (((__u64) prof_rate * neglog2u) >> 16) * 45426 >> 16;
+	return (long) MIN(MAX(interval, 1ULL), (__u64) LONG_MAX);
+}
+
+/* Each frame record consists of the frame pointer of the caller followed by
+ * the return address
+ */
+#if !defined(__X86_64__) && !defined(__ARM_64__)
+#error "The heap profiler does not know the frame layout of this architecture"
+#endif
+static unsigned int prof_backtrace(unsigned long *fp, uintptr_t *pc,
+				   unsigned int max)
+{
+	unsigned long *next;
+	unsigned int n = 0;
+
+	while (fp && n < max) {
+		if (!fp[1])
+			break;
+		pc[n++] = fp[1];
+
+		next = (unsigned long *) fp[0];
+		if (next <= fp
+		    || (uintptr_t) next - (uintptr_t) fp > PROF_MAX_FRAME
+		    || ((uintptr_t) next & (sizeof(*next) - 1)))
+			break;
+		fp = next;
+	}
+	return n;
+}
+
+static inline unsigned long prof_hash_ptr(const void *ptr)
+{
+	return ((uintptr_t) ptr >> 4) * 0x9e3779b97f4a7c15ULL;
+}
+
+static struct prof_stack *prof_stack_get(const uintptr_t *pc,
+					 unsigned int depth)
+{
+	struct prof_stack *stack;
+	unsigned long h = 0, i, n;
+
+	for (i = 0; i < depth; ++i)
+		h = (h ^ pc[i]) * 0x100000001b3ULL;
+
+	for (n = 0; n < PROF_NR_STACKS; ++n) {
+		i = (h + n) & (PROF_NR_STACKS - 1);
+		stack = &prof_stacks[i];
+		if (!stack->depth) {
+			stack->depth = depth;
+			memcpy(stack->pc, pc, depth * sizeof(*pc));
+			return stack;
+		}
+		if (stack->depth == depth
+		    && !memcmp(stack->pc, pc, depth * sizeof(*pc)))
+			return stack;
+	}
+	return NULL;
+}
+
+static struct prof_live *prof_live_find(const void *ptr)
+{
+	unsigned long i, n;
+
+	for (n = 0; n < PROF_NR_LIVE; ++n) {
+		i = (prof_hash_ptr(ptr) + n) & (PROF_NR_LIVE - 1);
+		if (!prof_live[i].ptr)
+			return NULL;
+		if (prof_live[i].ptr == ptr)
+			return &prof_live[i];
+	}
+	return NULL;
+}
+
+static void prof_live_remove(struct prof_live *e)
+{
+	unsigned long i, j, home;
+
+	/* backward shift deletion keeps probe sequences intact */
+	i = e - prof_live;
+	j = i;
+	for (;;) {
+		j = (j + 1) & (PROF_NR_LIVE - 1);
+		if (!prof_live[j].ptr)
+			break;
+		home = prof_hash_ptr(prof_live[j].ptr) & (PROF_NR_LIVE - 1);
+		if (((j - home) & (PROF_NR_LIVE - 1))
+		    >= ((j - i) & (PROF_NR_LIVE - 1))) {
+			prof_live[i] = prof_live[j];
+			i = j;
+		}
+	}
+	prof_live[i].ptr = NULL;
+}
+
+void _uk_alloc_prof_sample(void *ptr, size_t size)
+{
+	uintptr_t pc[PROF_DEPTH];
+	struct prof_stack *stack;
+	unsigned long i, n;
+	unsigned int depth;
+
+	_uk_alloc_prof_left = prof_next_interval();
+
+	/* keep at most half of the table occupied */
+	if (_uk_alloc_prof_nr_live >= PROF_NR_LIVE / 2)
+		goto drop;
+
+	depth = prof_backtrace(__builtin_frame_address(0), pc, PROF_DEPTH);
+	if (!depth)
+		pc[depth++] = 0;
+	stack = prof_stack_get(pc, depth);
+	if (!stack)
+		goto drop;
+
+	stack->alloc_objs++;
+	stack->alloc_bytes += size;
+	stack->inuse_objs++;
+	stack->inuse_bytes += size;
+
+	for (n = 0; n < PROF_NR_LIVE; ++n) {
+		i = (prof_hash_ptr(ptr) + n) & (PROF_NR_LIVE - 1);
+		if (!prof_live[i].ptr)
+			break;
+	}
+	UK_ASSERT(n < PROF_NR_LIVE);
+	prof_live[i].ptr   = ptr;
+	prof_live[i].size  = size;
+	prof_live[i].stack = stack;
+	_uk_alloc_prof_nr_live++;
+	return;
+
+drop:
+	prof_dropped++;
+}
+
+void _uk_alloc_prof_release(void *ptr)
+{
+	struct prof_live *e;
+
+	e = prof_live_find(ptr);
+	if (!e)
+		return;
+
+	e->stack->inuse_objs--;
+	e->stack->inuse_bytes -= e->size;
+	prof_live_remove(e);
+	_uk_alloc_prof_nr_live--;
+}
+
+void uk_alloc_prof_start(size_t rate)
+{
+	prof_rate = rate ? rate : CONFIG_LIBUKALLOC_PROFILE_RATE;
+	prof_stopped = 0;
+	_uk_alloc_prof_left = prof_next_interval();
+}
+
+void uk_alloc_prof_stop(void)
+{
+	prof_stopped = 1;
+	_uk_alloc_prof_left = LONG_MAX;
+}
+
+static void prof_out_console(void *arg __unused, const char *buf, size_t len)
+{
+	ukplat_coutk(buf, (unsigned int) len);
+}
+
+void uk_alloc_prof_dump(uk_alloc_prof_out_func_t out, void *arg)
+{
+	unsigned long inuse_objs = 0, inuse_bytes = 0;
+	unsigned long alloc_objs = 0, alloc_bytes = 0;
+	struct prof_stack *stack;
+	char line[128 + PROF_DEPTH * 19];
+	unsigned long i;
+	unsigned int j;
+	int len;
+
+	if (!out)
+		out = prof_out_console;
+
+	for (i = 0; i < PROF_NR_STACKS; ++i) {
+		stack = &prof_stacks[i];
+		inuse_objs  += stack->inuse_objs;
+		inuse_bytes += stack->inuse_bytes;
+		alloc_objs  += stack->alloc_objs;
+		alloc_bytes += stack->alloc_bytes;
+	}
+
+	len = snprintf(line, sizeof(line),
+		       "heap profile: %lu: %lu [%lu: %lu] @ heap_v2/%"__PRIsz"\n",
+		       inuse_objs, inuse_bytes, alloc_objs, alloc_bytes,
+		       prof_rate);
+	out(arg, line, (size_t) len);
+
+	for (i = 0; i < PROF_NR_STACKS; ++i) {
+		stack = &prof_stacks[i];
+		if (!stack->depth)
+			continue;
+
+		len = snprintf(line, sizeof(line), "%lu: %lu [%lu: %lu] @",
+			       stack->inuse_objs, stack->inuse_bytes,
+			       stack->alloc_objs, stack->alloc_bytes);
+		for (j = 0; j < stack->depth; ++j)
+			len += snprintf(line + len, sizeof(line) - len,
+					" 0x%"__PRIuptr, stack->pc[j]);
+		len += snprintf(line + len, sizeof(line) - len, "\n");
+		out(arg, line, (size_t) len);
+	}
+
+	if (prof_dropped)
+		uk_pr_warn("Heap profile: %lu samples dropped, consider increasing the table sizes\n",
+			   prof_dropped);
+	if (prof_stopped)
+		uk_pr_info("Heap profile: sampling is stopped\n");
+}
@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Allocator statistics
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <uk/alloc_impl.h>
+#include <uk/print.h>
+
+void _uk_alloc_stats_count_alloc(struct uk_alloc *a, void *ptr, size_t size)
+{
+	struct uk_alloc_stats *stats = &a->_stats;
+
+	if (unlikely(!ptr)) {
+		if (size)
+			stats->nb_enomem++;
+		return;
+	}
+
+	stats->last_alloc_size = size;
+	if (size > stats->max_alloc_size)
+		stats->max_alloc_size = size;
+	if (size < stats->min_alloc_size || !stats->tot_nb_allocs)
+		stats->min_alloc_size = size;
+
+	stats->tot_nb_allocs++;
+	stats->cur_nb_allocs++;
+	if (stats->cur_nb_allocs > stats->max_nb_allocs)
+		stats->max_nb_allocs = stats->cur_nb_allocs;
+
+	/* Without getsize, the size of freed objects is unknown */
+	if (!a->getsize)
+		return;
+	stats->cur_mem_use += size;
+	if (stats->cur_mem_use > stats->max_mem_use)
+		stats->max_mem_use = stats->cur_mem_use;
+}
+
+void _uk_alloc_stats_count_free(struct uk_alloc *a, void *ptr, size_t size)
+{
+	struct uk_alloc_stats *stats = &a->_stats;
+
+	if (!ptr)
+		return;
+
+	stats->tot_nb_frees++;
+	stats->cur_nb_allocs--;
+	if (a->getsize)
+		stats->cur_mem_use -= size;
+}
+
+void _uk_alloc_stats_count_enomem(struct uk_alloc *a, size_t size __unused)
+{
+	a->_stats.nb_enomem++;
+}
+
+void uk_alloc_stats_get(struct uk_alloc *a, struct uk_alloc_stats *dst)
+{
+	UK_ASSERT(a);
+	UK_ASSERT(dst);
+
+	memcpy(dst, &a->_stats, sizeof(*dst));
+}
+
+void uk_alloc_stats_reset(struct uk_alloc *a)
+{
+	struct uk_alloc_stats *stats;
+
+	UK_ASSERT(a);
+	stats = &a->_stats;
+
+	stats->last_alloc_size = 0;
+	stats->max_alloc_size  = 0;
+	stats->min_alloc_size  = 0;
+	stats->tot_nb_allocs   = 0;
+	stats->tot_nb_frees    = 0;
+	stats->max_nb_allocs   = stats->cur_nb_allocs;
+	stats->max_mem_use     = stats->cur_mem_use;
+	stats->nb_enomem       = 0;
+}
+
+void uk_alloc_stats_dump(struct uk_alloc *a)
+{
+	struct uk_alloc_stats *stats;
+
+	UK_ASSERT(a);
+	stats = &a->_stats;
+
+	printf("Allocator %p%s:\n", a,
+	       (a == uk_alloc_get_default()) ? " (default)" : "");
+	printf(" allocs: %lu, frees: %lu, failed: %lu\n",
+	       stats->tot_nb_allocs, stats->tot_nb_frees, stats->nb_enomem);
+	printf(" live allocs: %ld (peak %ld)\n",
+	       stats->cur_nb_allocs, stats->max_nb_allocs);
+	if (a->getsize)
+		printf(" memory in use: %"__PRIssz" B (peak %"__PRIssz" B)\n",
+		       stats->cur_mem_use, stats->max_mem_use);
+	else
+		printf(" memory in use: n/a\n");
+	printf(" alloc sizes: last %"__PRIsz" B, min %"__PRIsz" B, max %"__PRIsz" B\n",
+	       stats->last_alloc_size, stats->min_alloc_size,
+	       stats->max_alloc_size);
+	if (a->availmem)
+		printf(" available memory: %"__PRIssz" B\n",
+		       a->availmem(a));
+	if (a->dumpstats)
+		a->dumpstats(a);
+}
+
+void uk_alloc_stats_dump_all(void)
+{
+	struct uk_alloc *a;
+
+	uk_alloc_foreach(a)
+		uk_alloc_stats_dump(a);
+}
@@ -36,6 +36,7 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
+#include <stdio.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -56,6 +57,7 @@ struct chunk_head_st {
 	chunk_head_t *next;
 	chunk_head_t **pprev;
 	unsigned int level;
+	int zeroed;
 };
 
 struct chunk_tail_st {
@@ -63,7 +65,7 @@ struct chunk_tail_st {
 };
 
 /* Linked lists of free chunks of different powers-of-two in size. */
-#define FREELIST_SIZE ((sizeof(void *) << 3) - __PAGE_SHIFT)
+#define FREELIST_SIZE UK_ALLOCBBUDDY_NR_ORDERS
 #define FREELIST_EMPTY(_l) ((_l)->next == NULL)
 
 /* keep a bitmap for each memory region separately */
@@ -75,11 +77,55 @@ struct uk_bbpalloc_memr {
 	unsigned long *mm_alloc_bitmap;
 };
 
+/*
+ * MEMORY REGION DIRECTORY
+ *  Maps an address to its memory region in constant time. The address space
+ *  is divided into sections of 2^MEMR_SECT_SHIFT bytes. A three-level table
+ *  (top, mid, leaf) stores for each section the (up to two) memory regions
+ *  that overlap with it. Mid and leaf tables are one page each and are
+ *  carved out of the memory regions that are added.
+ */
+#define MEMR_SECT_SHIFT		21
+#define MEMR_SECT_SIZE		(1UL << MEMR_SECT_SHIFT)
+#define MEMR_LEAF_BITS		(__PAGE_SHIFT - 4)
+#define MEMR_MID_BITS		(__PAGE_SHIFT - 3)
+#define MEMR_MID_SHIFT		(MEMR_SECT_SHIFT + MEMR_LEAF_BITS)
+#define MEMR_TOP_SHIFT		(MEMR_MID_SHIFT + MEMR_MID_BITS)
+#define MEMR_VA_BITS		((sizeof(void *) == 8) ? 48 : 32)
+#define MEMR_TOP_ENTRIES	((MEMR_VA_BITS > MEMR_TOP_SHIFT)	\
+				 ? (1UL << (MEMR_VA_BITS - MEMR_TOP_SHIFT)) \
+				 : 1UL)
+
+#define memr_top_idx(va) \
+	((unsigned long) ((uint64_t) (va) >> MEMR_TOP_SHIFT))
+#define memr_mid_idx(va) \
+	(((va) >> MEMR_MID_SHIFT) & ((1UL << MEMR_MID_BITS) - 1))
+#define memr_leaf_idx(va) \
+	(((va) >> MEMR_SECT_SHIFT) & ((1UL << MEMR_LEAF_BITS) - 1))
+
+struct memr_sect {
+	struct uk_bbpalloc_memr *memr[2];
+};
+
+struct memr_leaf {
+	struct memr_sect sect[1UL << MEMR_LEAF_BITS];
+};
+
+struct memr_mid {
+	struct memr_leaf *leaf[1UL << MEMR_MID_BITS];
+};
+
+UK_CTASSERT(sizeof(struct memr_leaf) <= __PAGE_SIZE);
+UK_CTASSERT(sizeof(struct memr_mid) <= __PAGE_SIZE);
+
 struct uk_bbpalloc {
 	unsigned long nr_free_pages;
 	chunk_head_t *free_head[FREELIST_SIZE];
 	chunk_head_t free_tail[FREELIST_SIZE];
+	/* number of free chunks per order */
+	unsigned long nr_free_chunks[FREELIST_SIZE];
 	struct uk_bbpalloc_memr *memr_head;
+	struct memr_mid *memr_dir[MEMR_TOP_ENTRIES];
 };
 
 /*********************
@@ -97,22 +143,48 @@ struct uk_bbpalloc {
 #define BYTES_PER_MAPWORD   (sizeof(unsigned long))
 #define PAGES_PER_MAPWORD   (BYTES_PER_MAPWORD * BITS_PER_BYTE)
 
+static inline int memr_contains(struct uk_bbpalloc_memr *memr,
+				unsigned long page_va)
+{
+	return memr
+		&& (page_va >= memr->first_page)
+		&& (page_va < (memr->first_page +
+			       (memr->nr_pages << __PAGE_SHIFT)));
+}
+
+static inline struct memr_sect *memr_dir_get_sect(struct uk_bbpalloc *b,
+						  unsigned long va)
+{
+	struct memr_mid *mid;
+	struct memr_leaf *leaf;
+
+	if (unlikely(memr_top_idx(va) >= MEMR_TOP_ENTRIES))
+		return NULL;
+	mid = b->memr_dir[memr_top_idx(va)];
+	if (!mid)
+		return NULL;
+	leaf = mid->leaf[memr_mid_idx(va)];
+	if (!leaf)
+		return NULL;
+	return &leaf->sect[memr_leaf_idx(va)];
+}
+
 static inline struct uk_bbpalloc_memr *map_get_memr(struct uk_bbpalloc *b,
 						    unsigned long page_va)
 {
-	struct uk_bbpalloc_memr *memr = NULL;
+	struct memr_sect *sect;
 
 	/*
-	 * Find bitmap of according memory region
-	 * This is a linear search but it is expected that we have only a few
-	 * of them. It should be just one region in most cases
+	 * Find bitmap of according memory region with the help of the
+	 * region directory. A section is shared by two regions at most.
 	 */
-	for (memr = b->memr_head; memr != NULL; memr = memr->next) {
-		if ((page_va >= memr->first_page)
-		    && (page_va < (memr->first_page +
-		    (memr->nr_pages << __PAGE_SHIFT))))
-			return memr;
-	}
+	sect = memr_dir_get_sect(b, page_va);
+	if (!sect)
+		return NULL;
+	if (memr_contains(sect->memr[0], page_va))
+		return sect->memr[0];
+	if (memr_contains(sect->memr[1], page_va))
+		return sect->memr[1];
 
 	/*
 	 * No region found
@@ -120,6 +192,79 @@ static inline struct uk_bbpalloc_memr *map_get_memr(struct uk_bbpalloc *b,
 	return NULL;
 }
 
+/* Returns whether a section cannot take another memory region */
+static inline int memr_dir_sect_full(struct uk_bbpalloc *b, unsigned long va)
+{
+	struct memr_sect *sect = memr_dir_get_sect(b, va);
+
+	return sect && sect->memr[1];
+}
+
+/* Number of directory tables that need to be allocated to cover the
+ * address range [min, max)
+ */
+static unsigned long memr_dir_missing(struct uk_bbpalloc *b,
+				      unsigned long min, unsigned long max)
+{
+	unsigned long va, count = 0;
+	unsigned long last_top = ~0UL;
+	struct memr_mid *mid;
+
+	for (va = ALIGN_DOWN(min, 1UL << MEMR_MID_SHIFT); va < max;
+	     va += 1UL << MEMR_MID_SHIFT) {
+		mid = b->memr_dir[memr_top_idx(va)];
+		if (!mid) {
+			/* count a missing mid table only once */
+			if (memr_top_idx(va) != last_top)
+				count++;
+			last_top = memr_top_idx(va);
+			count++;
+		} else if (!mid->leaf[memr_mid_idx(va)]) {
+			count++;
+		}
+	}
+	return count;
+}
+
+/* Registers a memory region with the directory. Missing tables are taken
+ * from the page range starting at *tables.
+ */
+static void memr_dir_insert(struct uk_bbpalloc *b,
+			    struct uk_bbpalloc_memr *memr,
+			    uintptr_t *tables, uintptr_t tables_end)
+{
+	unsigned long va, end;
+	struct memr_mid **mid;
+	struct memr_leaf **leaf;
+	struct memr_sect *sect;
+
+	end = memr->first_page + (memr->nr_pages << __PAGE_SHIFT);
+	for (va = memr->first_page; va < end;
+	     va = ALIGN_DOWN(va, MEMR_SECT_SIZE) + MEMR_SECT_SIZE) {
+		mid = &b->memr_dir[memr_top_idx(va)];
+		if (!*mid) {
+			UK_ASSERT(*tables + __PAGE_SIZE <= tables_end);
+			*mid = (struct memr_mid *) *tables;
+			memset(*mid, 0, __PAGE_SIZE);
+			*tables += __PAGE_SIZE;
+		}
+		leaf = &(*mid)->leaf[memr_mid_idx(va)];
+		if (!*leaf) {
+			UK_ASSERT(*tables + __PAGE_SIZE <= tables_end);
+			*leaf = (struct memr_leaf *) *tables;
+			memset(*leaf, 0, __PAGE_SIZE);
+			*tables += __PAGE_SIZE;
+		}
+		sect = &(*leaf)->sect[memr_leaf_idx(va)];
+		if (!sect->memr[0]) {
+			sect->memr[0] = memr;
+		} else {
+			UK_ASSERT(!sect->memr[1]);
+			sect->memr[1] = memr;
+		}
+	}
+}
+
 static inline unsigned long allocated_in_map(struct uk_bbpalloc *b,
 				   unsigned long page_va)
 {
@@ -223,6 +368,22 @@ static ssize_t bbuddy_availmem(struct uk_alloc *a)
 	b = (struct uk_bbpalloc *)&a->priv;
 	return (ssize_t) b->nr_free_pages << __PAGE_SHIFT;
 }
+
+static void bbuddy_dumpstats(struct uk_alloc *a)
+{
+	struct uk_bbpalloc *b;
+	size_t i;
+
+	UK_ASSERT(a != NULL);
+	b = (struct uk_bbpalloc *)&a->priv;
+
+	printf(" free chunks per order:\n");
+	for (i = 0; i < FREELIST_SIZE; i++) {
+		if (b->nr_free_chunks[i])
+			printf("  %2"__PRIsz": %lu\n",
+			       i, b->nr_free_chunks[i]);
+	}
+}
 #endif
 
 /* return log of the next power of two of passed number */
@@ -242,20 +403,97 @@ static inline unsigned long num_pages_to_order(unsigned long num_pages)
 	return ukarch_flsl(num_pages - 1) + 1;
 }
 
+/*********************
+ * FREE LISTS
+ *  Free chunks that are known to contain zeros only (apart from their own
+ *  head and tail) are linked in at the end of a free list, all others at
+ *  the front. Regular allocations take chunks from the front and so leave
+ *  zeroed chunks for bbuddy_pzalloc().
+ */
+#if CONFIG_LIBUKALLOCBBUDDY_ZEROMEM
+#define ADDMEM_ZEROED 1
+#else
+#define ADDMEM_ZEROED 0
+#endif
+
+static inline void chunk_link(struct uk_bbpalloc *b, chunk_head_t *ch,
+			      size_t order, int zeroed)
+{
+	chunk_tail_t *ct;
+
+	ct = (chunk_tail_t *)((char *)ch + (1UL << (order + __PAGE_SHIFT))) - 1;
+	ch->level = order;
+	ch->zeroed = zeroed;
+	ct->level = order;
+
+	if (zeroed) {
+		ch->next = &b->free_tail[order];
+		ch->pprev = b->free_tail[order].pprev;
+		*(ch->pprev) = ch;
+		b->free_tail[order].pprev = &ch->next;
+	} else {
+		ch->next = b->free_head[order];
+		ch->pprev = &b->free_head[order];
+		ch->next->pprev = &ch->next;
+		b->free_head[order] = ch;
+	}
+	b->nr_free_chunks[order]++;
+}
+
+static inline void chunk_unlink(struct uk_bbpalloc *b, chunk_head_t *ch,
+				size_t order)
+{
+	*(ch->pprev) = ch->next;
+	ch->next->pprev = ch->pprev;
+	b->nr_free_chunks[order]--;
+}
+
+/* Returns the last chunk of a free list, NULL if the list is empty */
+static inline chunk_head_t *chunk_last(struct uk_bbpalloc *b, size_t order)
+{
+	if (b->free_tail[order].pprev == &b->free_head[order])
+		return NULL;
+	return __containerof(b->free_tail[order].pprev, chunk_head_t, next);
+}
+
 /*********************
  * BINARY BUDDY PAGE ALLOCATOR
  */
-static void *bbuddy_palloc(struct uk_alloc *a, unsigned long num_pages)
+
+/* Takes a free chunk of order i and splits it down to the requested order.
+ * The spare chunks inherit the zeroed state of the original chunk.
+ */
+static void *bbuddy_take(struct uk_bbpalloc *b, chunk_head_t *alloc_ch,
+			 size_t i, size_t order)
+{
+	chunk_head_t *spare_ch;
+	int zeroed = alloc_ch->zeroed;
+
+	chunk_unlink(b, alloc_ch, i);
+
+	/* We may have to break the chunk a number of times. */
+	while (i != order) {
+		/* Split into two equal parts. */
+		i--;
+		spare_ch = (chunk_head_t *)((char *)alloc_ch
+					    + (1UL << (i + __PAGE_SHIFT)));
+		chunk_link(b, spare_ch, i, zeroed);
+	}
+	map_alloc(b, (uintptr_t)alloc_ch, 1UL << order);
+
+	return ((void *)alloc_ch);
+}
+
+static void *bbuddy_palloc_order(struct uk_alloc *a, size_t order)
 {
 	struct uk_bbpalloc *b;
 	size_t i;
-	chunk_head_t *alloc_ch, *spare_ch;
-	chunk_tail_t *spare_ct;
 
 	UK_ASSERT(a != NULL);
 	b = (struct uk_bbpalloc *)&a->priv;
 
-	size_t order = (size_t)num_pages_to_order(num_pages);
+	if (unlikely(order >= FREELIST_SIZE))
+		goto no_memory;
 
 	/* Find smallest order which can satisfy the request. */
 	for (i = order; i < FREELIST_SIZE; i++) {
@@ -265,33 +503,7 @@ static void *bbuddy_palloc(struct uk_alloc *a, unsigned long num_pages)
 	if (i == FREELIST_SIZE)
 		goto no_memory;
 
-	/* Unlink a chunk. */
-	alloc_ch = b->free_head[i];
-	b->free_head[i] = alloc_ch->next;
-	alloc_ch->next->pprev = alloc_ch->pprev;
-
-	/* We may have to break the chunk a number of times. */
-	while (i != order) {
-		/* Split into two equal parts. */
-		i--;
-		spare_ch = (chunk_head_t *)((char *)alloc_ch
-					    + (1UL << (i + __PAGE_SHIFT)));
-		spare_ct = (chunk_tail_t *)((char *)spare_ch
-					    + (1UL << (i + __PAGE_SHIFT))) - 1;
-
-		/* Create new header for spare chunk. */
-		spare_ch->level = i;
-		spare_ch->next = b->free_head[i];
-		spare_ch->pprev = &b->free_head[i];
-		spare_ct->level = i;
-
-		/* Link in the spare chunk. */
-		spare_ch->next->pprev = &spare_ch->next;
-		b->free_head[i] = spare_ch;
-	}
-	map_alloc(b, (uintptr_t)alloc_ch, 1UL << order);
-
-	return ((void *)alloc_ch);
+	return bbuddy_take(b, b->free_head[i], i, order);
 
 no_memory:
 	uk_pr_warn("%"__PRIuptr": Cannot handle palloc request of order %"__PRIsz": Out of memory\n",
@@ -300,17 +512,52 @@ no_memory:
 	return NULL;
 }
 
-static void bbuddy_pfree(struct uk_alloc *a, void *obj, unsigned long num_pages)
+static void *bbuddy_palloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	return bbuddy_palloc_order(a, (size_t)num_pages_to_order(num_pages));
+}
+
+static void *bbuddy_pzalloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	struct uk_bbpalloc *b;
+	chunk_head_t *ch;
+	void *ptr;
+	size_t order, i;
+
+	UK_ASSERT(a != NULL);
+	b = (struct uk_bbpalloc *)&a->priv;
+
+	order = (size_t)num_pages_to_order(num_pages);
+	for (i = order; i < FREELIST_SIZE; i++) {
+		ch = chunk_last(b, i);
+		if (ch && ch->zeroed) {
+			ptr = bbuddy_take(b, ch, i, order);
+
+			/* wipe chunk head and tail */
+			memset(ptr, 0, sizeof(chunk_head_t));
+			memset((char *)ptr + (1UL << (order + __PAGE_SHIFT))
+			       - sizeof(chunk_tail_t), 0, sizeof(chunk_tail_t));
+			return ptr;
+		}
+	}
+
+	/* no zeroed chunk available */
+	ptr = bbuddy_palloc_order(a, order);
+	if (ptr)
+		memset(ptr, 0, num_pages << __PAGE_SHIFT);
+	return ptr;
+}
+
+static void bbuddy_pfree_order(struct uk_alloc *a, void *obj, size_t order)
 {
 	struct uk_bbpalloc *b;
 	chunk_head_t *freed_ch, *to_merge_ch;
-	chunk_tail_t *freed_ct;
 	unsigned long mask;
 
 	UK_ASSERT(a != NULL);
 	b = (struct uk_bbpalloc *)&a->priv;
 
-	size_t order = (size_t)num_pages_to_order(num_pages);
+	UK_ASSERT(order < FREELIST_SIZE);
 
 	/* if the object is not page aligned it was clearly not from us */
 	UK_ASSERT((((uintptr_t)obj) & (__PAGE_SIZE - 1)) == 0);
@@ -320,8 +567,6 @@ static void bbuddy_pfree(struct uk_alloc *a, void *obj, unsigned long num_pages)
 
 	/* Create free chunk */
 	freed_ch = (chunk_head_t *)obj;
-	freed_ct = (chunk_tail_t *)((char *)obj
-				    + (1UL << (order + __PAGE_SHIFT))) - 1;
 
 	/* Now, possibly we can conseal chunks together */
 	while (order < FREELIST_SIZE) {
@@ -341,25 +586,101 @@ static void bbuddy_pfree(struct uk_alloc *a, void *obj, unsigned long num_pages)
 				break;
 
 			/* Merge with successor */
-			freed_ct =
-			    (chunk_tail_t *)((char *)to_merge_ch + mask) - 1;
 		}
 
 		/* We are commited to merging, unlink the chunk */
-		*(to_merge_ch->pprev) = to_merge_ch->next;
-		to_merge_ch->next->pprev = to_merge_ch->pprev;
+		chunk_unlink(b, to_merge_ch, order);
 
 		order++;
 	}
 
-	/* Link the new chunk */
-	freed_ch->level = order;
-	freed_ch->next = b->free_head[order];
-	freed_ch->pprev = &b->free_head[order];
-	freed_ct->level = order;
+	/* Link the new chunk, it contains data of the freed object */
+	chunk_link(b, freed_ch, order, 0);
+}
 
-	freed_ch->next->pprev = &freed_ch->next;
-	b->free_head[order] = freed_ch;
+static void bbuddy_pfree(struct uk_alloc *a, void *obj, unsigned long num_pages)
+{
+	bbuddy_pfree_order(a, obj, (size_t)num_pages_to_order(num_pages));
+}
+
+static int bbuddy_presize(struct uk_alloc *a, void *obj,
+			  unsigned long num_pages, unsigned long new_num_pages)
+{
+	struct uk_bbpalloc *b;
+	chunk_head_t *buddy_ch;
+	size_t order, new_order, i;
+
+	UK_ASSERT(a != NULL);
+	UK_ASSERT(new_num_pages != 0);
+	b = (struct uk_bbpalloc *)&a->priv;
+
+	order = (size_t)num_pages_to_order(num_pages);
+	new_order = (size_t)num_pages_to_order(new_num_pages);
+
+	if (new_order < order) {
+		/* Shrink: release the upper halves. Their buddies (the lower
+		 * halves) remain allocated, so they cannot be merged.
+		 */
+		for (i = order; i != new_order; i--) {
+			buddy_ch = (chunk_head_t *)((char *)obj
+					+ (1UL << (i - 1 + __PAGE_SHIFT)));
+			map_free(b, (uintptr_t)buddy_ch, 1UL << (i - 1));
+			chunk_link(b, buddy_ch, i - 1, 0);
+		}
+		return 0;
+	}
+
+	if (new_order == order)
+		return 0;
+
+	/* Grow: the chunk has to be the lower half at each level and all
+	 * upper halves have to be complete free chunks.
+	 */
+	if (new_order >= FREELIST_SIZE
+	    || ((uintptr_t)obj & ((1UL << (new_order + __PAGE_SHIFT)) - 1)))
+		return -ENOMEM;
+	for (i = order; i < new_order; i++) {
+		buddy_ch = (chunk_head_t *)((char *)obj
+					    + (1UL << (i + __PAGE_SHIFT)));
+		if (allocated_in_map(b, (uintptr_t)buddy_ch)
+		    || buddy_ch->level != i)
+			return -ENOMEM;
+	}
+	for (i = order; i < new_order; i++) {
+		buddy_ch = (chunk_head_t *)((char *)obj
+					    + (1UL << (i + __PAGE_SHIFT)));
+		chunk_unlink(b, buddy_ch, i);
+		map_alloc(b, (uintptr_t)buddy_ch, 1UL << i);
+	}
+	return 0;
+}
+
+void *uk_allocbbuddy_palloc_order(struct uk_alloc *a, unsigned int order)
+{
+	return bbuddy_palloc_order(a, order);
+}
+
+void uk_allocbbuddy_pfree_order(struct uk_alloc *a, void *ptr,
+				unsigned int order)
+{
+	bbuddy_pfree_order(a, ptr, order);
+}
+
+unsigned int uk_allocbbuddy_free_chunks(struct uk_alloc *a,
+					unsigned long counts[],
+					unsigned int nr_orders)
+{
+	struct uk_bbpalloc *b;
+	unsigned int i;
+
+	UK_ASSERT(a != NULL);
+	UK_ASSERT(counts || !nr_orders);
+	b = (struct uk_bbpalloc *)&a->priv;
+
+	nr_orders = MIN(nr_orders, (unsigned int) FREELIST_SIZE);
+	for (i = 0; i < nr_orders; ++i)
+		counts[i] = b->nr_free_chunks[i];
+	return nr_orders;
 }
 
 static int bbuddy_addmem(struct uk_alloc *a, void *base, size_t len)
@@ -367,10 +688,10 @@ static int bbuddy_addmem(struct uk_alloc *a, void *base, size_t len)
 	struct uk_bbpalloc *b;
 	struct uk_bbpalloc_memr *memr;
 	size_t memr_size;
-	unsigned long count, i;
+	unsigned long count, i, nr_tables;
 	chunk_head_t *ch;
-	chunk_tail_t *ct;
 	uintptr_t min, max, range;
+	uintptr_t tables, tables_end;
 
 	UK_ASSERT(a != NULL);
 	UK_ASSERT(base != NULL);
@@ -378,26 +699,43 @@ static int bbuddy_addmem(struct uk_alloc *a, void *base, size_t len)
 
 	min = round_pgup((uintptr_t)base);
 	max = round_pgdown((uintptr_t)base + (uintptr_t)len);
-	if (max < min) {
+	if (max < min || memr_top_idx(max - 1) >= MEMR_TOP_ENTRIES) {
 		uk_pr_err("%"__PRIuptr": Failed to add memory region %"__PRIuptr"-%"__PRIuptr": Invalid range after applying page alignments\n",
 			  (uintptr_t) a, (uintptr_t) base,
 			  (uintptr_t) base + (uintptr_t) len);
 		return -EINVAL;
 	}
 
+	/* A directory section can be shared by two regions at most. Skip the
+	 * boundary sections of the new region if they are already shared.
+	 */
+	if (max > min && memr_dir_sect_full(b, min))
+		min = ALIGN_DOWN(min, MEMR_SECT_SIZE) + MEMR_SECT_SIZE;
+	if (max > min && memr_dir_sect_full(b, max - 1))
+		max = ALIGN_DOWN(max - 1, MEMR_SECT_SIZE);
+	if (max < min)
+		max = min;
+
+	/* Reserve pages for missing directory tables */
+	nr_tables = memr_dir_missing(b, min, max);
 	range = max - min;
 
 	/* We should have at least one page for bitmap tracking
-	 * and one page for data.
+	 * and one page for data, in addition to the directory tables.
 	 */
 	if (range < round_pgup(sizeof(*memr) + BYTES_PER_MAPWORD) +
-			__PAGE_SIZE) {
+			__PAGE_SIZE + (nr_tables << __PAGE_SHIFT)) {
 		uk_pr_err("%"__PRIuptr": Failed to add memory region %"__PRIuptr"-%"__PRIuptr": Not enough space after applying page alignments\n",
 			  (uintptr_t) a, (uintptr_t) base,
 			  (uintptr_t) base + (uintptr_t) len);
 		return -EINVAL;
 	}
 
+	tables = min;
+	tables_end = min + (nr_tables << __PAGE_SHIFT);
+	min = tables_end;
+	range = max - min;
+
 	memr = (struct uk_bbpalloc_memr *)min;
 
 	/*
@@ -423,9 +761,10 @@ static int bbuddy_addmem(struct uk_alloc *a, void *base, size_t len)
 	 * Initialize region's bitmap
 	 */
 	memr->first_page = min;
-	/* add to list */
+	/* add to list and directory */
 	memr->next = b->memr_head;
 	b->memr_head = memr;
+	memr_dir_insert(b, memr, &tables, tables_end);
 
 	/* All allocated by default. */
 	memset(memr->mm_alloc_bitmap, (unsigned char) ~0,
@@ -451,14 +790,8 @@ static int bbuddy_addmem(struct uk_alloc *a, void *base, size_t len)
 		ch = (chunk_head_t *)min;
 		min += 1UL << i;
 		range -= 1UL << i;
-		ct = (chunk_tail_t *)min - 1;
 		i -= __PAGE_SHIFT;
-		ch->level = i;
-		ch->next = b->free_head[i];
-		ch->pprev = &b->free_head[i];
-		ch->next->pprev = &ch->next;
-		b->free_head[i] = ch;
-		ct->level = i;
+		chunk_link(b, ch, i, ADDMEM_ZEROED);
 		count++;
 	}
 
@@ -504,8 +837,11 @@ struct uk_alloc *uk_allocbbuddy_init(void *base, size_t len)
 	/* initialize and register allocator interface */
 	uk_alloc_init_palloc(a, bbuddy_palloc, bbuddy_pfree,
 			     bbuddy_addmem);
+	a->pzalloc = bbuddy_pzalloc;
+	a->presize = bbuddy_presize;
 #if CONFIG_LIBUKALLOC_IFSTATS
 	a->availmem = bbuddy_availmem;
+	a->dumpstats = bbuddy_dumpstats;
 #endif
 
 	if (max > min + metalen) {
@@ -35,6 +35,7 @@
 #define __UKALLOCBBUDDY_H__
 
 #include <uk/alloc.h>
+#include <uk/arch/limits.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,80 @@ extern "C" {
 
 struct uk_alloc *uk_allocbbuddy_init(void *base, size_t len);
 
+/* Number of chunk orders that are managed by the buddy allocator */
+#define UK_ALLOCBBUDDY_NR_ORDERS ((sizeof(void *) << 3) - __PAGE_SHIFT)
+
+/* Orders of chunks that can be mapped with large pages */
+#define UK_ALLOCBBUDDY_ORDER_2M  (21 - __PAGE_SHIFT)
+#define UK_ALLOCBBUDDY_ORDER_1G  (30 - __PAGE_SHIFT)
+
+/**
+ * Allocates a chunk of 2^order pages from a binary buddy allocator.
+ * Chunks are naturally aligned to their size, so that chunks of order
+ * UK_ALLOCBBUDDY_ORDER_2M or UK_ALLOCBBUDDY_ORDER_1G can be backed by
+ * large pages. The platform's buddy allocator is returned by
+ * ukplat_memallocator_get().
+ *
+ * @param a
+ *   Binary buddy allocator instance
+ * @param order
+ *   Order (log2 of the number of pages) of the chunk
+ * @return
+ *   - (NULL): No free chunk of the requested order, errno is set to ENOMEM
+ *   - Pointer to the first page of the chunk
+ */
+void *uk_allocbbuddy_palloc_order(struct uk_alloc *a, unsigned int order);
+
+/**
+ * Returns a chunk that was allocated with uk_allocbbuddy_palloc_order().
+ *
+ * @param a
+ *   Binary buddy allocator instance
+ * @param ptr
+ *   Pointer to the first page of the chunk
+ * @param order
+ *   Order that was used for allocating the chunk
+ */
+void uk_allocbbuddy_pfree_order(struct uk_alloc *a, void *ptr,
+				unsigned int order);
+
+static inline void *uk_allocbbuddy_palloc_2m(struct uk_alloc *a)
+{
+	return uk_allocbbuddy_palloc_order(a, UK_ALLOCBBUDDY_ORDER_2M);
+}
+
+static inline void uk_allocbbuddy_pfree_2m(struct uk_alloc *a, void *ptr)
+{
+	uk_allocbbuddy_pfree_order(a, ptr, UK_ALLOCBBUDDY_ORDER_2M);
+}
+
+static inline void *uk_allocbbuddy_palloc_1g(struct uk_alloc *a)
+{
+	return uk_allocbbuddy_palloc_order(a, UK_ALLOCBBUDDY_ORDER_1G);
+}
+
+static inline void uk_allocbbuddy_pfree_1g(struct uk_alloc *a, void *ptr)
+{
+	uk_allocbbuddy_pfree_order(a, ptr, UK_ALLOCBBUDDY_ORDER_1G);
+}
+
+/**
+ * Reports the number of free chunks for each order. This can be used to
+ * estimate fragmentation or to check if a large chunk can be allocated.
+ *
+ * @param a
+ *   Binary buddy allocator instance
+ * @param counts
+ *   Array that receives the number of free chunks, indexed by order
+ * @param nr_orders
+ *   Number of entries in `counts`
+ * @return
+ *   Number of entries that were filled in (at most UK_ALLOCBBUDDY_NR_ORDERS)
+ */
+unsigned int uk_allocbbuddy_free_chunks(struct uk_alloc *a,
+					unsigned long counts[],
+					unsigned int nr_orders);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,674 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Allocator benchmarks
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* ukallocbench drives allocators with a set of synthetic allocation
+ * patterns. Each allocator call is timed individually with
+ * ukplat_monotonic_clock(). Because reading the clock can be expensive
+ * (on linuxu it is a system call), its overhead is calibrated once per run
+ * and subtracted from every sample. Latencies are recorded in a log-linear
+ * histogram, so no per-sample memory is needed and percentiles are exact
+ * to within one bucket (12.5%).
+ *
+ * All bookkeeping of the benchmarks lives in static memory so that it does
+ * not show up in the footprint of the allocator under test.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <uk/alloc_impl.h>
+#include <uk/allocbench.h>
+#include <uk/plat/time.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+#if CONFIG_LIBUKALLOCBENCH_INSTANCES
+#if CONFIG_LIBUKALLOCREGION
+#include <uk/allocregion.h>
+#endif
+#if CONFIG_LIBUKALLOCPOOL
+#include <uk/allocpool.h>
+#endif
+#if CONFIG_LIBUKALLOCTLSF
+#include <uk/alloctlsf.h>
+#endif
+#endif
+
+#define BENCH_OPS		((unsigned long) CONFIG_LIBUKALLOCBENCH_OPS)
+#define BENCH_LIVE		((unsigned int) CONFIG_LIBUKALLOCBENCH_LIVE)
+#define BENCH_MINSIZE		((size_t) 16)
+#define BENCH_MAXSIZE		((size_t) CONFIG_LIBUKALLOCBENCH_MAXSIZE)
+#define BENCH_REALLOC_MAXSIZE	((size_t) CONFIG_LIBUKALLOCBENCH_REALLOC_MAXSIZE)
+/* number of objects that are grown concurrently in the realloc pattern */
+#define BENCH_REALLOC_OBJS	16U
+#define BENCH_CALIBRATE_LOOPS	1000
+
+/* Latency histogram: values below HIST_LINEAR ns have a bucket each, every
+ * following power of two is split into HIST_SUB linear buckets.
+ */
+#define HIST_SUB_SHIFT		3
+#define HIST_SUB		(1U << HIST_SUB_SHIFT)
+#define HIST_LINEAR		(2 * HIST_SUB)
+#define HIST_LINEAR_SHIFT	(HIST_SUB_SHIFT + 1)
+#define HIST_BUCKETS		(HIST_LINEAR + \
+				 (64 - HIST_LINEAR_SHIFT) * HIST_SUB)
+
+struct bench_ctx {
+	struct uk_alloc *a;
+	__u64 rnd;
+	__nsec overhead;
+
+	unsigned long nb_ops;
+	unsigned long nb_failed;
+	__nsec time;
+	__nsec lat_max;
+	unsigned long hist[HIST_BUCKETS];
+
+	size_t cur_req;
+	size_t peak_req;
+};
+
+static struct bench_ctx ctx;
+static void *slot[BENCH_LIVE];
+static size_t slot_len[BENCH_LIVE];
+
+static const char *pattern_names[UK_ALLOCBENCH_NR_PATTERNS] = {
+	[UK_ALLOCBENCH_CHURN]    = "churn",
+	[UK_ALLOCBENCH_PRODCONS] = "prodcons",
+	[UK_ALLOCBENCH_REALLOC]  = "realloc",
+	[UK_ALLOCBENCH_ALIGNED]  = "aligned",
+	[UK_ALLOCBENCH_FRAGMENT] = "fragment",
+};
+
+const char *uk_allocbench_pattern_name(enum uk_allocbench_pattern pattern)
+{
+	if ((unsigned int) pattern >= UK_ALLOCBENCH_NR_PATTERNS)
+		return "unknown";
+	return pattern_names[pattern];
+}
+
+/* xorshift64* */
+static inline __u64 bench_rnd(void)
+{
+	ctx.rnd ^= ctx.rnd >> 12;
+	ctx.rnd ^= ctx.rnd << 25;
+	ctx.rnd ^= ctx.rnd >> 27;
+	return ctx.rnd * 0x2545F4914F6CDD1DULL;
+}
+
+static inline size_t bench_rnd_size(size_t min, size_t max)
+{
+	return min + (size_t) (bench_rnd() % (max - min + 1));
+}
+
+static inline unsigned int hist_idx(__nsec v)
+{
+	unsigned int msb;
+
+	if (v < HIST_LINEAR)
+		return (unsigned int) v;
+
+	msb = 63 - __builtin_clzll(v);
+	return HIST_LINEAR + (msb - HIST_LINEAR_SHIFT) * HIST_SUB
+		+ (unsigned int) ((v >> (msb - HIST_SUB_SHIFT))
+				  & (HIST_SUB - 1));
+}
+
+/* largest value that falls into a bucket */
+static inline __nsec hist_upper(unsigned int idx)
+{
+	unsigned int msb, sub;
+
+	if (idx < HIST_LINEAR)
+		return idx;
+
+	msb = HIST_LINEAR_SHIFT + (idx - HIST_LINEAR) / HIST_SUB;
+	sub = (idx - HIST_LINEAR) % HIST_SUB;
+	return (1ULL << msb) + ((__nsec) (sub + 1) << (msb - HIST_SUB_SHIFT))
+		- 1;
+}
+
+static __nsec hist_percentile(unsigned int per10k)
+{
+	unsigned long target, cum = 0;
+	unsigned int i;
+
+	target = (ctx.nb_ops * per10k + 9999) / 10000;
+	if (!target)
+		return 0;
+
+	for (i = 0; i < HIST_BUCKETS; ++i) {
+		cum += ctx.hist[i];
+		if (cum >= target)
+			return MIN(hist_upper(i), ctx.lat_max);
+	}
+	return ctx.lat_max;
+}
+
+static void bench_calibrate(void)
+{
+	__nsec t0, t1, min = (__nsec) -1;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_CALIBRATE_LOOPS; ++i) {
+		t0 = ukplat_monotonic_clock();
+		t1 = ukplat_monotonic_clock();
+		if (t1 - t0 < min)
+			min = t1 - t0;
+	}
+	ctx.overhead = min;
+}
+
+static inline void bench_record(__nsec t0, __nsec t1)
+{
+	__nsec lat = t1 - t0;
+
+	lat = (lat > ctx.overhead) ? lat - ctx.overhead : 0;
+	ctx.nb_ops++;
+	ctx.time += lat;
+	ctx.hist[hist_idx(lat)]++;
+	if (lat > ctx.lat_max)
+		ctx.lat_max = lat;
+}
+
+static inline void bench_req_add(size_t len)
+{
+	ctx.cur_req += len;
+	if (ctx.cur_req > ctx.peak_req)
+		ctx.peak_req = ctx.cur_req;
+}
+
+static void *bench_malloc(size_t len)
+{
+	__nsec t0, t1;
+	void *ptr;
+
+	t0 = ukplat_monotonic_clock();
+	ptr = uk_malloc(ctx.a, len);
+	t1 = ukplat_monotonic_clock();
+	bench_record(t0, t1);
+
+	if (unlikely(!ptr))
+		ctx.nb_failed++;
+	else
+		bench_req_add(len);
+	return ptr;
+}
+
+static void *bench_memalign(size_t align, size_t len)
+{
+	__nsec t0, t1;
+	void *ptr;
+	int rc;
+
+	t0 = ukplat_monotonic_clock();
+	rc = uk_posix_memalign(ctx.a, &ptr, align, len);
+	t1 = ukplat_monotonic_clock();
+	bench_record(t0, t1);
+
+	if (unlikely(rc != 0)) {
+		ctx.nb_failed++;
+		return NULL;
+	}
+	UK_ASSERT(((uintptr_t) ptr & (align - 1)) == 0);
+	bench_req_add(len);
+	return ptr;
+}
+
+static void *bench_realloc(void *ptr, size_t len, size_t new_len)
+{
+	__nsec t0, t1;
+	void *new_ptr;
+
+	t0 = ukplat_monotonic_clock();
+	new_ptr = uk_realloc(ctx.a, ptr, new_len);
+	t1 = ukplat_monotonic_clock();
+	bench_record(t0, t1);
+
+	if (unlikely(!new_ptr)) {
+		ctx.nb_failed++;
+		return NULL;
+	}
+	ctx.cur_req -= len;
+	bench_req_add(new_len);
+	return new_ptr;
+}
+
+static void bench_free(void *ptr, size_t len)
+{
+	__nsec t0, t1;
+
+	if (!ptr)
+		return;
+
+	t0 = ukplat_monotonic_clock();
+	uk_free(ctx.a, ptr);
+	t1 = ukplat_monotonic_clock();
+	bench_record(t0, t1);
+
+	ctx.cur_req -= len;
+}
+
+static void bench_free_slots(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < BENCH_LIVE; ++i) {
+		bench_free(slot[i], slot_len[i]);
+		slot[i] = NULL;
+	}
+}
+
+/* Allocate or free a randomly chosen slot */
+static void bench_churn(void)
+{
+	unsigned int s;
+	size_t len;
+
+	while (ctx.nb_ops < BENCH_OPS) {
+		s = bench_rnd() % BENCH_LIVE;
+		if (slot[s]) {
+			bench_free(slot[s], slot_len[s]);
+			slot[s] = NULL;
+			continue;
+		}
+		len = bench_rnd_size(BENCH_MINSIZE, BENCH_MAXSIZE);
+		slot[s] = bench_malloc(len);
+		slot_len[s] = len;
+	}
+	bench_free_slots();
+}
+
+/* A producer allocates bursts of objects that are queued on a ring, a
+ * consumer frees bursts of them in FIFO order. This is the life cycle of
+ * packet buffers or messages that are handed over to another component.
+ */
+static void bench_prodcons(void)
+{
+	unsigned int head = 0, tail = 0, count = 0;
+	unsigned int burst, i;
+	size_t len;
+
+	while (ctx.nb_ops < BENCH_OPS) {
+		burst = 1 + bench_rnd() % (BENCH_LIVE / 4);
+		for (i = 0; i < burst && count < BENCH_LIVE; ++i) {
+			len = bench_rnd_size(BENCH_MINSIZE, BENCH_MAXSIZE);
+			slot[tail] = bench_malloc(len);
+			if (!slot[tail])
+				break;
+			slot_len[tail] = len;
+			tail = (tail + 1) % BENCH_LIVE;
+			count++;
+		}
+
+		burst = 1 + bench_rnd() % (BENCH_LIVE / 4);
+		for (i = 0; i < burst && count > 0; ++i) {
+			bench_free(slot[head], slot_len[head]);
+			slot[head] = NULL;
+			head = (head + 1) % BENCH_LIVE;
+			count--;
+		}
+	}
+	bench_free_slots();
+}
+
+/* A few objects are grown concurrently by about 1.5x per step until they
+ * reach the maximum size and are freed
+ */
+static void bench_realloc_growth(void)
+{
+	unsigned int s;
+	size_t len;
+	void *ptr;
+
+	while (ctx.nb_ops < BENCH_OPS) {
+		s = bench_rnd() % BENCH_REALLOC_OBJS;
+		if (!slot[s]) {
+			slot[s] = bench_malloc(BENCH_MINSIZE);
+			slot_len[s] = BENCH_MINSIZE;
+			continue;
+		}
+		if (slot_len[s] >= BENCH_REALLOC_MAXSIZE) {
+			bench_free(slot[s], slot_len[s]);
+			slot[s] = NULL;
+			continue;
+		}
+
+		len = slot_len[s] + slot_len[s] / 2
+			+ bench_rnd_size(0, slot_len[s] / 4);
+		len = MIN(len, BENCH_REALLOC_MAXSIZE);
+		ptr = bench_realloc(slot[s], slot_len[s], len);
+		if (!ptr) {
+			/* the old object is still valid */
+			bench_free(slot[s], slot_len[s]);
+			slot[s] = NULL;
+			continue;
+		}
+		slot[s] = ptr;
+		slot_len[s] = len;
+	}
+	bench_free_slots();
+}
+
+/* Like churn, but with random alignments from pointer size up to a page */
+static void bench_aligned(void)
+{
+	unsigned int s;
+	size_t len, align;
+
+	while (ctx.nb_ops < BENCH_OPS) {
+		s = bench_rnd() % BENCH_LIVE;
+		if (slot[s]) {
+			bench_free(slot[s], slot_len[s]);
+			slot[s] = NULL;
+			continue;
+		}
+		align = (size_t) 1 << bench_rnd_size(3, __PAGE_SHIFT);
+		len = bench_rnd_size(BENCH_MINSIZE, BENCH_MAXSIZE);
+		slot[s] = bench_memalign(align, len);
+		slot_len[s] = len;
+	}
+	bench_free_slots();
+}
+
+/* Interleave small and large objects, then replace the large ones by
+ * objects that do not fit into the holes they left behind
+ */
+static void bench_fragment(void)
+{
+	unsigned int s;
+	size_t len;
+
+	while (ctx.nb_ops < BENCH_OPS) {
+		for (s = 0; s < BENCH_LIVE; ++s) {
+			if (s & 1)
+				len = bench_rnd_size(BENCH_MAXSIZE / 2,
+						     BENCH_MAXSIZE);
+			else
+				len = bench_rnd_size(BENCH_MINSIZE,
+						     BENCH_MINSIZE * 4);
+			slot[s] = bench_malloc(len);
+			slot_len[s] = len;
+		}
+		for (s = 1; s < BENCH_LIVE; s += 2) {
+			bench_free(slot[s], slot_len[s]);
+			slot[s] = NULL;
+		}
+		for (s = 1; s < BENCH_LIVE; s += 2) {
+			len = bench_rnd_size(BENCH_MAXSIZE + 1,
+					     2 * BENCH_MAXSIZE);
+			slot[s] = bench_malloc(len);
+			slot_len[s] = len;
+		}
+		bench_free_slots();
+	}
+}
+
+int uk_allocbench_run(struct uk_alloc *a, enum uk_allocbench_pattern pattern,
+		      struct uk_allocbench_result *res)
+{
+#if CONFIG_LIBUKALLOC_IFSTATS
+	struct uk_alloc_stats stats;
+	ssize_t base_use;
+#endif
+
+	UK_ASSERT(a);
+	UK_ASSERT(res);
+
+	if ((unsigned int) pattern >= UK_ALLOCBENCH_NR_PATTERNS)
+		return -EINVAL;
+
+	memset(&ctx, 0, sizeof(ctx));
+	memset(slot, 0, sizeof(slot));
+	ctx.a = a;
+	ctx.rnd = (__u64) CONFIG_LIBUKALLOCBENCH_SEED * 0x9E3779B97F4A7C15ULL
+		  + pattern + 1;
+	bench_calibrate();
+
+#if CONFIG_LIBUKALLOC_IFSTATS
+	/* restart the peak tracking of the allocator at its current usage */
+	uk_alloc_stats_reset(a);
+	uk_alloc_stats_get(a, &stats);
+	base_use = stats.cur_mem_use;
+#endif
+
+	switch (pattern) {
+	case UK_ALLOCBENCH_CHURN:
+		bench_churn();
+		break;
+	case UK_ALLOCBENCH_PRODCONS:
+		bench_prodcons();
+		break;
+	case UK_ALLOCBENCH_REALLOC:
+		bench_realloc_growth();
+		break;
+	case UK_ALLOCBENCH_ALIGNED:
+		bench_aligned();
+		break;
+	case UK_ALLOCBENCH_FRAGMENT:
+		bench_fragment();
+		break;
+	default:
+		break;
+	}
+	UK_ASSERT(ctx.cur_req == 0);
+
+	memset(res, 0, sizeof(*res));
+	res->nb_ops      = ctx.nb_ops;
+	res->nb_failed   = ctx.nb_failed;
+	res->time        = ctx.time;
+	res->ops_per_sec = ctx.time
+			   ? (ctx.nb_ops * ukarch_time_sec_to_nsec(1)) / ctx.time
+			   : 0;
+	res->lat_p50     = hist_percentile(5000);
+	res->lat_p90     = hist_percentile(9000);
+	res->lat_p99     = hist_percentile(9900);
+	res->lat_p999    = hist_percentile(9990);
+	res->lat_max     = ctx.lat_max;
+	res->peak_req    = ctx.peak_req;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	uk_alloc_stats_get(a, &stats);
+	res->peak_use    = (size_t) (stats.max_mem_use - base_use);
+#endif
+	return 0;
+}
+
+void uk_allocbench_print(enum uk_allocbench_pattern pattern,
+			 const struct uk_allocbench_result *res)
+{
+	if (!res) {
+		printf(" %-9s %10s %8s %8s %8s %8s %8s %8s %10s",
+		       "pattern", "ops/s", "p50", "p90", "p99", "p99.9",
+		       "max", "failed", "peak req");
+#if CONFIG_LIBUKALLOC_IFSTATS
+		printf(" %10s", "peak use");
+#endif
+		printf("\n");
+		return;
+	}
+
+	printf(" %-9s %10llu %8llu %8llu %8llu %8llu %8llu %8lu %10lu",
+	       uk_allocbench_pattern_name(pattern),
+	       (unsigned long long) res->ops_per_sec,
+	       (unsigned long long) res->lat_p50,
+	       (unsigned long long) res->lat_p90,
+	       (unsigned long long) res->lat_p99,
+	       (unsigned long long) res->lat_p999,
+	       (unsigned long long) res->lat_max,
+	       res->nb_failed, (unsigned long) res->peak_req);
+#if CONFIG_LIBUKALLOC_IFSTATS
+	printf(" %10lu", (unsigned long) res->peak_use);
+#endif
+	printf("\n");
+}
+
+#if CONFIG_LIBUKALLOCBENCH_INSTANCES
+#define BENCH_INSTANCE_PAGES	CONFIG_LIBUKALLOCBENCH_INSTANCE_PAGES
+#define BENCH_MAX_INSTANCES	3
+
+struct bench_instance {
+	const char *name;
+	struct uk_alloc *a;
+	void *base;
+	int is_region;
+};
+
+static struct bench_instance instances[BENCH_MAX_INSTANCES];
+static unsigned int nb_instances;
+
+static __maybe_unused void *bench_instance_mem(void)
+{
+	void *base;
+
+	base = uk_palloc(uk_alloc_get_default(), BENCH_INSTANCE_PAGES);
+	if (!base)
+		uk_pr_warn("Not enough memory for benchmark allocator instance (%u pages)\n",
+			   BENCH_INSTANCE_PAGES);
+	return base;
+}
+
+static __maybe_unused void bench_instance_add(const char *name,
+					      struct uk_alloc *a,
+					      void *base, int is_region)
+{
+	UK_ASSERT(nb_instances < BENCH_MAX_INSTANCES);
+
+	if (!a) {
+		uk_pfree(uk_alloc_get_default(), base, BENCH_INSTANCE_PAGES);
+		return;
+	}
+	instances[nb_instances].name = name;
+	instances[nb_instances].a = a;
+	instances[nb_instances].base = base;
+	instances[nb_instances].is_region = is_region;
+	nb_instances++;
+}
+
+static void bench_instances_create(void)
+{
+	size_t len __maybe_unused =
+		(size_t) BENCH_INSTANCE_PAGES << __PAGE_SHIFT;
+	void *base __maybe_unused;
+
+	nb_instances = 0;
+	if (!uk_alloc_get_default())
+		return;
+
+#if CONFIG_LIBUKALLOCREGION
+	base = bench_instance_mem();
+	if (base)
+		bench_instance_add("region", uk_allocregion_init(base, len),
+				   base, 1);
+#endif
+#if CONFIG_LIBUKALLOCPOOL
+	base = bench_instance_mem();
+	if (base) {
+		struct uk_allocpool *p;
+
+		p = uk_allocpool_init(base, len, BENCH_MAXSIZE, 64);
+		bench_instance_add("pool", p ? uk_allocpool2ukalloc(p) : NULL,
+				   base, 0);
+	}
+#endif
+#if CONFIG_LIBUKALLOCTLSF
+	base = bench_instance_mem();
+	if (base)
+		bench_instance_add("tlsf", uk_alloctlsf_init(base, len),
+				   base, 0);
+#endif
+}
+
+static void bench_instances_destroy(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_instances; ++i) {
+		uk_alloc_unregister(instances[i].a);
+		uk_pfree(uk_alloc_get_default(), instances[i].base,
+			 BENCH_INSTANCE_PAGES);
+	}
+	nb_instances = 0;
+}
+
+static const char *bench_instance_name(struct uk_alloc *a)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_instances; ++i)
+		if (instances[i].a == a)
+			return instances[i].name;
+	return NULL;
+}
+
+/* Regions cannot free objects: start every pattern with an empty one */
+static void bench_instance_prepare(struct uk_alloc *a __maybe_unused)
+{
+#if CONFIG_LIBUKALLOCREGION
+	unsigned int i;
+
+	for (i = 0; i < nb_instances; ++i)
+		if (instances[i].a == a && instances[i].is_region)
+			uk_allocregion_reset(a);
+#endif
+}
+#else /* !CONFIG_LIBUKALLOCBENCH_INSTANCES */
+#define bench_instances_create()	do {} while (0)
+#define bench_instances_destroy()	do {} while (0)
+#define bench_instance_name(a)		((const char *) NULL)
+#define bench_instance_prepare(a)	do {} while (0)
+#endif /* !CONFIG_LIBUKALLOCBENCH_INSTANCES */
+
+void uk_allocbench_run_all(void)
+{
+	struct uk_allocbench_result res;
+	struct uk_alloc *a;
+	const char *name;
+	unsigned int p;
+
+	bench_instances_create();
+
+	uk_alloc_foreach(a) {
+		name = bench_instance_name(a);
+		printf("Allocator %p%s%s%s:\n", a,
+		       (a == uk_alloc_get_default()) ? " (default)" : "",
+		       name ? " " : "", name ? name : "");
+		uk_allocbench_print(0, NULL);
+
+		for (p = 0; p < UK_ALLOCBENCH_NR_PATTERNS; ++p) {
+			bench_instance_prepare(a);
+			uk_allocbench_run(a, p, &res);
+			uk_allocbench_print(p, &res);
+		}
+	}
+
+	bench_instances_destroy();
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Allocator benchmarks
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UK_ALLOCBENCH_H__
+#define __UK_ALLOCBENCH_H__
+
+#include <uk/alloc.h>
+#include <uk/arch/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum uk_allocbench_pattern {
+	/* random malloc/free on a fixed set of object slots */
+	UK_ALLOCBENCH_CHURN = 0,
+	/* objects are freed in allocation (FIFO) order */
+	UK_ALLOCBENCH_PRODCONS,
+	/* objects are grown with realloc() step by step */
+	UK_ALLOCBENCH_REALLOC,
+	/* random posix_memalign/free with alignments up to a page */
+	UK_ALLOCBENCH_ALIGNED,
+	/* interleaved small and large objects, large ones are freed and
+	 * replaced by even larger ones
+	 */
+	UK_ALLOCBENCH_FRAGMENT,
+
+	UK_ALLOCBENCH_NR_PATTERNS
+};
+
+struct uk_allocbench_result {
+	unsigned long nb_ops;     /* number of allocator calls */
+	unsigned long nb_failed;  /* number of failed allocations */
+	__nsec time;              /* time spent in allocator calls */
+	__u64 ops_per_sec;
+
+	/* latency percentiles of a single allocator call */
+	__nsec lat_p50;
+	__nsec lat_p90;
+	__nsec lat_p99;
+	__nsec lat_p999;
+	__nsec lat_max;
+
+	/* peak number of bytes requested by the benchmark */
+	size_t peak_req;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	/* peak number of bytes handed out as accounted by the allocator */
+	size_t peak_use;
+#endif
+};
+
+/**
+ * Returns a short name for a benchmark pattern.
+ */
+const char *uk_allocbench_pattern_name(enum uk_allocbench_pattern pattern);
+
+/**
+ * Runs one benchmark pattern on an allocator. Latencies are measured with
+ * ukplat_monotonic_clock() around each allocator call; the overhead of the
+ * clock itself is calibrated and subtracted.
+ *
+ * @param a
+ *  Allocator to benchmark.
+ * @param pattern
+ *  Allocation pattern.
+ * @param res
+ *  Result of the benchmark.
+ * @return
+ *  - (0): Success.
+ *  - (-EINVAL): Unknown pattern.
+ */
+int uk_allocbench_run(struct uk_alloc *a, enum uk_allocbench_pattern pattern,
+		      struct uk_allocbench_result *res);
+
+/**
+ * Prints a benchmark result as a table row.
+ * A NULL result prints the table header.
+ */
+void uk_allocbench_print(enum uk_allocbench_pattern pattern,
+			 const struct uk_allocbench_result *res);
+
+/**
+ * Runs all patterns on every registered allocator and prints the results.
+ */
+void uk_allocbench_run_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_ALLOCBENCH_H__ */
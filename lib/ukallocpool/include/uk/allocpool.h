@@ -145,7 +145,70 @@ unsigned int uk_allocpool_availcount(struct uk_allocpool *p);
 size_t uk_allocpool_objlen(struct uk_allocpool *p);
 
 /**
- * Get one object from a pool.
+ * Return the number of objects currently managed by a pool (free and
+ * in use). For growable pools, this changes with growing and shrinking.
+ *
+ * @param p
+ *  Pointer to memory pool.
+ * @return
+ *  Number of objects in the pool.
+ */
+unsigned int uk_allocpool_objcount(struct uk_allocpool *p);
+
+/**
+ * Return the high-water mark of objects that were in use at the same time.
+ *
+ * @param p
+ *  Pointer to memory pool.
+ * @return
+ *  Maximum number of objects in use since creation or the last
+ *  uk_allocpool_peakcount_reset().
+ */
+unsigned int uk_allocpool_peakcount(struct uk_allocpool *p);
+
+/**
+ * Reset the high-water mark to the number of objects currently in use.
+ *
+ * @param p
+ *  Pointer to memory pool.
+ */
+void uk_allocpool_peakcount_reset(struct uk_allocpool *p);
+
+/**
+ * Configure a pool to grow when it runs out of free objects. Additional
+ * objects are allocated from the parent allocator in chunks of
+ * `grow_count` objects. Only pools created with uk_allocpool_alloc()
+ * can grow.
+ *
+ * @param p
+ *  Pointer to memory pool.
+ * @param grow_count
+ *  Number of objects per additional chunk, 0 disables growing.
+ * @param max_count
+ *  Upper limit for the total number of objects, 0 for no limit.
+ * @return
+ *  - (0): Success.
+ *  - (-EINVAL): Pool has no parent allocator.
+ */
+int uk_allocpool_setgrow(struct uk_allocpool *p, unsigned int grow_count,
+			 unsigned int max_count);
+
+/**
+ * Return chunks of a growable pool to the parent allocator whose objects
+ * are all free. The initial pool allocation is never released.
+ * HINT: This call walks the list of free objects and is intended to be
+ *       called when the pool is idle.
+ *
+ * @param p
+ *  Pointer to memory pool.
+ * @return
+ *  Number of objects that were released.
+ */
+unsigned int uk_allocpool_shrink(struct uk_allocpool *p);
+
+/**
+ * Get one object from a pool. A growable pool allocates an additional
+ * chunk from its parent if no free object is left.
  * HINT: It is recommended to use this call instead of uk_malloc() whenever
  *       feasible. This call is avoiding indirections.
  *
@@ -38,7 +38,9 @@
 #include <uk/alloc_impl.h>
 #include <uk/allocpool.h>
 #include <uk/list.h>
+#include <uk/print.h>
 #include <string.h>
+#include <stdio.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
@@ -61,6 +63,22 @@
  *          +=======================+
  *          |         ...           |
  *          v                       v
+ *
+ * A pool that was allocated from a parent allocator can be set up to grow:
+ * When it runs out of free objects, an additional chunk is allocated from
+ * the parent and its objects are added to the free list. Chunks are kept on
+ * a list so that idle ones can be handed back to the parent with
+ * uk_allocpool_shrink().
+ *
+ *          ++---------------------++
+ *          ||  struct pool_chunk  ||
+ *          ++---------------------++
+ *          |    // padding //      |
+ *          +=======================+
+ *          |       OBJECT 1        |
+ *          +=======================+
+ *          |         ...           |
+ *          v                       v
  */
 
 #define MIN_OBJ_ALIGN sizeof(void *)
@@ -78,6 +96,19 @@ struct uk_allocpool {
 
 	struct uk_alloc *parent;
 	void *base;
+
+	struct uk_list_head chunks;
+	unsigned int grow_count; /* objects per chunk, 0: no growing */
+	unsigned int max_count;  /* limit for obj_count, 0: no limit */
+	unsigned int peak_count; /* high-water mark of objects in use */
+};
+
+struct pool_chunk {
+	struct uk_list_head list;
+	uintptr_t obj_start;
+	uintptr_t obj_end;
+	unsigned int obj_count;
+	unsigned int free_count; /* only valid during shrink */
 };
 
 struct free_obj {
@@ -126,6 +157,72 @@ static inline void *_take_free_obj(struct uk_allocpool *p)
 	return (void *) obj;
 }
 
+static inline void _update_peak(struct uk_allocpool *p)
+{
+	unsigned int used = p->obj_count - p->free_obj_count;
+
+	if (used > p->peak_count)
+		p->peak_count = used;
+}
+
+static inline size_t _chunk_reqmem(unsigned int obj_count, size_t obj_len,
+				   size_t obj_align)
+{
+	return sizeof(struct pool_chunk) + obj_align
+		+ ((size_t) obj_count * obj_len);
+}
+
+/* Allocates an additional chunk from the parent allocator and adds its
+ * objects to the free list. Returns 0 on success, -ENOMEM otherwise.
+ */
+static int _pool_grow(struct uk_allocpool *p)
+{
+	struct pool_chunk *c;
+	unsigned int count;
+	uintptr_t obj_ptr;
+	unsigned int i;
+
+	if (!p->grow_count)
+		return -ENOMEM;
+
+	count = p->grow_count;
+	if (p->max_count) {
+		if (p->obj_count >= p->max_count)
+			return -ENOMEM;
+		count = MIN(count, p->max_count - p->obj_count);
+	}
+
+	c = uk_malloc(p->parent, _chunk_reqmem(count, p->obj_len,
+					       p->obj_align));
+	if (unlikely(!c)) {
+		uk_pr_debug("%p: Failed to grow pool by %u objs\n", p, count);
+		return -ENOMEM;
+	}
+
+	obj_ptr = ALIGN_UP((uintptr_t) c + sizeof(*c), p->obj_align);
+	c->obj_start = obj_ptr;
+	c->obj_end = obj_ptr + (size_t) count * p->obj_len;
+	c->obj_count = count;
+	uk_list_add_tail(&c->list, &p->chunks);
+
+	p->obj_count += count;
+	for (i = 0; i < count; ++i) {
+		_prepend_free_obj(p, (void *) obj_ptr);
+		obj_ptr += p->obj_len;
+	}
+
+	uk_pr_debug("%p: Pool grown by %u objs to %u objs\n",
+		    p, count, p->obj_count);
+	return 0;
+}
+
+static inline int _pool_ensure_free(struct uk_allocpool *p)
+{
+	if (likely(!uk_list_empty(&p->free_obj)))
+		return 0;
+	return _pool_grow(p);
+}
+
 static void pool_free(struct uk_alloc *a, void *ptr)
 {
 	struct uk_allocpool *p = ukalloc2pool(a);
@@ -137,14 +234,17 @@ static void pool_free(struct uk_alloc *a, void *ptr)
 static void *pool_malloc(struct uk_alloc *a, size_t size)
 {
 	struct uk_allocpool *p = ukalloc2pool(a);
+	void *ptr;
 
 	if (unlikely((size > p->obj_len)
-		     || uk_list_empty(&p->free_obj))) {
+		     || _pool_ensure_free(p))) {
 		errno = ENOMEM;
 		return NULL;
 	}
 
-	return _take_free_obj(p);
+	ptr = _take_free_obj(p);
+	_update_peak(p);
+	return ptr;
 }
 
 static int pool_posix_memalign(struct uk_alloc *a, void **memptr, size_t align,
@@ -154,22 +254,35 @@ static int pool_posix_memalign(struct uk_alloc *a, void **memptr, size_t align,
 
 	if (unlikely((size > p->obj_len)
 		     || (align > p->obj_align)
-		     || uk_list_empty(&p->free_obj))) {
+		     || _pool_ensure_free(p))) {
 		return ENOMEM;
 	}
 
 	*memptr = _take_free_obj(p);
+	_update_peak(p);
 	return 0;
 }
 
+static size_t pool_getsize(struct uk_alloc *a, const void *ptr __unused)
+{
+	return ukalloc2pool(a)->obj_len;
+}
+
 void *uk_allocpool_take(struct uk_allocpool *p)
 {
+	void *obj;
+
 	UK_ASSERT(p);
 
-	if (unlikely(uk_list_empty(&p->free_obj)))
+	if (unlikely(_pool_ensure_free(p))) {
+		_uk_alloc_stats_count_enomem(allocpool2ukalloc(p), p->obj_len);
 		return NULL;
+	}
 
-	return _take_free_obj(p);
+	obj = _take_free_obj(p);
+	_update_peak(p);
+	_uk_alloc_stats_count_alloc(allocpool2ukalloc(p), obj, p->obj_len);
+	return obj;
 }
 
 unsigned int uk_allocpool_take_batch(struct uk_allocpool *p,
@@ -181,10 +294,16 @@ unsigned int uk_allocpool_take_batch(struct uk_allocpool *p,
 	UK_ASSERT(obj);
 
 	for (i = 0; i < count; ++i) {
-		if (unlikely(uk_list_empty(&p->free_obj)))
+		if (unlikely(_pool_ensure_free(p))) {
+			_uk_alloc_stats_count_enomem(allocpool2ukalloc(p),
+						     p->obj_len);
 			break;
+		}
 		obj[i] = _take_free_obj(p);
+		_uk_alloc_stats_count_alloc(allocpool2ukalloc(p), obj[i],
+					    p->obj_len);
 	}
+	_update_peak(p);
 
 	return i;
 }
@@ -193,6 +312,7 @@ void uk_allocpool_return(struct uk_allocpool *p, void *obj)
 {
 	UK_ASSERT(p);
 
+	_uk_alloc_stats_count_free(allocpool2ukalloc(p), obj, p->obj_len);
 	_prepend_free_obj(p, obj);
 }
 
@@ -204,8 +324,11 @@ void uk_allocpool_return_batch(struct uk_allocpool *p,
 	UK_ASSERT(p);
 	UK_ASSERT(obj);
 
-	for (i = 0; i < count; ++i)
+	for (i = 0; i < count; ++i) {
+		_uk_alloc_stats_count_free(allocpool2ukalloc(p), obj[i],
+					   p->obj_len);
 		_prepend_free_obj(p, obj[i]);
+	}
 }
 
 #if CONFIG_LIBUKALLOC_IFSTATS
@@ -215,6 +338,18 @@ static ssize_t pool_availmem(struct uk_alloc *a)
 
 	return (size_t) p->free_obj_count * p->obj_len;
 }
+
+static void pool_dumpstats(struct uk_alloc *a)
+{
+	struct uk_allocpool *p = ukalloc2pool(a);
+
+	printf(" objects: %u of %"__PRIsz" B, %u free, %u in use (peak %u)\n",
+	       p->obj_count, p->obj_len, p->free_obj_count,
+	       p->obj_count - p->free_obj_count, p->peak_count);
+	if (p->grow_count)
+		printf(" growing by %u objs, limit %u objs\n",
+		       p->grow_count, p->max_count);
+}
 #endif
 
 size_t uk_allocpool_reqmem(unsigned int obj_count, size_t obj_len,
@@ -242,6 +377,94 @@ size_t uk_allocpool_objlen(struct uk_allocpool *p)
 	return p->obj_len;
 }
 
+unsigned int uk_allocpool_objcount(struct uk_allocpool *p)
+{
+	return p->obj_count;
+}
+
+unsigned int uk_allocpool_peakcount(struct uk_allocpool *p)
+{
+	return p->peak_count;
+}
+
+void uk_allocpool_peakcount_reset(struct uk_allocpool *p)
+{
+	p->peak_count = p->obj_count - p->free_obj_count;
+}
+
+int uk_allocpool_setgrow(struct uk_allocpool *p, unsigned int grow_count,
+			 unsigned int max_count)
+{
+	UK_ASSERT(p);
+
+	/* Only pools that have a parent allocator can grow */
+	if (!p->parent && grow_count)
+		return -EINVAL;
+
+	p->grow_count = grow_count;
+	p->max_count  = max_count;
+	return 0;
+}
+
+static inline struct pool_chunk *_obj_chunk(struct uk_allocpool *p,
+					    uintptr_t obj)
+{
+	struct pool_chunk *c;
+
+	uk_list_for_each_entry(c, &p->chunks, list) {
+		if (obj >= c->obj_start && obj < c->obj_end)
+			return c;
+	}
+	return NULL; /* object belongs to the initial pool allocation */
+}
+
+unsigned int uk_allocpool_shrink(struct uk_allocpool *p)
+{
+	struct pool_chunk *c, *cnext;
+	struct free_obj *obj, *onext;
+	unsigned int released = 0;
+
+	UK_ASSERT(p);
+
+	if (uk_list_empty(&p->chunks))
+		return 0;
+
+	/* Count free objects per chunk. This walks the free list and is thus
+	 * meant to be called when the pool is idle, not on the fast path.
+	 */
+	uk_list_for_each_entry(c, &p->chunks, list)
+		c->free_count = 0;
+	uk_list_for_each_entry(obj, &p->free_obj, list) {
+		c = _obj_chunk(p, (uintptr_t) obj);
+		if (c)
+			c->free_count++;
+	}
+
+	/* Unlink free objects of idle chunks */
+	uk_list_for_each_entry_safe(obj, onext, &p->free_obj, list) {
+		c = _obj_chunk(p, (uintptr_t) obj);
+		if (c && c->free_count == c->obj_count) {
+			uk_list_del(&obj->list);
+			p->free_obj_count--;
+		}
+	}
+
+	/* Release idle chunks */
+	uk_list_for_each_entry_safe(c, cnext, &p->chunks, list) {
+		if (c->free_count != c->obj_count)
+			continue;
+		uk_list_del(&c->list);
+		p->obj_count -= c->obj_count;
+		released += c->obj_count;
+		uk_free(p->parent, c);
+	}
+
+	if (released)
+		uk_pr_debug("%p: Pool shrunk by %u objs to %u objs\n",
+			    p, released, p->obj_count);
+	return released;
+}
+
 struct uk_allocpool *uk_allocpool_init(void *base, size_t len,
 				       size_t obj_len, size_t obj_align)
 {
@@ -265,6 +488,8 @@ struct uk_allocpool *uk_allocpool_init(void *base, size_t len,
 	p = (struct uk_allocpool *) base;
 	memset(p, 0, sizeof(*p));
 	a = allocpool2ukalloc(p);
+	UK_INIT_LIST_HEAD(&p->free_obj);
+	UK_INIT_LIST_HEAD(&p->chunks);
 
 	obj_alen = ALIGN_UP(obj_len, obj_align);
 	obj_ptr = (void *) ALIGN_UP((uintptr_t) base + sizeof(*p),
@@ -279,7 +504,6 @@ struct uk_allocpool *uk_allocpool_init(void *base, size_t len,
 
 	p->obj_count = 0;
 	p->free_obj_count = 0;
-	UK_INIT_LIST_HEAD(&p->free_obj);
 	while (left >= obj_alen) {
 		++p->obj_count;
 		_prepend_free_obj(p, obj_ptr);
@@ -301,8 +525,10 @@ out:
 			     pool_posix_memalign,
 			     uk_memalign_compat,
 			     NULL);
+	p->self.getsize = pool_getsize;
 #if CONFIG_LIBUKALLOC_IFSTATS
 	p->self.availmem = pool_availmem;
+	p->self.dumpstats = pool_dumpstats;
 #endif
 
 	uk_pr_debug("%p: Pool created (%"__PRIsz" B): %u objs of %"__PRIsz" B, aligned to %"__PRIsz" B\n",
@@ -337,6 +563,8 @@ struct uk_allocpool *uk_allocpool_alloc(struct uk_alloc *parent,
 
 void uk_allocpool_free(struct uk_allocpool *p)
 {
+	struct pool_chunk *c, *cnext;
+
 	/* If we do not have a parent, this pool was created with
 	 * uk_allocpool_init(). Such a pool cannot be free'd with
 	 * this function since we are not the owner of the allocation
@@ -346,9 +574,10 @@ void uk_allocpool_free(struct uk_allocpool *p)
 	/* Make sure we got all objects back */
 	UK_ASSERT(p->free_obj_count == p->obj_count);
 
-	/* FIXME: Unregister `ukalloc` interface from `lib/ukalloc` */
-	/* TODO: Provide unregistration interface at `lib/ukalloc` */
-	UK_CRASH("Unregistering from `lib/ukalloc` not implemented.\n");
+	uk_alloc_unregister(allocpool2ukalloc(p));
+
+	uk_list_for_each_entry_safe(c, cnext, &p->chunks, list)
+		uk_free(p->parent, c);
 
 	uk_free(p->parent, p->base);
 }
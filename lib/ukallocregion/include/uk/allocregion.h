@@ -43,6 +43,81 @@ extern "C" {
 /* allocator initialization */
 struct uk_alloc *uk_allocregion_init(void *base, size_t len);
 
+/**
+ * Position of the allocation pointer of a region, as taken by
+ * uk_allocregion_checkpoint().
+ */
+struct uk_allocregion_checkpoint {
+	void *heap_base;
+	unsigned long seq;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	long nb_allocs;
+	ssize_t mem_use;
+#endif
+};
+
+/**
+ * Creates a region (arena) on a buffer that is allocated from a parent
+ * allocator. Objects cannot be free'd individually; instead, the arena
+ * can be rolled back to a checkpoint, reset, or destroyed as a whole.
+ *
+ * @param parent
+ *  Allocator from which the arena buffer is allocated.
+ * @param len
+ *  Number of bytes that are available for allocations from the arena.
+ * @return
+ *  - (NULL): Not enough memory in the parent allocator.
+ *  - pointer to uk_alloc interface of the arena.
+ */
+struct uk_alloc *uk_allocregion_create(struct uk_alloc *parent, size_t len);
+
+/**
+ * Destroys an arena that was created with uk_allocregion_create().
+ * The allocator is unregistered and its buffer is returned to the
+ * parent allocator.
+ *
+ * @param a
+ *  Arena to destroy.
+ */
+void uk_allocregion_destroy(struct uk_alloc *a);
+
+/**
+ * Records the current allocation position of a region.
+ *
+ * @param a
+ *  Region allocator.
+ * @param cp
+ *  Checkpoint to fill.
+ */
+void uk_allocregion_checkpoint(struct uk_alloc *a,
+			       struct uk_allocregion_checkpoint *cp);
+
+/**
+ * Releases all allocations that were done after a checkpoint was taken.
+ * Checkpoints taken after `cp` become invalid. Invalid checkpoints must
+ * not be used anymore: Only the ones invalidated by a reset or by the
+ * latest rollback are guaranteed to be rejected.
+ *
+ * @param a
+ *  Region allocator.
+ * @param cp
+ *  Checkpoint taken with uk_allocregion_checkpoint().
+ * @return
+ *  - (0): Success.
+ *  - (-EINVAL): Checkpoint was invalidated by a reset or the latest
+ *    rollback.
+ */
+int uk_allocregion_rollback(struct uk_alloc *a,
+			    const struct uk_allocregion_checkpoint *cp);
+
+/**
+ * Releases all allocations of a region. All checkpoints become invalid.
+ *
+ * @param a
+ *  Region allocator.
+ */
+void uk_allocregion_reset(struct uk_alloc *a);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,9 +33,13 @@
 
 /* ukallocregion is a minimalist region implementation.
  *
- * Note that deallocation is not supported. This makes sense because regions
- * only allow for deallocation at region-granularity. In our case, this would
- * imply the freeing of the entire heap, which is generally not possible.
+ * Note that deallocation of single objects is not supported. This makes sense
+ * because regions only allow for deallocation at region-granularity. For the
+ * heap region created by uk_allocregion_init(), this would imply the freeing
+ * of the entire heap, which is generally not possible. Regions that are
+ * carved out of a parent allocator with uk_allocregion_create() (arenas) can
+ * instead be rolled back to a checkpoint, reset, or returned to the parent as
+ * a whole.
  *
  * Obviously, the lack of deallocation support makes ukallocregion a fairly bad
  * general-purpose allocator. This allocator is interesting in that it offers
@@ -47,6 +51,7 @@
  * an introduction to region-based memory management.
  */
 
+#include <errno.h>
 #include <uk/allocregion.h>
 #include <uk/alloc_impl.h>
 #include <uk/page.h>	/* round_pgup() */
@@ -54,8 +59,22 @@
 struct uk_allocregion {
 	void *heap_top;
 	void *heap_base;
+	void *heap_start;
+	struct uk_alloc *parent; /* NULL if not created from a parent */
+	/* Sequence number of the latest checkpoint */
+	unsigned long cp_seq;
+	/* Checkpoints with a sequence number in the range (cp_gap_start,
+	 * cp_gap_end] were invalidated by the latest rollback, the ones up
+	 * to cp_reset by the latest reset
+	 */
+	unsigned long cp_gap_start;
+	unsigned long cp_gap_end;
+	unsigned long cp_reset;
 };
 
+#define ukalloc2region(a) \
+	((struct uk_allocregion *) &(a)->priv)
+
 void *uk_allocregion_malloc(struct uk_alloc *a, size_t size)
 {
 	struct uk_allocregion *b;
@@ -131,6 +150,15 @@ void uk_allocregion_free(struct uk_alloc *a __unused, void *ptr __unused)
 			"ukallocregion\n", a);
 }
 
+#if CONFIG_LIBUKALLOC_IFSTATS
+static ssize_t uk_allocregion_availmem(struct uk_alloc *a)
+{
+	struct uk_allocregion *b = ukalloc2region(a);
+
+	return (size_t) ((uintptr_t) b->heap_top - (uintptr_t) b->heap_base);
+}
+#endif
+
 int uk_allocregion_addmem(struct uk_alloc *a __unused, void *base __unused,
 				size_t size __unused)
 {
@@ -140,19 +168,13 @@ int uk_allocregion_addmem(struct uk_alloc *a __unused, void *base __unused,
 	return 0;
 }
 
-struct uk_alloc *uk_allocregion_init(void *base, size_t len)
+static struct uk_alloc *_allocregion_setup(void *base, size_t len,
+					   struct uk_alloc *parent)
 {
 	struct uk_alloc *a;
 	struct uk_allocregion *b;
 	size_t metalen = sizeof(*a) + sizeof(*b);
 
-	/* TODO: ukallocregion does not support multiple memory regions yet.
-	 * Because of the multiboot layout, the first region might be a single
-	 * page, so we simply ignore it.
-	 */
-	if (len <= __PAGE_SIZE)
-		return NULL;
-
 	/* enough space for allocator available? */
 	if (metalen > len) {
 		uk_pr_err("Not enough space for allocator: %"__PRIsz
@@ -163,13 +185,16 @@ struct uk_alloc *uk_allocregion_init(void *base, size_t len)
 
 	/* store allocator metadata on the heap, just before the memory pool */
 	a = (struct uk_alloc *)base;
-	b = (struct uk_allocregion *)&a->priv;
+	b = ukalloc2region(a);
 
-	uk_pr_info("Initialize allocregion allocator @ 0x%"
-		   __PRIuptr ", len %"__PRIsz"\n", (uintptr_t)a, len);
-
-	b->heap_top  = (void *)((uintptr_t) base + len);
-	b->heap_base = (void *)((uintptr_t) base + metalen);
+	b->heap_top   = (void *)((uintptr_t) base + len);
+	b->heap_base  = (void *)((uintptr_t) base + metalen);
+	b->heap_start = b->heap_base;
+	b->parent     = parent;
+	b->cp_seq       = 0;
+	b->cp_gap_start = 0;
+	b->cp_gap_end   = 0;
+	b->cp_reset     = 0;
 
 	/* use exclusively "compat" wrappers for calloc, realloc, memalign,
 	 * palloc and pfree as those do not add additional metadata.
@@ -178,6 +203,134 @@ struct uk_alloc *uk_allocregion_init(void *base, size_t len)
 				uk_realloc_compat, uk_allocregion_free,
 				uk_allocregion_posix_memalign,
 				uk_memalign_compat, NULL);
+#if CONFIG_LIBUKALLOC_IFSTATS
+	a->availmem = uk_allocregion_availmem;
+#endif
 
 	return a;
 }
+
+struct uk_alloc *uk_allocregion_init(void *base, size_t len)
+{
+	/* TODO: ukallocregion does not support multiple memory regions yet.
+	 * Because of the multiboot layout, the first region might be a single
+	 * page, so we simply ignore it.
+	 */
+	if (len <= __PAGE_SIZE)
+		return NULL;
+
+	uk_pr_info("Initialize allocregion allocator @ 0x%"
+		   __PRIuptr ", len %"__PRIsz"\n", (uintptr_t)base, len);
+
+	return _allocregion_setup(base, len, NULL);
+}
+
+struct uk_alloc *uk_allocregion_create(struct uk_alloc *parent, size_t len)
+{
+	struct uk_alloc *a;
+	size_t metalen = sizeof(*a) + sizeof(struct uk_allocregion);
+	void *base;
+
+	UK_ASSERT(parent);
+
+	/* overflow check */
+	if (len > (size_t) -1 - metalen) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	base = uk_malloc(parent, metalen + len);
+	if (!base) {
+		uk_pr_debug("%p: Failed to allocate arena of %"__PRIsz" B\n",
+			    parent, len);
+		return NULL;
+	}
+
+	a = _allocregion_setup(base, metalen + len, parent);
+	UK_ASSERT(a);
+
+	uk_pr_debug("%p: Arena created (%"__PRIsz" B) from parent %p\n",
+		    a, len, parent);
+	return a;
+}
+
+void uk_allocregion_destroy(struct uk_alloc *a)
+{
+	struct uk_allocregion *b;
+
+	UK_ASSERT(a);
+	b = ukalloc2region(a);
+
+	/* Regions that were set up with uk_allocregion_init() do not own
+	 * their memory and cannot be returned to anyone
+	 */
+	UK_ASSERT(b->parent);
+
+	uk_alloc_unregister(a);
+	uk_free(b->parent, a);
+}
+
+void uk_allocregion_checkpoint(struct uk_alloc *a,
+			       struct uk_allocregion_checkpoint *cp)
+{
+	struct uk_allocregion *b;
+
+	UK_ASSERT(a);
+	UK_ASSERT(cp);
+	b = ukalloc2region(a);
+
+	cp->heap_base = b->heap_base;
+	cp->seq = ++b->cp_seq;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	cp->nb_allocs = a->_stats.cur_nb_allocs;
+	cp->mem_use   = a->_stats.cur_mem_use;
+#endif
+}
+
+int uk_allocregion_rollback(struct uk_alloc *a,
+			    const struct uk_allocregion_checkpoint *cp)
+{
+	struct uk_allocregion *b;
+
+	UK_ASSERT(a);
+	UK_ASSERT(cp);
+	b = ukalloc2region(a);
+
+	/* A checkpoint can only be rolled back to as long as it lies in the
+	 * currently allocated part of the region. Checkpoints that a reset or
+	 * the latest rollback invalidated are recognized by their sequence
+	 * number, even when the region grew beyond them again.
+	 */
+	if ((uintptr_t) cp->heap_base < (uintptr_t) b->heap_start
+	    || (uintptr_t) cp->heap_base > (uintptr_t) b->heap_base
+	    || cp->seq <= b->cp_reset || cp->seq > b->cp_seq
+	    || (cp->seq > b->cp_gap_start && cp->seq <= b->cp_gap_end))
+		return -EINVAL;
+
+	/* Invalidate the checkpoints that were taken after this one */
+	if (cp->seq < b->cp_seq) {
+		b->cp_gap_start = cp->seq;
+		b->cp_gap_end   = b->cp_seq;
+	}
+	b->heap_base = cp->heap_base;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	a->_stats.cur_nb_allocs = cp->nb_allocs;
+	a->_stats.cur_mem_use   = cp->mem_use;
+#endif
+	return 0;
+}
+
+void uk_allocregion_reset(struct uk_alloc *a)
+{
+	struct uk_allocregion *b;
+
+	UK_ASSERT(a);
+	b = ukalloc2region(a);
+
+	b->heap_base = b->heap_start;
+	b->cp_reset  = b->cp_seq;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	a->_stats.cur_nb_allocs = 0;
+	a->_stats.cur_mem_use   = 0;
+#endif
+}
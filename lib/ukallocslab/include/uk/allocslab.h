@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LIBUKALLOCSLAB_H__
+#define __LIBUKALLOCSLAB_H__
+
+#include <uk/alloc.h>
+#include <uk/arch/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a slab allocator on top of a parent allocator and registers
+ * it as default allocator.
+ * Small objects are served from per-size-class slabs of one page each.
+ * Slab pages and large allocations are taken from the parent with
+ * uk_palloc(). Page allocations (palloc, pfree) and memory additions
+ * (addmem) are forwarded to the parent.
+ *
+ * @param parent
+ *  Page allocator that backs the slab allocator.
+ * @return
+ *  - (NULL): If the allocator could not be initialized (e.g., ENOMEM).
+ *  - pointer to the slab allocator.
+ */
+struct uk_alloc *uk_allocslab_init(struct uk_alloc *parent);
+
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+struct uk_allocslab_magstats {
+	/* allocations served from the magazine of the calling thread */
+	__u64 alloc_hits;
+	/* allocations that required a refill from the slabs */
+	__u64 alloc_misses;
+	/* frees that were put into the magazine of the calling thread */
+	__u64 free_hits;
+	/* frees that required a flush to the slabs */
+	__u64 free_misses;
+};
+
+/**
+ * Returns the magazine hit/miss counters of a slab allocator.
+ *
+ * @param a
+ *  Slab allocator (returned by uk_allocslab_init()).
+ * @param stats
+ *  Structure that is filled with the counters.
+ */
+void uk_allocslab_magstats(struct uk_alloc *a,
+			   struct uk_allocslab_magstats *stats);
+
+/**
+ * Returns all objects cached in the magazines of the calling thread to the
+ * slabs of a slab allocator. Magazines of a thread are flushed automatically
+ * when the thread is destroyed.
+ *
+ * @param a
+ *  Slab allocator (returned by uk_allocslab_init()).
+ */
+void uk_allocslab_magazine_flush(struct uk_alloc *a);
+#endif /* CONFIG_LIBUKALLOCSLAB_MAGAZINES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LIBUKALLOCSLAB_H__ */
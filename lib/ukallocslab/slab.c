@@ -0,0 +1,749 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* ukallocslab is a size-class slab allocator for small objects.
+ *
+ * Every slab is a single page that is taken from the parent allocator. The
+ * page starts with a slab header that is followed by equally sized objects of
+ * one size class. Objects of power-of-two classes are naturally aligned, all
+ * other classes are aligned to the largest power of two dividing the class
+ * size. Free objects are kept in a LIFO list per slab, slabs with free
+ * objects are kept in a list per size class. One fully free slab is cached
+ * per size class, further fully free slabs are returned to the parent.
+ *
+ * Allocations that do not fit into a size class are served as page
+ * allocations from the parent. Such an allocation carries its own header at
+ * the beginning of its first page, so that free() can distinguish both cases
+ * by looking at the header of the page containing the object (or the page
+ * preceding it for page-aligned objects, which are never slab objects).
+ *
+ * With CONFIG_LIBUKALLOCSLAB_MAGAZINES, each thread additionally caches
+ * objects per size class in a magazine that is located in its TLS area.
+ * Empty magazines are refilled with half a magazine of objects from the
+ * slabs, full magazines flush half of their objects back. Magazines are only
+ * used after the scheduler started because there is no TLS area before.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <uk/allocslab.h>
+#include <uk/alloc_impl.h>
+#include <uk/arch/limits.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+#include <uk/list.h>
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+#include <uk/sched.h>
+#include <uk/thread.h>
+#endif
+
+#define SLAB_MAGIC		0x51ab51abU
+#define LARGE_MAGIC		0x1a46e51aU
+
+#define SLAB_MIN_ALIGN		16
+#define SLAB_MAX_OBJ_LEN	1024
+/* Number of fully free slabs kept per size class */
+#define SLAB_MAX_EMPTY		1
+
+struct uk_slab {
+	uint32_t magic;
+	uint16_t cidx;		/* size class index */
+	uint16_t free_count;
+	void *free_obj;		/* LIFO list of free objects */
+	struct uk_list_head list;
+};
+
+struct slab_large {
+	uint32_t magic;
+	unsigned long num_pages;
+	void *base;
+};
+
+/* LARGE_HDR_LEN is a multiple of SLAB_MIN_ALIGN larger or equal to
+ * sizeof(struct slab_large)
+ */
+#define LARGE_HDR_LEN 32
+UK_CTASSERT(!(sizeof(struct slab_large) > LARGE_HDR_LEN));
+
+static const size_t slab_sizes[] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, SLAB_MAX_OBJ_LEN
+};
+
+#define NR_SLAB_CLASSES ARRAY_SIZE(slab_sizes)
+
+struct slab_class {
+	size_t obj_len;
+	size_t obj_align;
+	size_t obj_off;		/* offset of first object within a slab */
+	unsigned int obj_count;	/* objects per slab */
+	unsigned int nr_empty;	/* number of fully free slabs */
+	unsigned int nr_slabs;	/* number of slabs in total */
+	struct uk_list_head partial; /* slabs with free objects */
+};
+
+struct uk_allocslab {
+	struct uk_alloc *parent;
+	struct slab_class cls[NR_SLAB_CLASSES];
+	/* maps (size + SLAB_MIN_ALIGN - 1) / SLAB_MIN_ALIGN to a class */
+	uint8_t size2class[SLAB_MAX_OBJ_LEN / SLAB_MIN_ALIGN + 1];
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+	struct uk_allocslab_magstats magstats;
+#endif
+};
+
+#define ukalloc2slab(a) \
+	((struct uk_allocslab *)&(a)->priv)
+
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+#define MAGAZINE_SIZE	CONFIG_LIBUKALLOCSLAB_MAGAZINE_SIZE
+#define MAGAZINE_BATCH	(MAGAZINE_SIZE / 2)
+UK_CTASSERT(MAGAZINE_BATCH > 0);
+
+struct slab_magazine {
+	unsigned int count;
+	void *obj[MAGAZINE_SIZE];
+};
+
+struct slab_magazine_cache {
+	struct uk_allocslab *owner;
+	struct slab_magazine mag[NR_SLAB_CLASSES];
+};
+
+/* Magazines of the current thread */
+static __uk_tls struct slab_magazine_cache slab_mag;
+#endif /* CONFIG_LIBUKALLOCSLAB_MAGAZINES */
+
+/* Returns the header of the page an object belongs to. Page-aligned objects
+ * are always large allocations with their header in the preceding page.
+ */
+static inline void *slab_obj_hdr(const void *ptr)
+{
+	uintptr_t hdr;
+
+	UK_ASSERT((uintptr_t) ptr > __PAGE_SIZE);
+
+	hdr = ALIGN_DOWN((uintptr_t) ptr, (uintptr_t) __PAGE_SIZE);
+	if (hdr == (uintptr_t) ptr)
+		hdr -= __PAGE_SIZE;
+	return (void *) hdr;
+}
+
+static struct uk_slab *slab_new(struct uk_allocslab *b, unsigned int cidx)
+{
+	struct slab_class *c = &b->cls[cidx];
+	struct uk_slab *s;
+	uintptr_t obj;
+	unsigned int i;
+
+	s = uk_palloc(b->parent, 1);
+	if (unlikely(!s))
+		return NULL;
+
+	s->magic = SLAB_MAGIC;
+	s->cidx = cidx;
+	s->free_count = c->obj_count;
+	s->free_obj = NULL;
+
+	/* build the free list backwards so that objects are handed out in
+	 * ascending address order
+	 */
+	obj = (uintptr_t) s + c->obj_off + (c->obj_count - 1) * c->obj_len;
+	for (i = 0; i < c->obj_count; ++i) {
+		*((void **) obj) = s->free_obj;
+		s->free_obj = (void *) obj;
+		obj -= c->obj_len;
+	}
+
+	uk_list_add(&s->list, &c->partial);
+	c->nr_empty++;
+	c->nr_slabs++;
+	return s;
+}
+
+static void *slab_take(struct uk_allocslab *b, unsigned int cidx)
+{
+	struct slab_class *c = &b->cls[cidx];
+	struct uk_slab *s;
+	void *obj;
+
+	if (unlikely(uk_list_empty(&c->partial))) {
+		if (unlikely(!slab_new(b, cidx))) {
+			errno = ENOMEM;
+			return NULL;
+		}
+	}
+
+	s = uk_list_first_entry(&c->partial, struct uk_slab, list);
+	UK_ASSERT(s->free_count > 0);
+
+	if (s->free_count == c->obj_count)
+		c->nr_empty--;
+
+	obj = s->free_obj;
+	s->free_obj = *((void **) obj);
+	if (--s->free_count == 0)
+		uk_list_del(&s->list);
+
+	return obj;
+}
+
+static void slab_put(struct uk_allocslab *b, struct uk_slab *s, void *obj)
+{
+	struct slab_class *c;
+
+	UK_ASSERT(s->cidx < NR_SLAB_CLASSES);
+	c = &b->cls[s->cidx];
+	UK_ASSERT(s->free_count < c->obj_count);
+	UK_ASSERT(((uintptr_t) obj - (uintptr_t) s - c->obj_off)
+		  % c->obj_len == 0);
+
+	*((void **) obj) = s->free_obj;
+	s->free_obj = obj;
+
+	/* slab was full: it has free objects again */
+	if (s->free_count++ == 0)
+		uk_list_add(&s->list, &c->partial);
+
+	if (s->free_count == c->obj_count) {
+		if (c->nr_empty >= SLAB_MAX_EMPTY) {
+			uk_list_del(&s->list);
+			s->magic = 0;
+			c->nr_slabs--;
+			uk_pfree(b->parent, s, 1);
+		} else {
+			c->nr_empty++;
+		}
+	}
+}
+
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+/* Returns the magazine cache of the current thread if it can be used with
+ * the given allocator, NULL otherwise
+ */
+static inline struct slab_magazine_cache *slab_mag_get(struct uk_allocslab *b)
+{
+	struct uk_sched *s = uk_sched_get_default();
+
+	/* no TLS area before the scheduler started */
+	if (unlikely(!s || !uk_sched_started(s)))
+		return NULL;
+
+	/* bind the magazines of a thread to the first slab allocator that
+	 * is used by it
+	 */
+	if (unlikely(slab_mag.owner != b)) {
+		if (slab_mag.owner)
+			return NULL;
+		slab_mag.owner = b;
+	}
+	return &slab_mag;
+}
+
+static void slab_mag_flush(struct uk_allocslab *b, struct slab_magazine *m,
+			   unsigned int count)
+{
+	void *obj;
+
+	UK_ASSERT(count <= m->count);
+
+	while (count--) {
+		obj = m->obj[--m->count];
+		slab_put(b, slab_obj_hdr(obj), obj);
+	}
+}
+
+static void slab_mag_cache_flush(struct slab_magazine_cache *mc)
+{
+	unsigned int i;
+
+	if (!mc->owner)
+		return;
+
+	for (i = 0; i < NR_SLAB_CLASSES; ++i)
+		slab_mag_flush(mc->owner, &mc->mag[i], mc->mag[i].count);
+}
+
+static void *slab_obj_take(struct uk_allocslab *b, unsigned int cidx)
+{
+	struct slab_magazine_cache *mc = slab_mag_get(b);
+	struct slab_magazine *m;
+	void *obj;
+
+	if (unlikely(!mc))
+		return slab_take(b, cidx);
+
+	m = &mc->mag[cidx];
+	if (likely(m->count > 0)) {
+		b->magstats.alloc_hits++;
+		return m->obj[--m->count];
+	}
+
+	/* refill the magazine in a batch */
+	b->magstats.alloc_misses++;
+	while (m->count < MAGAZINE_BATCH) {
+		obj = slab_take(b, cidx);
+		if (unlikely(!obj))
+			break;
+		m->obj[m->count++] = obj;
+	}
+	if (unlikely(m->count == 0))
+		return NULL;
+	return m->obj[--m->count];
+}
+
+static void slab_obj_put(struct uk_allocslab *b, struct uk_slab *s, void *obj)
+{
+	struct slab_magazine_cache *mc = slab_mag_get(b);
+	struct slab_magazine *m;
+
+	if (unlikely(!mc)) {
+		slab_put(b, s, obj);
+		return;
+	}
+
+	m = &mc->mag[s->cidx];
+	if (unlikely(m->count == MAGAZINE_SIZE)) {
+		/* flush the magazine in a batch */
+		b->magstats.free_misses++;
+		slab_mag_flush(b, m, MAGAZINE_BATCH);
+	} else {
+		b->magstats.free_hits++;
+	}
+	m->obj[m->count++] = obj;
+}
+
+void uk_allocslab_magstats(struct uk_alloc *a,
+			   struct uk_allocslab_magstats *stats)
+{
+	UK_ASSERT(a);
+	UK_ASSERT(stats);
+
+	*stats = ukalloc2slab(a)->magstats;
+}
+
+void uk_allocslab_magazine_flush(struct uk_alloc *a)
+{
+	struct slab_magazine_cache *mc;
+
+	UK_ASSERT(a);
+
+	mc = slab_mag_get(ukalloc2slab(a));
+	if (mc)
+		slab_mag_cache_flush(mc);
+}
+
+static int slab_mag_thread_init(struct uk_thread *thread __unused)
+{
+	/* Nothing to do: magazines start empty because the TLS area of a new
+	 * thread is initialized from the zero-filled .tbss section
+	 */
+	return 0;
+}
+
+static void slab_mag_thread_fini(struct uk_thread *thread)
+{
+	struct slab_magazine_cache *mc;
+
+	/* a thread that never ran did not use its magazines */
+	if (!thread->tls || !thread->sched || !uk_sched_started(thread->sched))
+		return;
+
+	/* The thread is destroyed from the context of another thread: locate
+	 * the magazines within the TLS area of the destroyed thread. The
+	 * offset of a TLS variable is the same in every TLS area.
+	 */
+	mc = (struct slab_magazine_cache *)((uintptr_t) thread->tls +
+		((uintptr_t) &slab_mag -
+		 (uintptr_t) uk_thread_current()->tls));
+	slab_mag_cache_flush(mc);
+}
+UK_THREAD_INIT(slab_mag_thread_init, slab_mag_thread_fini);
+#else /* !CONFIG_LIBUKALLOCSLAB_MAGAZINES */
+#define slab_obj_take(b, cidx) slab_take((b), (cidx))
+#define slab_obj_put(b, s, obj) slab_put((b), (s), (obj))
+#endif /* !CONFIG_LIBUKALLOCSLAB_MAGAZINES */
+
+static inline int slab_size2class(struct uk_allocslab *b, size_t size)
+{
+	UK_ASSERT(size <= SLAB_MAX_OBJ_LEN);
+	return b->size2class[(size + SLAB_MIN_ALIGN - 1) / SLAB_MIN_ALIGN];
+}
+
+/*
+ * Large allocations: hdr_len bytes are reserved in front of the returned
+ * object for the header
+ */
+static void *large_alloc(struct uk_allocslab *b, size_t size, size_t align,
+			 int zero)
+{
+	struct slab_large *hdr;
+	unsigned long num_pages;
+	uintptr_t base, ptr;
+	size_t realsize;
+
+	align = MAX(align, (size_t) SLAB_MIN_ALIGN);
+	realsize = size + MAX(align, (size_t) LARGE_HDR_LEN);
+
+	/* check for overflow */
+	if (unlikely(realsize < size))
+		return NULL;
+
+	num_pages = DIV_ROUND_UP(realsize, __PAGE_SIZE);
+	if (zero && uk_alloc_has_pzalloc(b->parent))
+		base = (uintptr_t) uk_pzalloc(b->parent, num_pages);
+	else
+		base = (uintptr_t) uk_palloc(b->parent, num_pages);
+	if (unlikely(!base))
+		return NULL;
+
+	if (align < __PAGE_SIZE)
+		ptr = ALIGN_UP(base + LARGE_HDR_LEN, (uintptr_t) align);
+	else
+		ptr = ALIGN_UP(base + __PAGE_SIZE, (uintptr_t) align);
+
+	hdr = slab_obj_hdr((void *) ptr);
+	UK_ASSERT((uintptr_t) hdr >= base);
+	hdr->magic = LARGE_MAGIC;
+	hdr->num_pages = num_pages;
+	hdr->base = (void *) base;
+
+	return (void *) ptr;
+}
+
+static void large_free(struct uk_allocslab *b, struct slab_large *hdr)
+{
+	UK_ASSERT(hdr->base != NULL);
+	UK_ASSERT(hdr->num_pages != 0);
+
+	hdr->magic = 0;
+	uk_pfree(b->parent, hdr->base, hdr->num_pages);
+}
+
+static void *slab_malloc(struct uk_alloc *a, size_t size)
+{
+	struct uk_allocslab *b;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	if (unlikely(!size))
+		return NULL;
+
+	if (likely(size <= SLAB_MAX_OBJ_LEN))
+		return slab_obj_take(b, slab_size2class(b, size));
+
+	return large_alloc(b, size, SLAB_MIN_ALIGN, 0);
+}
+
+static void *slab_calloc(struct uk_alloc *a, size_t nmemb, size_t size)
+{
+	struct uk_allocslab *b;
+	size_t tlen = nmemb * size;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	/* large allocations can make use of zeroed pages of the parent */
+	if (!uk_alloc_has_pzalloc(b->parent) || !tlen
+	    || tlen <= SLAB_MAX_OBJ_LEN)
+		return uk_calloc_compat(a, nmemb, size);
+
+	/* check for overflow */
+	if (nmemb > (~(size_t)0)/size)
+		return NULL;
+
+	return large_alloc(b, tlen, SLAB_MIN_ALIGN, 1);
+}
+
+static void slab_free(struct uk_alloc *a, void *ptr)
+{
+	struct uk_allocslab *b;
+	uint32_t *magic;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	if (!ptr)
+		return;
+
+	magic = slab_obj_hdr(ptr);
+	if (likely(*magic == SLAB_MAGIC)) {
+		slab_obj_put(b, (struct uk_slab *) magic, ptr);
+		return;
+	}
+
+	UK_ASSERT(*magic == LARGE_MAGIC);
+	large_free(b, (struct slab_large *) magic);
+}
+
+static size_t slab_getmallocsize(struct uk_allocslab *b, const void *ptr)
+{
+	struct slab_large *hdr;
+	uint32_t *magic;
+
+	magic = slab_obj_hdr(ptr);
+	if (*magic == SLAB_MAGIC)
+		return b->cls[((struct uk_slab *) magic)->cidx].obj_len;
+
+	UK_ASSERT(*magic == LARGE_MAGIC);
+	hdr = (struct slab_large *) magic;
+	return (size_t) hdr->base + (size_t) hdr->num_pages * __PAGE_SIZE
+		- (size_t) ptr;
+}
+
+static size_t slab_getsize(struct uk_alloc *a, const void *ptr)
+{
+	UK_ASSERT(a);
+	return slab_getmallocsize(ukalloc2slab(a), ptr);
+}
+
+static void *slab_realloc(struct uk_alloc *a, void *ptr, size_t size)
+{
+	struct uk_allocslab *b;
+	struct slab_large *hdr;
+	unsigned long num_pages;
+	size_t mallocsize, realsize;
+	void *retptr;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	if (!ptr)
+		return slab_malloc(a, size);
+
+	if (!size) {
+		slab_free(a, ptr);
+		return NULL;
+	}
+
+	/* object still fits into its current slot */
+	mallocsize = slab_getmallocsize(b, ptr);
+	if (size <= mallocsize)
+		return ptr;
+
+	/* large objects may be resized in place by the parent */
+	hdr = slab_obj_hdr(ptr);
+	if (hdr->magic == LARGE_MAGIC) {
+		realsize = (uintptr_t) ptr - (uintptr_t) hdr->base + size;
+		num_pages = DIV_ROUND_UP(realsize, __PAGE_SIZE);
+		if (realsize > size
+		    && uk_presize(b->parent, hdr->base, hdr->num_pages,
+				  num_pages) == 0) {
+			hdr->num_pages = num_pages;
+			return ptr;
+		}
+	}
+
+	retptr = slab_malloc(a, size);
+	if (!retptr)
+		return NULL;
+
+	memcpy(retptr, ptr, mallocsize);
+	slab_free(a, ptr);
+	return retptr;
+}
+
+static int slab_posix_memalign(struct uk_alloc *a, void **memptr,
+			       size_t align, size_t size)
+{
+	struct uk_allocslab *b;
+	unsigned int cidx;
+	void *ptr;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	if (((align - 1) & align) != 0
+	    || (align % sizeof(void *)) != 0)
+		return EINVAL;
+
+	/* Leave memptr untouched. See comment in uk_posix_memalign_ifpages. */
+	if (!size)
+		return EINVAL;
+
+	if (size <= SLAB_MAX_OBJ_LEN && align <= SLAB_MAX_OBJ_LEN) {
+		/* find smallest class that satisfies the alignment */
+		for (cidx = slab_size2class(b, size);
+		     cidx < NR_SLAB_CLASSES; ++cidx) {
+			if (b->cls[cidx].obj_align >= align)
+				break;
+		}
+		if (cidx < NR_SLAB_CLASSES) {
+			ptr = slab_obj_take(b, cidx);
+			goto out;
+		}
+	}
+
+	ptr = large_alloc(b, size, align, 0);
+
+out:
+	if (unlikely(!ptr))
+		return ENOMEM;
+
+	*memptr = ptr;
+	return 0;
+}
+
+static void *slab_palloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	UK_ASSERT(a);
+	return uk_palloc(ukalloc2slab(a)->parent, num_pages);
+}
+
+static void slab_pfree(struct uk_alloc *a, void *ptr, unsigned long num_pages)
+{
+	UK_ASSERT(a);
+	uk_pfree(ukalloc2slab(a)->parent, ptr, num_pages);
+}
+
+static void *slab_pzalloc(struct uk_alloc *a, unsigned long num_pages)
+{
+	UK_ASSERT(a);
+	return uk_pzalloc(ukalloc2slab(a)->parent, num_pages);
+}
+
+static int slab_presize(struct uk_alloc *a, void *ptr,
+			unsigned long num_pages, unsigned long new_num_pages)
+{
+	UK_ASSERT(a);
+	return uk_presize(ukalloc2slab(a)->parent, ptr, num_pages,
+			  new_num_pages);
+}
+
+static int slab_addmem(struct uk_alloc *a, void *base, size_t len)
+{
+	UK_ASSERT(a);
+	return uk_alloc_addmem(ukalloc2slab(a)->parent, base, len);
+}
+
+#if CONFIG_LIBUKALLOC_IFSTATS
+static ssize_t slab_availmem(struct uk_alloc *a)
+{
+	UK_ASSERT(a);
+	return uk_alloc_availmem(ukalloc2slab(a)->parent);
+}
+
+static void slab_dumpstats(struct uk_alloc *a)
+{
+	struct uk_allocslab *b;
+	struct slab_class *c;
+	struct uk_slab *s;
+	unsigned long nr_free;
+	unsigned int i;
+
+	UK_ASSERT(a);
+	b = ukalloc2slab(a);
+
+	printf(" size classes (objects in use/slabs):\n");
+	for (i = 0; i < NR_SLAB_CLASSES; ++i) {
+		c = &b->cls[i];
+		if (!c->nr_slabs)
+			continue;
+
+		nr_free = 0;
+		uk_list_for_each_entry(s, &c->partial, list)
+			nr_free += s->free_count;
+		printf("  %4"__PRIsz" B: %lu/%u\n", c->obj_len,
+		       (unsigned long) c->nr_slabs * c->obj_count
+		       - nr_free, c->nr_slabs);
+	}
+#if CONFIG_LIBUKALLOCSLAB_MAGAZINES
+	printf(" magazines: alloc hits %"__PRIu64", misses %"__PRIu64"; free hits %"__PRIu64", misses %"__PRIu64"\n",
+	       b->magstats.alloc_hits, b->magstats.alloc_misses,
+	       b->magstats.free_hits, b->magstats.free_misses);
+#endif
+}
+#endif
+
+struct uk_alloc *uk_allocslab_init(struct uk_alloc *parent)
+{
+	struct uk_alloc *a;
+	struct uk_allocslab *b;
+	struct slab_class *c;
+	size_t metalen;
+	unsigned int i, j;
+
+	UK_ASSERT(parent);
+
+	metalen = sizeof(*a) + sizeof(*b);
+	a = uk_palloc(parent, DIV_ROUND_UP(metalen, __PAGE_SIZE));
+	if (!a) {
+		uk_pr_err("Not enough space for allocator: %"__PRIsz" B required\n",
+			  metalen);
+		return NULL;
+	}
+	memset(a, 0, metalen);
+	b = ukalloc2slab(a);
+	b->parent = parent;
+
+	for (i = 0, j = 0; i < NR_SLAB_CLASSES; ++i) {
+		c = &b->cls[i];
+		c->obj_len   = slab_sizes[i];
+		/* largest power of two that divides the object size */
+		c->obj_align = c->obj_len & -c->obj_len;
+		c->obj_off   = ALIGN_UP(sizeof(struct uk_slab), c->obj_align);
+		c->obj_count = (__PAGE_SIZE - c->obj_off) / c->obj_len;
+		c->nr_empty  = 0;
+		UK_INIT_LIST_HEAD(&c->partial);
+		UK_ASSERT(c->obj_align >= SLAB_MIN_ALIGN);
+		UK_ASSERT(c->obj_count > 0);
+
+		for (; j * SLAB_MIN_ALIGN <= c->obj_len; ++j)
+			b->size2class[j] = i;
+	}
+
+	a->malloc         = slab_malloc;
+	a->calloc         = slab_calloc;
+	a->realloc        = slab_realloc;
+	a->posix_memalign = slab_posix_memalign;
+	a->memalign       = uk_memalign_compat;
+	a->free           = slab_free;
+	a->palloc         = slab_palloc;
+	a->pfree          = slab_pfree;
+	a->pzalloc        = uk_alloc_has_pzalloc(parent) ? slab_pzalloc : NULL;
+	a->presize        = slab_presize;
+	a->addmem         = slab_addmem;
+	a->getsize        = slab_getsize;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	a->availmem       = slab_availmem;
+	a->dumpstats      = slab_dumpstats;
+#endif
+
+	uk_alloc_register(a);
+	uk_alloc_set_default(a);
+
+	uk_pr_info("Initialize slab allocator %p on top of %p\n", a, parent);
+	return a;
+}
@@ -0,0 +1,742 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* ukalloctlsf implements a Two-Level Segregated Fit allocator.
+ *
+ * Free blocks are kept in segregated lists. The first level splits block
+ * sizes into power-of-two classes, the second level linearly subdivides each
+ * class into SL_INDEX_COUNT ranges. Two levels of bitmaps track non-empty
+ * lists so that a suitable free block is found with two find-first-set
+ * operations. Freed blocks are immediately merged with free physical
+ * neighbors. Every operation is thus O(1), independent of the heap state.
+ *
+ * Every block starts with a header that links it to its previous physical
+ * block (only valid if that one is free) and stores its size together with
+ * the free flags of itself and its predecessor. Free blocks additionally
+ * store free-list links in their data area. Each memory region ends with a
+ * zero-sized sentinel block that is marked as used.
+ *
+ * Refer to Masmano et al., `TLSF: a New Dynamic Memory Allocator for
+ * Real-Time Systems' (ECRTS'04) for details.
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <uk/alloctlsf.h>
+#include <uk/alloc_impl.h>
+#include <uk/arch/atomic.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+
+#define ALIGN_SIZE_LOG2		4
+#define ALIGN_SIZE		(1UL << ALIGN_SIZE_LOG2)
+
+/* log2 of number of linear subdivisions of block sizes */
+#define SL_INDEX_COUNT_LOG2	5
+#define SL_INDEX_COUNT		(1U << SL_INDEX_COUNT_LOG2)
+
+/* Largest block size is 2^FL_INDEX_MAX - 1 */
+#define FL_INDEX_MAX		((sizeof(size_t) == 8) ? 38 : 30)
+#define FL_INDEX_SHIFT		(SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2)
+#define FL_INDEX_COUNT		(FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+
+/* Blocks smaller than SMALL_BLOCK_SIZE are all in first-level list 0 */
+#define SMALL_BLOCK_SIZE	(1UL << FL_INDEX_SHIFT)
+
+struct tlsf_block {
+	/* previous physical block, only valid if it is free */
+	struct tlsf_block *prev_phys;
+	/* size of the data area, lowest bits are used as flags */
+	size_t size;
+	/* free-list links, only valid if this block is free */
+	struct tlsf_block *next_free;
+	struct tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE_BIT		(1UL << 0)
+#define BLOCK_PREV_FREE_BIT	(1UL << 1)
+#define BLOCK_FLAGS		(BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT)
+
+/* Header in front of the data area of each block */
+#define BLOCK_HDR_LEN		offsetof(struct tlsf_block, next_free)
+/* Data area must be big enough to hold the free-list links */
+#define BLOCK_SIZE_MIN		(sizeof(struct tlsf_block) - BLOCK_HDR_LEN)
+#define BLOCK_SIZE_MAX		((size_t) 1 << FL_INDEX_MAX)
+
+UK_CTASSERT(BLOCK_HDR_LEN % ALIGN_SIZE == 0);
+UK_CTASSERT(BLOCK_SIZE_MIN % ALIGN_SIZE == 0);
+UK_CTASSERT(SL_INDEX_COUNT <= sizeof(unsigned int) * 8);
+UK_CTASSERT(FL_INDEX_COUNT <= sizeof(unsigned long) * 8);
+
+struct uk_tlsf {
+	/* Empty lists point to this block */
+	struct tlsf_block null_block;
+
+	unsigned long fl_bitmap;
+	unsigned int sl_bitmap[FL_INDEX_COUNT];
+	struct tlsf_block *blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+
+	size_t free_bytes;
+};
+
+#define ukalloc2tlsf(a) \
+	((struct uk_tlsf *)&(a)->priv)
+
+/*********************
+ * BLOCK HELPERS
+ */
+static inline size_t block_size(const struct tlsf_block *block)
+{
+	return block->size & ~BLOCK_FLAGS;
+}
+
+static inline void block_set_size(struct tlsf_block *block, size_t size)
+{
+	block->size = size | (block->size & BLOCK_FLAGS);
+}
+
+static inline int block_is_last(const struct tlsf_block *block)
+{
+	return block_size(block) == 0;
+}
+
+static inline int block_is_free(const struct tlsf_block *block)
+{
+	return !!(block->size & BLOCK_FREE_BIT);
+}
+
+static inline int block_is_prev_free(const struct tlsf_block *block)
+{
+	return !!(block->size & BLOCK_PREV_FREE_BIT);
+}
+
+static inline void block_set_prev_free(struct tlsf_block *block)
+{
+	block->size |= BLOCK_PREV_FREE_BIT;
+}
+
+static inline void block_set_prev_used(struct tlsf_block *block)
+{
+	block->size &= ~BLOCK_PREV_FREE_BIT;
+}
+
+static inline void *block_to_ptr(const struct tlsf_block *block)
+{
+	return (void *) ((uintptr_t) block + BLOCK_HDR_LEN);
+}
+
+static inline struct tlsf_block *block_from_ptr(const void *ptr)
+{
+	return (struct tlsf_block *) ((uintptr_t) ptr - BLOCK_HDR_LEN);
+}
+
+static inline struct tlsf_block *block_next(const struct tlsf_block *block)
+{
+	UK_ASSERT(!block_is_last(block));
+	return (struct tlsf_block *) ((uintptr_t) block_to_ptr(block)
+				      + block_size(block));
+}
+
+/* Link a block to its successor and return the successor */
+static inline struct tlsf_block *block_link_next(struct tlsf_block *block)
+{
+	struct tlsf_block *next = block_next(block);
+
+	next->prev_phys = block;
+	return next;
+}
+
+static inline void block_mark_as_free(struct tlsf_block *block)
+{
+	struct tlsf_block *next = block_link_next(block);
+
+	block_set_prev_free(next);
+	block->size |= BLOCK_FREE_BIT;
+}
+
+static inline void block_mark_as_used(struct tlsf_block *block)
+{
+	struct tlsf_block *next = block_next(block);
+
+	block_set_prev_used(next);
+	block->size &= ~BLOCK_FREE_BIT;
+}
+
+/* Round up a requested size to a valid block size. Returns 0 if the
+ * request cannot be served.
+ */
+static inline size_t adjust_request_size(size_t size, size_t align)
+{
+	size_t aligned;
+
+	if (!size || size >= BLOCK_SIZE_MAX)
+		return 0;
+
+	aligned = ALIGN_UP(size, align);
+	return MAX(aligned, (size_t) BLOCK_SIZE_MIN);
+}
+
+/*********************
+ * SIZE MAPPING
+ */
+static inline void mapping_insert(size_t size,
+				  unsigned int *fl, unsigned int *sl)
+{
+	unsigned int f, s;
+
+	if (size < SMALL_BLOCK_SIZE) {
+		/* store small blocks in first list */
+		f = 0;
+		s = size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+	} else {
+		f = ukarch_flsl(size);
+		s = (size >> (f - SL_INDEX_COUNT_LOG2))
+			^ (1U << SL_INDEX_COUNT_LOG2);
+		f -= (FL_INDEX_SHIFT - 1);
+	}
+	*fl = f;
+	*sl = s;
+}
+
+/* Like mapping_insert() but rounds up to the next list so that every block
+ * of the resulting list is large enough
+ */
+static inline void mapping_search(size_t size,
+				  unsigned int *fl, unsigned int *sl)
+{
+	if (size >= SMALL_BLOCK_SIZE)
+		size += (1UL << (ukarch_flsl(size) - SL_INDEX_COUNT_LOG2)) - 1;
+	mapping_insert(size, fl, sl);
+}
+
+/*********************
+ * FREE LISTS
+ */
+static struct tlsf_block *search_suitable_block(struct uk_tlsf *t,
+						unsigned int *fl,
+						unsigned int *sl)
+{
+	unsigned int f = *fl;
+	unsigned int s = *sl;
+	unsigned long fl_map;
+	unsigned int sl_map;
+
+	/* search for a non-empty list in the given first level list */
+	sl_map = t->sl_bitmap[f] & (~0U << s);
+	if (!sl_map) {
+		/* continue with the next larger first level list */
+		fl_map = t->fl_bitmap & (~0UL << (f + 1));
+		if (!fl_map)
+			return NULL; /* out-of-memory */
+
+		f = ukarch_ffsl(fl_map);
+		sl_map = t->sl_bitmap[f];
+		UK_ASSERT(sl_map);
+	}
+	s = ukarch_ffsl(sl_map);
+
+	*fl = f;
+	*sl = s;
+	return t->blocks[f][s];
+}
+
+static void remove_free_block(struct uk_tlsf *t, struct tlsf_block *block,
+			      unsigned int fl, unsigned int sl)
+{
+	struct tlsf_block *prev = block->prev_free;
+	struct tlsf_block *next = block->next_free;
+
+	UK_ASSERT(prev && next);
+	next->prev_free = prev;
+	prev->next_free = next;
+
+	if (t->blocks[fl][sl] == block) {
+		t->blocks[fl][sl] = next;
+
+		/* list is empty now, clear bitmaps */
+		if (next == &t->null_block) {
+			t->sl_bitmap[fl] &= ~(1U << sl);
+			if (!t->sl_bitmap[fl])
+				t->fl_bitmap &= ~(1UL << fl);
+		}
+	}
+	t->free_bytes -= block_size(block);
+}
+
+static void insert_free_block(struct uk_tlsf *t, struct tlsf_block *block,
+			      unsigned int fl, unsigned int sl)
+{
+	struct tlsf_block *current = t->blocks[fl][sl];
+
+	UK_ASSERT(current);
+	block->next_free = current;
+	block->prev_free = &t->null_block;
+	current->prev_free = block;
+
+	t->blocks[fl][sl] = block;
+	t->fl_bitmap |= (1UL << fl);
+	t->sl_bitmap[fl] |= (1U << sl);
+	t->free_bytes += block_size(block);
+}
+
+static inline void block_remove(struct uk_tlsf *t, struct tlsf_block *block)
+{
+	unsigned int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+	remove_free_block(t, block, fl, sl);
+}
+
+static inline void block_insert(struct uk_tlsf *t, struct tlsf_block *block)
+{
+	unsigned int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+	insert_free_block(t, block, fl, sl);
+}
+
+/*********************
+ * SPLITTING AND MERGING
+ */
+static inline int block_can_split(struct tlsf_block *block, size_t size)
+{
+	return block_size(block) >= BLOCK_HDR_LEN + BLOCK_SIZE_MIN + size;
+}
+
+/* Split a block into two, the second of which is free */
+static struct tlsf_block *block_split(struct tlsf_block *block, size_t size)
+{
+	struct tlsf_block *remaining;
+	size_t remain_size;
+
+	remaining = (struct tlsf_block *) ((uintptr_t) block_to_ptr(block)
+					   + size);
+	remain_size = block_size(block) - (size + BLOCK_HDR_LEN);
+
+	UK_ASSERT(remain_size >= BLOCK_SIZE_MIN);
+	remaining->size = remain_size;
+	block_set_size(block, size);
+	block_mark_as_free(remaining);
+	return remaining;
+}
+
+/* Absorb a free block's storage into an adjacent previous free block */
+static struct tlsf_block *block_absorb(struct tlsf_block *prev,
+				       struct tlsf_block *block)
+{
+	UK_ASSERT(!block_is_last(prev));
+	prev->size += block_size(block) + BLOCK_HDR_LEN;
+	block_link_next(prev);
+	return prev;
+}
+
+static struct tlsf_block *block_merge_prev(struct uk_tlsf *t,
+					   struct tlsf_block *block)
+{
+	struct tlsf_block *prev;
+
+	if (block_is_prev_free(block)) {
+		prev = block->prev_phys;
+		UK_ASSERT(prev && block_is_free(prev));
+		block_remove(t, prev);
+		block = block_absorb(prev, block);
+	}
+	return block;
+}
+
+static struct tlsf_block *block_merge_next(struct uk_tlsf *t,
+					   struct tlsf_block *block)
+{
+	struct tlsf_block *next = block_next(block);
+
+	if (block_is_free(next)) {
+		UK_ASSERT(!block_is_last(block));
+		block_remove(t, next);
+		block = block_absorb(block, next);
+	}
+	return block;
+}
+
+/* Trim any trailing block space off the end of a free block and return it
+ * to the pool
+ */
+static void block_trim_free(struct uk_tlsf *t, struct tlsf_block *block,
+			    size_t size)
+{
+	struct tlsf_block *remaining;
+
+	UK_ASSERT(block_is_free(block));
+	if (block_can_split(block, size)) {
+		remaining = block_split(block, size);
+		block_link_next(block);
+		block_set_prev_free(remaining);
+		block_insert(t, remaining);
+	}
+}
+
+/* Trim any trailing block space off the end of a used block and return it
+ * to the pool
+ */
+static void block_trim_used(struct uk_tlsf *t, struct tlsf_block *block,
+			    size_t size)
+{
+	struct tlsf_block *remaining;
+
+	UK_ASSERT(!block_is_free(block));
+	if (block_can_split(block, size)) {
+		remaining = block_split(block, size);
+		block_set_prev_used(remaining);
+		remaining = block_merge_next(t, remaining);
+		block_insert(t, remaining);
+	}
+}
+
+/* Split off leading free space of a free block so that the data area of
+ * the returned block starts `gap` bytes later
+ */
+static struct tlsf_block *block_trim_free_leading(struct uk_tlsf *t,
+						  struct tlsf_block *block,
+						  size_t gap)
+{
+	struct tlsf_block *remaining = block;
+
+	UK_ASSERT(gap >= BLOCK_HDR_LEN + BLOCK_SIZE_MIN);
+	if (block_can_split(block, gap - BLOCK_HDR_LEN)) {
+		remaining = block_split(block, gap - BLOCK_HDR_LEN);
+		block_set_prev_free(remaining);
+
+		block_link_next(block);
+		block_insert(t, block);
+	}
+	return remaining;
+}
+
+static struct tlsf_block *block_locate_free(struct uk_tlsf *t, size_t size)
+{
+	struct tlsf_block *block;
+	unsigned int fl, sl;
+
+	if (!size)
+		return NULL;
+
+	mapping_search(size, &fl, &sl);
+	if (unlikely(fl >= FL_INDEX_COUNT))
+		return NULL;
+
+	block = search_suitable_block(t, &fl, &sl);
+	if (!block || block == &t->null_block)
+		return NULL;
+
+	UK_ASSERT(block_size(block) >= size);
+	remove_free_block(t, block, fl, sl);
+	return block;
+}
+
+static void *block_prepare_used(struct uk_tlsf *t, struct tlsf_block *block,
+				size_t size)
+{
+	UK_ASSERT(size);
+	block_trim_free(t, block, size);
+	block_mark_as_used(block);
+	return block_to_ptr(block);
+}
+
+/*********************
+ * ALLOCATOR INTERFACE
+ */
+static void *tlsf_malloc(struct uk_alloc *a, size_t size)
+{
+	struct uk_tlsf *t;
+	struct tlsf_block *block;
+	size_t adjust;
+
+	UK_ASSERT(a);
+	t = ukalloc2tlsf(a);
+
+	adjust = adjust_request_size(size, ALIGN_SIZE);
+	block = block_locate_free(t, adjust);
+	if (unlikely(!block)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return block_prepare_used(t, block, adjust);
+}
+
+static void tlsf_free(struct uk_alloc *a, void *ptr)
+{
+	struct uk_tlsf *t;
+	struct tlsf_block *block;
+
+	UK_ASSERT(a);
+	t = ukalloc2tlsf(a);
+
+	if (!ptr)
+		return;
+
+	/* if the object is not aligned it was clearly not from us */
+	UK_ASSERT(((uintptr_t) ptr & (ALIGN_SIZE - 1)) == 0);
+
+	block = block_from_ptr(ptr);
+	UK_ASSERT(!block_is_free(block));
+
+	block_mark_as_free(block);
+	block = block_merge_prev(t, block);
+	block = block_merge_next(t, block);
+	block_insert(t, block);
+}
+
+static int tlsf_posix_memalign(struct uk_alloc *a, void **memptr,
+			       size_t align, size_t size)
+{
+	struct uk_tlsf *t;
+	struct tlsf_block *block;
+	size_t adjust, gap_minimum, size_with_gap, gap, gap_remain, offset;
+	uintptr_t ptr, aligned;
+
+	UK_ASSERT(a);
+	t = ukalloc2tlsf(a);
+
+	if (((align - 1) & align) != 0
+	    || (align % sizeof(void *)) != 0)
+		return EINVAL;
+
+	/* Leave memptr untouched. See comment in uk_posix_memalign_ifpages. */
+	if (!size)
+		return EINVAL;
+
+	adjust = adjust_request_size(size, ALIGN_SIZE);
+	if (unlikely(!adjust))
+		return ENOMEM;
+
+	if (align <= ALIGN_SIZE) {
+		block = block_locate_free(t, adjust);
+		if (unlikely(!block))
+			return ENOMEM;
+		*memptr = block_prepare_used(t, block, adjust);
+		return 0;
+	}
+
+	/* We need to allocate enough space so that we can split off a free
+	 * block in front of the aligned data area.
+	 */
+	gap_minimum = BLOCK_HDR_LEN + BLOCK_SIZE_MIN;
+	size_with_gap = adjust_request_size(adjust + align + gap_minimum,
+					    ALIGN_SIZE);
+	block = block_locate_free(t, size_with_gap);
+	if (unlikely(!block))
+		return ENOMEM;
+
+	ptr = (uintptr_t) block_to_ptr(block);
+	aligned = ALIGN_UP(ptr, (uintptr_t) align);
+	gap = aligned - ptr;
+
+	/* the gap is too small for a free block, move to next alignment */
+	if (gap && gap < gap_minimum) {
+		gap_remain = gap_minimum - gap;
+		offset = MAX(gap_remain, align);
+		aligned = ALIGN_UP(aligned + offset, (uintptr_t) align);
+		gap = aligned - ptr;
+	}
+
+	if (gap)
+		block = block_trim_free_leading(t, block, gap);
+
+	*memptr = block_prepare_used(t, block, adjust);
+	UK_ASSERT(((uintptr_t) *memptr & (align - 1)) == 0);
+	return 0;
+}
+
+static void *tlsf_realloc(struct uk_alloc *a, void *ptr, size_t size)
+{
+	struct uk_tlsf *t;
+	struct tlsf_block *block, *next;
+	size_t cursize, combined, adjust;
+	void *retptr;
+
+	UK_ASSERT(a);
+	t = ukalloc2tlsf(a);
+
+	if (!ptr)
+		return tlsf_malloc(a, size);
+
+	if (!size) {
+		tlsf_free(a, ptr);
+		return NULL;
+	}
+
+	block = block_from_ptr(ptr);
+	UK_ASSERT(!block_is_free(block));
+
+	adjust = adjust_request_size(size, ALIGN_SIZE);
+	if (unlikely(!adjust)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	cursize = block_size(block);
+	next = block_next(block);
+	combined = cursize + block_size(next) + BLOCK_HDR_LEN;
+
+	if (adjust > cursize && (!block_is_free(next) || adjust > combined)) {
+		/* cannot grow in place */
+		retptr = tlsf_malloc(a, size);
+		if (!retptr)
+			return NULL;
+
+		memcpy(retptr, ptr, MIN(cursize, size));
+		tlsf_free(a, ptr);
+		return retptr;
+	}
+
+	/* grow into the next block if needed */
+	if (adjust > cursize) {
+		block_merge_next(t, block);
+		block_mark_as_used(block);
+	}
+
+	/* return trailing space to the pool */
+	block_trim_used(t, block, adjust);
+	return ptr;
+}
+
+static int tlsf_addmem(struct uk_alloc *a, void *base, size_t len)
+{
+	struct uk_tlsf *t;
+	struct tlsf_block *block, *next;
+	uintptr_t min, max;
+	size_t size;
+
+	UK_ASSERT(a);
+	t = ukalloc2tlsf(a);
+
+	min = ALIGN_UP((uintptr_t) base, ALIGN_SIZE);
+	max = ALIGN_DOWN((uintptr_t) base + len, ALIGN_SIZE);
+
+	/* we need space for one block and the sentinel */
+	if (max < min || max - min < 2 * BLOCK_HDR_LEN + BLOCK_SIZE_MIN) {
+		uk_pr_err("%p: Failed to add memory region %p-%p: Not enough space after applying alignments\n",
+			  a, base, (void *) ((uintptr_t) base + len));
+		return -EINVAL;
+	}
+
+	while (max - min >= 2 * BLOCK_HDR_LEN + BLOCK_SIZE_MIN) {
+		/* blocks are limited in size: split huge regions */
+		size = MIN((size_t) (max - min) - 2 * BLOCK_HDR_LEN,
+			   BLOCK_SIZE_MAX - ALIGN_SIZE);
+
+		uk_pr_debug("%p: Add memory block %p - %p\n",
+			    a, (void *) min,
+			    (void *) (min + size + 2 * BLOCK_HDR_LEN));
+
+		/* the first block of a region has no predecessor */
+		block = (struct tlsf_block *) min;
+		block->prev_phys = NULL;
+		block->size = size | BLOCK_FREE_BIT;
+		block_insert(t, block);
+
+		/* sentinel: zero-sized, used block */
+		next = block_link_next(block);
+		next->size = BLOCK_PREV_FREE_BIT;
+
+		min += size + 2 * BLOCK_HDR_LEN;
+	}
+
+	return 0;
+}
+
+static size_t tlsf_getsize(struct uk_alloc *a __unused, const void *ptr)
+{
+	const struct tlsf_block *block = block_from_ptr(ptr);
+
+	UK_ASSERT(!block_is_free(block));
+	return block_size(block);
+}
+
+#if CONFIG_LIBUKALLOC_IFSTATS
+static ssize_t tlsf_availmem(struct uk_alloc *a)
+{
+	UK_ASSERT(a);
+	return (ssize_t) ukalloc2tlsf(a)->free_bytes;
+}
+#endif
+
+struct uk_alloc *uk_alloctlsf_init(void *base, size_t len)
+{
+	struct uk_alloc *a;
+	struct uk_tlsf *t;
+	size_t metalen;
+	uintptr_t min, max;
+	unsigned int i, j;
+
+	min = ALIGN_UP((uintptr_t) base, ALIGN_SIZE);
+	max = ALIGN_DOWN((uintptr_t) base + len, ALIGN_SIZE);
+	metalen = ALIGN_UP(sizeof(*a) + sizeof(*t), ALIGN_SIZE);
+
+	/* enough space for allocator available? */
+	if (max < min || min + metalen > max) {
+		uk_pr_err("Not enough space for allocator: %"__PRIsz" B required but only %"__PRIuptr" B usable\n",
+			  metalen, (max > min) ? (max - min) : 0);
+		return NULL;
+	}
+
+	a = (struct uk_alloc *) min;
+	uk_pr_info("Initialize TLSF allocator @ 0x%"__PRIuptr", len %"__PRIsz"\n",
+		   (uintptr_t) a, len);
+	memset(a, 0, metalen);
+	t = ukalloc2tlsf(a);
+
+	t->null_block.next_free = &t->null_block;
+	t->null_block.prev_free = &t->null_block;
+	for (i = 0; i < FL_INDEX_COUNT; ++i)
+		for (j = 0; j < SL_INDEX_COUNT; ++j)
+			t->blocks[i][j] = &t->null_block;
+
+	/* use "compat" wrappers for calloc, memalign, palloc and pfree */
+	uk_alloc_init_malloc(a, tlsf_malloc, uk_calloc_compat, tlsf_realloc,
+			     tlsf_free, tlsf_posix_memalign,
+			     uk_memalign_compat, tlsf_addmem);
+	a->getsize = tlsf_getsize;
+#if CONFIG_LIBUKALLOC_IFSTATS
+	a->availmem = tlsf_availmem;
+#endif
+
+	min += metalen;
+	if (max - min >= 2 * BLOCK_HDR_LEN + BLOCK_SIZE_MIN) {
+		/* add left memory - ignore return value */
+		tlsf_addmem(a, (void *) min, (size_t) (max - min));
+	}
+
+	return a;
+}
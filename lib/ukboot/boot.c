@@ -43,9 +43,14 @@
 #include <uk/allocbbuddy.h>
 #elif CONFIG_LIBUKBOOT_INITREGION
 #include <uk/allocregion.h>
+#elif CONFIG_LIBUKBOOT_INITALLOCTLSF
+#include <uk/alloctlsf.h>
 #elif CONFIG_LIBUKBOOT_INITTLSF
 #include <uk/tlsf.h>
 #endif
+#if CONFIG_LIBUKBOOT_INITSLAB
+#include <uk/allocslab.h>
+#endif
 #if CONFIG_LIBUKSCHED
 #include <uk/sched.h>
 #endif
@@ -236,6 +241,8 @@ void ukplat_entry(int argc, char *argv[])
 			a = uk_allocbbuddy_init(md.base, md.len);
 #elif CONFIG_LIBUKBOOT_INITREGION
 			a = uk_allocregion_init(md.base, md.len);
+#elif CONFIG_LIBUKBOOT_INITALLOCTLSF
+			a = uk_alloctlsf_init(md.base, md.len);
 #elif CONFIG_LIBUKBOOT_INITTLSF
 			a = uk_tlsf_init(md.base, md.len);
 #endif
@@ -249,6 +256,16 @@ void ukplat_entry(int argc, char *argv[])
 		rc = ukplat_memallocator_set(a);
 		if (unlikely(rc != 0))
 			UK_CRASH("Could not set the platform memory allocator\n");
+#if CONFIG_LIBUKBOOT_INITSLAB
+		/* serve small objects from slabs on top of the page allocator,
+		 * the platform keeps using the page allocator directly
+		 */
+		uk_pr_info("Initialize slab allocator...\n");
+		if (unlikely(!uk_allocslab_init(a)))
+			uk_pr_warn("Could not initialize slab allocator. Continue with page allocator\n");
+		else
+			a = uk_alloc_get_default();
+#endif
 	}
 #endif
 
@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Network packet generator benchmark
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UK_NETBENCH_H__
+#define __UK_NETBENCH_H__
+
+#include <uk/alloc.h>
+#include <uk/netdev.h>
+#include <uk/arch/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of packets per transmit or receive call */
+#define UK_NETBENCH_MAX_BURST	256
+
+struct uk_netbench;
+
+struct uk_netbench_conf {
+	uint16_t nb_queues;  /* number of queues driven round-robin */
+	uint16_t pkt_len;    /* frame length in bytes (without FCS) */
+	uint16_t burst;      /* packets per transmit/receive call */
+	uint64_t nb_pkts;    /* number of packets to transmit */
+};
+
+struct uk_netbench_result {
+	uint64_t tx_pkts;    /* packets accepted by the transmitting device */
+	uint64_t rx_pkts;    /* packets received */
+	uint64_t rx_bytes;   /* bytes received (frames without FCS) */
+	uint64_t tx_full;    /* transmit calls that did not take all packets */
+	__nsec time;         /* duration of the run */
+	uint64_t cycles;     /* CPU cycles of the run, 0 if not available */
+
+	uint64_t pps;        /* received packets per second */
+	uint64_t bps;        /* received bits per second */
+};
+
+/**
+ * Configures and starts the network devices of a benchmark. The devices
+ * have to be unconfigured. The receive queues are set up with a netbuf
+ * pool for polling (no interrupts).
+ *
+ * @param a
+ *  Allocator for the benchmark state and the netbuf pool.
+ * @param txdev
+ *  Device on which packets are transmitted.
+ * @param rxdev
+ *  Device on which packets are received. It may be `txdev`.
+ * @param nb_queues
+ *  Number of queues that are configured on each device.
+ * @param nb_netbufs
+ *  Number of netbufs in the pool.
+ * @return
+ *  - ERR2PTR(-EINVAL): Invalid parameters or a device was configured.
+ *  - ERR2PTR(-ENOMEM): Out of memory.
+ *  - ERR2PTR(<0): A device could not be configured.
+ *  - Benchmark handle.
+ */
+struct uk_netbench *uk_netbench_create(struct uk_alloc *a,
+				       struct uk_netdev *txdev,
+				       struct uk_netdev *rxdev,
+				       uint16_t nb_queues,
+				       unsigned int nb_netbufs);
+
+/**
+ * Transmits packets on the transmitting device and receives them on the
+ * receiving device. Each round sends a burst on every queue and then
+ * receives a burst on the same queue. After `nb_pkts` were transmitted,
+ * the receive queues are drained. The time and the CPU cycles (on x86_64
+ * with the TSC) are taken for the whole run, so they include allocating,
+ * initializing the Ethernet header and freeing of the netbufs.
+ *
+ * @param b
+ *  Benchmark handle.
+ * @param conf
+ *  Parameters of the run.
+ * @param res
+ *  Result of the run.
+ * @return
+ *  - (0): Success.
+ *  - (-EINVAL): Invalid parameters.
+ *  - (<0): A transmit or receive call failed.
+ */
+int uk_netbench_run(struct uk_netbench *b,
+		    const struct uk_netbench_conf *conf,
+		    struct uk_netbench_result *res);
+
+/**
+ * Prints a benchmark result as a table row.
+ * A NULL result prints the table header.
+ */
+void uk_netbench_print(const struct uk_netbench_conf *conf,
+		       const struct uk_netbench_result *res);
+
+/**
+ * Runs the benchmark for all combinations of the configured queue
+ * counts, burst sizes and frame lengths and prints the results.
+ */
+void uk_netbench_run_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_NETBENCH_H__ */
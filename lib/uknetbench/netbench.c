@@ -0,0 +1,446 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Network packet generator benchmark
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* uknetbench is a pktgen-like benchmark for the uknetdev API. A single
+ * thread transmits bursts of netbufs on one device and receives them on
+ * another one, queue by queue. Netbufs are taken from a netbuf pool and
+ * only the Ethernet header is written, so with the loopback device pairs
+ * of uknetloop the results show the cost of netbuf and uknetdev handling
+ * without any hypervisor or host involvement.
+ *
+ * The clock is read only at the beginning and the end of a run because it
+ * can be expensive (on linuxu it is a system call).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <uk/netbench.h>
+#include <uk/netbuf_pool.h>
+#include <uk/netloop.h>
+#include <uk/plat/time.h>
+#include <uk/essentials.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+
+#define BENCH_PKTS		((uint64_t) CONFIG_LIBUKNETBENCH_PKTS)
+#define BENCH_MAX_LIST		16
+#define BENCH_ETHERTYPE		0x88b5 /* IEEE 802 local experimental */
+#define BENCH_BUFLEN		2048
+#define BENCH_MIN_PKTLEN	UK_ETH_HDR_UNTAGGED_LEN
+
+struct uk_netbench {
+	struct uk_netdev *txdev;
+	struct uk_netdev *rxdev;
+	uint16_t nb_queues;
+	uint16_t max_pkt_len;
+	struct uk_netbuf_pool *pool;
+	__u8 hdr[UK_ETH_HDR_UNTAGGED_LEN];
+	struct uk_netbuf *pkts[UK_NETBENCH_MAX_BURST];
+};
+
+static inline __u64 bench_cycles(void)
+{
+#if defined __X86_64__
+	__u32 lo, hi;
+
+	__asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+	return ((__u64) hi << 32) | lo;
+#else
+	return 0;
+#endif
+}
+
+static int bench_dev_setup(struct uk_netbench *b, struct uk_netdev *dev)
+{
+	struct uk_netdev_conf conf;
+	struct uk_netdev_rxqueue_conf rxq_conf;
+	struct uk_netdev_txqueue_conf txq_conf;
+	uint16_t q;
+	int rc;
+
+	conf.nb_rx_queues = b->nb_queues;
+	conf.nb_tx_queues = b->nb_queues;
+	rc = uk_netdev_configure(dev, &conf);
+	if (rc < 0)
+		return rc;
+
+	for (q = 0; q < b->nb_queues; ++q) {
+		memset(&rxq_conf, 0, sizeof(rxq_conf));
+		rxq_conf.a = uk_alloc_get_default();
+		rxq_conf.alloc_rxpkts = uk_netbuf_pool_alloc_rxpkts;
+		rxq_conf.alloc_rxpkts_argp = uk_netbuf_pool_cache_get(b->pool,
+								      q);
+		rc = uk_netdev_rxq_configure(dev, q, 0, &rxq_conf);
+		if (rc < 0)
+			return rc;
+
+		txq_conf.a = uk_alloc_get_default();
+		rc = uk_netdev_txq_configure(dev, q, 0, &txq_conf);
+		if (rc < 0)
+			return rc;
+	}
+	return uk_netdev_start(dev);
+}
+
+struct uk_netbench *uk_netbench_create(struct uk_alloc *a,
+				       struct uk_netdev *txdev,
+				       struct uk_netdev *rxdev,
+				       uint16_t nb_queues,
+				       unsigned int nb_netbufs)
+{
+	struct uk_netdev_info txinfo, rxinfo;
+	const struct uk_hwaddr *hwaddr;
+	struct uk_netbench *b;
+	uint16_t headroom;
+	int rc;
+
+	UK_ASSERT(a && txdev && rxdev);
+
+	if (nb_queues == 0 || nb_queues > CONFIG_LIBUKNETDEV_MAXNBQUEUES)
+		return ERR2PTR(-EINVAL);
+	if (uk_netdev_state_get(txdev) != UK_NETDEV_UNCONFIGURED
+	    || uk_netdev_state_get(rxdev) != UK_NETDEV_UNCONFIGURED)
+		return ERR2PTR(-EINVAL);
+
+	uk_netdev_info_get(txdev, &txinfo);
+	uk_netdev_info_get(rxdev, &rxinfo);
+	if (nb_queues > MIN(txinfo.max_tx_queues, rxinfo.max_rx_queues))
+		return ERR2PTR(-EINVAL);
+
+	b = uk_calloc(a, 1, sizeof(*b));
+	if (!b)
+		return ERR2PTR(-ENOMEM);
+	b->txdev = txdev;
+	b->rxdev = rxdev;
+	b->nb_queues = nb_queues;
+
+	headroom = ALIGN_UP(MAX(txinfo.nb_encap_tx, rxinfo.nb_encap_rx),
+			    sizeof(void *));
+	b->max_pkt_len = BENCH_BUFLEN - headroom;
+	b->pool = uk_netbuf_pool_create(a, nb_netbufs, BENCH_BUFLEN,
+					headroom, 0);
+	if (!b->pool) {
+		rc = -ENOMEM;
+		goto err_free;
+	}
+
+	rc = bench_dev_setup(b, txdev);
+	if (rc < 0)
+		goto err_free;
+	if (rxdev != txdev) {
+		rc = bench_dev_setup(b, rxdev);
+		if (rc < 0)
+			goto err_free;
+	}
+
+	/* Ethernet header of every generated frame */
+	hwaddr = uk_netdev_hwaddr_get(rxdev);
+	if (hwaddr)
+		memcpy(&b->hdr[0], hwaddr->addr_bytes, UK_ETH_ADDR_LEN);
+	hwaddr = uk_netdev_hwaddr_get(txdev);
+	if (hwaddr)
+		memcpy(&b->hdr[UK_ETH_ADDR_LEN], hwaddr->addr_bytes,
+		       UK_ETH_ADDR_LEN);
+	b->hdr[2 * UK_ETH_ADDR_LEN] = BENCH_ETHERTYPE >> 8;
+	b->hdr[2 * UK_ETH_ADDR_LEN + 1] = BENCH_ETHERTYPE & 0xff;
+	return b;
+
+err_free:
+	/* Configured devices cannot be reset: keep the pool referenced by
+	 * their receive queues
+	 */
+	uk_free(a, b);
+	return ERR2PTR(rc);
+}
+
+static int bench_tx(struct uk_netbench *b, uint16_t q,
+		    const struct uk_netbench_conf *conf, uint16_t count,
+		    struct uk_netbench_result *res)
+{
+	struct uk_netbuf_pool_cache *c = uk_netbuf_pool_cache_get(b->pool, q);
+	struct uk_netbuf **pkts = b->pkts;
+	uint16_t n, i;
+	int rc;
+
+	n = (uint16_t) uk_netbuf_pool_alloc_batch(c, pkts, count);
+	if (unlikely(n == 0))
+		return 0; /* Netbufs are still queued on the receive side */
+	for (i = 0; i < n; ++i) {
+		memcpy(pkts[i]->data, b->hdr, sizeof(b->hdr));
+		pkts[i]->len = conf->pkt_len;
+	}
+
+	i = n;
+	rc = uk_netdev_tx_burst(b->txdev, q, pkts, &i);
+	if (unlikely(rc < 0)) {
+		uk_netbuf_pool_free_batch(c, pkts, n);
+		return rc;
+	}
+	if (!uk_netdev_status_successful(rc))
+		i = 0;
+	if (i < n) {
+		uk_netbuf_pool_free_batch(c, &pkts[i], n - i);
+		res->tx_full++;
+	}
+	res->tx_pkts += i;
+	return 0;
+}
+
+/* Returns the number of received packets or a negative error code */
+static int bench_rx(struct uk_netbench *b, uint16_t q,
+		    const struct uk_netbench_conf *conf,
+		    struct uk_netbench_result *res)
+{
+	struct uk_netbuf_pool_cache *c = uk_netbuf_pool_cache_get(b->pool, q);
+	struct uk_netbuf **pkts = b->pkts;
+	uint16_t n, i;
+	int rc;
+
+	n = conf->burst;
+	rc = uk_netdev_rx_burst(b->rxdev, q, pkts, &n);
+	if (unlikely(rc < 0))
+		return rc;
+	if (!uk_netdev_status_successful(rc))
+		return 0;
+
+	for (i = 0; i < n; ++i)
+		res->rx_bytes += pkts[i]->len;
+	res->rx_pkts += n;
+	uk_netbuf_pool_free_batch(c, pkts, n);
+	return n;
+}
+
+int uk_netbench_run(struct uk_netbench *b,
+		    const struct uk_netbench_conf *conf,
+		    struct uk_netbench_result *res)
+{
+	__nsec start;
+	__u64 cycles;
+	uint16_t q;
+	int rc = 0;
+
+	UK_ASSERT(b && conf && res);
+
+	if (conf->nb_queues == 0 || conf->nb_queues > b->nb_queues
+	    || conf->burst == 0 || conf->burst > UK_NETBENCH_MAX_BURST
+	    || conf->pkt_len < BENCH_MIN_PKTLEN
+	    || conf->pkt_len > b->max_pkt_len)
+		return -EINVAL;
+
+	memset(res, 0, sizeof(*res));
+	start = ukplat_monotonic_clock();
+	cycles = bench_cycles();
+
+	while (res->tx_pkts < conf->nb_pkts) {
+		for (q = 0; q < conf->nb_queues; ++q) {
+			rc = bench_tx(b, q, conf,
+				      MIN((uint64_t) conf->burst,
+					  conf->nb_pkts - res->tx_pkts),
+				      res);
+			if (unlikely(rc < 0))
+				goto out;
+			rc = bench_rx(b, q, conf, res);
+			if (unlikely(rc < 0))
+				goto out;
+		}
+	}
+
+	/* Drain the receive queues */
+	for (q = 0; q < conf->nb_queues; ++q) {
+		do {
+			rc = bench_rx(b, q, conf, res);
+		} while (rc > 0);
+		if (unlikely(rc < 0))
+			goto out;
+	}
+	rc = 0;
+
+out:
+	res->cycles = bench_cycles() - cycles;
+	res->time = ukplat_monotonic_clock() - start;
+	if (res->time > 0) {
+		res->pps = res->rx_pkts * UKARCH_NSEC_PER_SEC / res->time;
+		/* Scale with microseconds to avoid an overflow */
+		res->bps = res->rx_bytes * 8 * 1000000
+			   / MAX(ukarch_time_nsec_to_usec(res->time), 1UL);
+	}
+	return rc;
+}
+
+void uk_netbench_print(const struct uk_netbench_conf *conf,
+		       const struct uk_netbench_result *res)
+{
+	if (!res) {
+		printf(" %6s %5s %6s %10s %10s %8s %8s %10s %10s\n",
+		       "queues", "burst", "length", "tx pkts", "rx pkts",
+		       "Mpps", "Gbit/s", "cyc/pkt", "ns/pkt");
+		return;
+	}
+
+	printf(" %6u %5u %6u %10llu %10llu %5llu.%02llu %5llu.%02llu",
+	       conf->nb_queues, conf->burst, conf->pkt_len,
+	       (unsigned long long) res->tx_pkts,
+	       (unsigned long long) res->rx_pkts,
+	       (unsigned long long) (res->pps / 1000000),
+	       (unsigned long long) (res->pps / 10000 % 100),
+	       (unsigned long long) (res->bps / 1000000000),
+	       (unsigned long long) (res->bps / 10000000 % 100));
+	if (res->cycles && res->rx_pkts)
+		printf(" %8llu.%llu",
+		       (unsigned long long) (res->cycles / res->rx_pkts),
+		       (unsigned long long) (res->cycles * 10 / res->rx_pkts
+					     % 10));
+	else
+		printf(" %10s", "-");
+	if (res->rx_pkts)
+		printf(" %8llu.%llu\n",
+		       (unsigned long long) (res->time / res->rx_pkts),
+		       (unsigned long long) (res->time * 10 / res->rx_pkts
+					     % 10));
+	else
+		printf(" %10s\n", "-");
+}
+
+/* Parses a comma-separated list of numbers; returns the number of values */
+static unsigned int bench_parse_list(const char *str, unsigned long *val,
+				     unsigned int max)
+{
+	unsigned int n = 0;
+	char *end;
+
+	while (*str != '\0' && n < max) {
+		val[n] = strtoul(str, &end, 10);
+		if (end == str)
+			break;
+		if (val[n] > 0)
+			n++;
+		str = end;
+		while (*str == ',' || *str == ' ')
+			str++;
+	}
+	return n;
+}
+
+static int bench_devs_get(struct uk_netdev **txdev, struct uk_netdev **rxdev)
+{
+	struct uk_netdev *dev, *peer;
+	unsigned int i;
+
+	*txdev = NULL;
+	*rxdev = NULL;
+	if (CONFIG_LIBUKNETBENCH_TXDEV >= 0) {
+		*txdev = uk_netdev_get(CONFIG_LIBUKNETBENCH_TXDEV);
+	} else {
+		/* First loopback device with an unconfigured peer */
+		for (i = 0; i < uk_netdev_count(); ++i) {
+			dev = uk_netdev_get(i);
+			peer = uk_netloop_peer_get(dev);
+			if (peer && uk_netdev_state_get(dev)
+					== UK_NETDEV_UNCONFIGURED) {
+				*txdev = dev;
+				*rxdev = peer;
+				break;
+			}
+		}
+	}
+	if (CONFIG_LIBUKNETBENCH_RXDEV >= 0)
+		*rxdev = uk_netdev_get(CONFIG_LIBUKNETBENCH_RXDEV);
+	else if (*txdev && !*rxdev)
+		*rxdev = uk_netloop_peer_get(*txdev);
+
+	if (!*txdev || !*rxdev)
+		return -ENODEV;
+	return 0;
+}
+
+void uk_netbench_run_all(void)
+{
+	unsigned long queues[BENCH_MAX_LIST], bursts[BENCH_MAX_LIST];
+	unsigned long lens[BENCH_MAX_LIST];
+	unsigned int nb_queues, nb_bursts, nb_lens, i, j, k;
+	struct uk_netbench_result res;
+	struct uk_netbench_conf conf;
+	struct uk_netdev *txdev, *rxdev;
+	struct uk_netbench *b;
+	unsigned long max_queues = 0;
+	int rc;
+
+	nb_queues = bench_parse_list(CONFIG_LIBUKNETBENCH_QUEUES, queues,
+				     BENCH_MAX_LIST);
+	nb_bursts = bench_parse_list(CONFIG_LIBUKNETBENCH_BURSTS, bursts,
+				     BENCH_MAX_LIST);
+	nb_lens = bench_parse_list(CONFIG_LIBUKNETBENCH_PKTLENS, lens,
+				   BENCH_MAX_LIST);
+	for (i = 0; i < nb_queues; ++i)
+		max_queues = MAX(max_queues, queues[i]);
+
+	rc = bench_devs_get(&txdev, &rxdev);
+	if (rc < 0) {
+		uk_pr_err("No network devices to benchmark\n");
+		return;
+	}
+	b = uk_netbench_create(uk_alloc_get_default(), txdev, rxdev,
+			       (uint16_t) max_queues,
+			       CONFIG_LIBUKNETBENCH_POOLSIZE);
+	if (PTRISERR(b)) {
+		uk_pr_err("Failed to set up netdev%u -> netdev%u with %lu queues: %d\n",
+			  uk_netdev_id_get(txdev), uk_netdev_id_get(rxdev),
+			  max_queues, PTR2ERR(b));
+		return;
+	}
+
+	printf("netdev%u (%s) -> netdev%u (%s):\n",
+	       uk_netdev_id_get(txdev), uk_netdev_drv_name_get(txdev),
+	       uk_netdev_id_get(rxdev), uk_netdev_drv_name_get(rxdev));
+	uk_netbench_print(NULL, NULL);
+
+	conf.nb_pkts = BENCH_PKTS;
+	for (i = 0; i < nb_queues; ++i) {
+		for (j = 0; j < nb_bursts; ++j) {
+			for (k = 0; k < nb_lens; ++k) {
+				conf.nb_queues = (uint16_t) queues[i];
+				conf.burst = (uint16_t) bursts[j];
+				conf.pkt_len = (uint16_t) lens[k];
+				rc = uk_netbench_run(b, &conf, &res);
+				if (rc < 0) {
+					uk_pr_err("Run with %u queues, burst %u, length %u failed: %d\n",
+						  conf.nb_queues, conf.burst,
+						  conf.pkt_len, rc);
+					continue;
+				}
+				uk_netbench_print(&conf, &res);
+			}
+		}
+	}
+}
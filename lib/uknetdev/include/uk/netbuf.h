@@ -100,7 +100,42 @@ typedef void (*uk_netbuf_dtor_t)(struct uk_netbuf *);
  * by independent memory allocations. uk_netbuf_alloc_buf() and
  * uk_netbuf_prepare_buf() are placing all these three regions into a single
  * allocation.
+ *
+ * Offload meta data (`flags`, `csum_start`, `csum_offset`, `gso_size`,
+ * `header_len`) is only evaluated on the first netbuf of a chain. Offsets are
+ * relative to `*data` of this netbuf. Offloads may only be requested on
+ * transmission when the device advertises the according UK_FEATURE_TX_*
+ * capability (see uk_netdev_info_get()).
+ */
+/** RX: The checksums of the packet were validated by the device. */
+#define UK_NETBUF_F_DATA_VALID_BIT	0
+#define UK_NETBUF_F_DATA_VALID		(1 << UK_NETBUF_F_DATA_VALID_BIT)
+/**
+ * TX: The device has to compute the checksum from `csum_start` to the end
+ * of the packet and store it at `csum_start + csum_offset`.
+ * RX: The checksum was not computed (e.g., packet from a local peer); the
+ * packet data is valid.
  */
+#define UK_NETBUF_F_PARTIAL_CSUM_BIT	1
+#define UK_NETBUF_F_PARTIAL_CSUM	(1 << UK_NETBUF_F_PARTIAL_CSUM_BIT)
+/**
+ * The packet is a large TCP/IPv4, TCP/IPv6 or UDP segment that is split
+ * into frames of `gso_size` payload bytes each, with headers of
+ * `header_len` bytes.
+ */
+#define UK_NETBUF_F_GSO_TCPV4_BIT	2
+#define UK_NETBUF_F_GSO_TCPV4		(1 << UK_NETBUF_F_GSO_TCPV4_BIT)
+#define UK_NETBUF_F_GSO_TCPV6_BIT	3
+#define UK_NETBUF_F_GSO_TCPV6		(1 << UK_NETBUF_F_GSO_TCPV6_BIT)
+#define UK_NETBUF_F_GSO_UDP_BIT		4
+#define UK_NETBUF_F_GSO_UDP		(1 << UK_NETBUF_F_GSO_UDP_BIT)
+/** The TCP segment has the ECN CWR flag set (combined with GSO_TCPV*) */
+#define UK_NETBUF_F_GSO_ECN_BIT		5
+#define UK_NETBUF_F_GSO_ECN		(1 << UK_NETBUF_F_GSO_ECN_BIT)
+#define UK_NETBUF_F_GSO_MASK		(UK_NETBUF_F_GSO_TCPV4		\
+					 | UK_NETBUF_F_GSO_TCPV6	\
+					 | UK_NETBUF_F_GSO_UDP)
+
 struct uk_netbuf {
 	struct uk_netbuf *next;
 	struct uk_netbuf *prev;
@@ -109,6 +144,12 @@ struct uk_netbuf {
 	uint16_t len;          /**< Payload length (should be <= buflen). */
 	__atomic refcount;     /**< Reference counter */
 
+	uint8_t flags;         /**< Offload flags (UK_NETBUF_F_*) */
+	uint16_t csum_start;   /**< Start of checksumming (PARTIAL_CSUM) */
+	uint16_t csum_offset;  /**< Checksum offset from csum_start */
+	uint16_t gso_size;     /**< Payload bytes per segment (GSO) */
+	uint16_t header_len;   /**< Length of L2-L4 headers (GSO) */
+
 	void *priv;            /**< Reference to user-provided private data */
 
 	void *buf;             /**< Start address of contiguous buffer. */
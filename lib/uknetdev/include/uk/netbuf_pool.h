@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Netbuf pools
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __UK_NETBUF_POOL__
+#define __UK_NETBUF_POOL__
+
+#include <stdint.h>
+#include <uk/config.h>
+#include <uk/netbuf.h>
+#include <uk/alloc.h>
+#include <uk/allocpool.h>
+#include <uk/arch/lcpu.h>
+#include <uk/essentials.h>
+
+/**
+ * Netbuf pools provide fixed-size netbufs that are carved out of a single
+ * ukallocpool. Each pool object has the following layout:
+ *
+ *          *obj -> +----------------------+ \
+ *                  |   struct uk_netbuf   |  | meta data
+ *                  |  private meta data   |  | (cache line aligned)
+ *          *buf -> +----------------------+ /
+ *                  |      HEAD ROOM       | \
+ *         *data -> +----------------------+  | buffer area
+ *                  |     PACKET DATA      |  | (cache line aligned)
+ *                  +----------------------+ /
+ *
+ * The netbufs are allocated through per-queue caches that are refilled
+ * from and flushed to the pool in batches. uk_netbuf_free() returns a
+ * pool netbuf to the pool object list without involving any general
+ * purpose allocator.
+ * Please note that neither the pool nor its caches are protected against
+ * concurrent access. A cache should only be used from the context that
+ * drives the corresponding queue (e.g., the dispatcher thread).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct uk_netbuf_pool;
+
+/**
+ * Per-queue cache of netbufs that are taken from a pool.
+ */
+struct uk_netbuf_pool_cache {
+	struct uk_netbuf_pool *pool;
+	unsigned int count;               /**< Number of cached netbufs */
+	struct uk_netbuf *nb[CONFIG_LIBUKNETDEV_NETBUFPOOL_CACHESIZE];
+} __align(CACHE_LINE_SIZE);
+
+/**
+ * Creates a netbuf pool.
+ *
+ * @param a
+ *   Allocator on which the pool is allocated.
+ * @param count
+ *   Number of netbufs in the pool.
+ * @param buflen
+ *   Size of the buffer area of each netbuf (including headroom).
+ * @param headroom
+ *   Number of bytes reserved as headroom in each buffer area.
+ *   `headroom` has to be smaller or equal to `buflen`.
+ * @param privlen
+ *   Length of the private data area of each netbuf.
+ * @return
+ *   - (NULL): Allocation failed
+ *   - Pointer to the netbuf pool
+ */
+struct uk_netbuf_pool *uk_netbuf_pool_create(struct uk_alloc *a,
+					     unsigned int count,
+					     size_t buflen, uint16_t headroom,
+					     size_t privlen);
+
+/**
+ * Destroys a netbuf pool. The queue caches are flushed to the pool.
+ * Note: Please make sure that all other netbufs are returned to the pool
+ * before destroying it.
+ *
+ * @param p
+ *   Netbuf pool to destroy.
+ */
+void uk_netbuf_pool_destroy(struct uk_netbuf_pool *p);
+
+/**
+ * Returns the cache of a pool that is dedicated to a queue.
+ *
+ * @param p
+ *   Netbuf pool.
+ * @param queue_id
+ *   Queue index, has to be smaller than CONFIG_LIBUKNETDEV_MAXNBQUEUES.
+ * @return
+ *   Pointer to the queue cache.
+ */
+struct uk_netbuf_pool_cache *uk_netbuf_pool_cache_get(struct uk_netbuf_pool *p,
+						      uint16_t queue_id);
+
+/**
+ * Returns the number of netbufs that are available in a pool. Netbufs that
+ * are kept in queue caches are not counted.
+ *
+ * @param p
+ *   Netbuf pool.
+ * @return
+ *   Number of available netbufs.
+ */
+unsigned int uk_netbuf_pool_availcount(struct uk_netbuf_pool *p);
+
+/**
+ * Allocates multiple netbufs with a queue cache. The cache is refilled from
+ * its pool when it runs empty.
+ * Each netbuf is initialized like with uk_netbuf_alloc_buf(): `m->len` is 0
+ * and `m->data` points to the first byte after the headroom.
+ *
+ * @param c
+ *   Queue cache.
+ * @param m
+ *   Array that is filled with the allocated netbufs.
+ * @param count
+ *   Number of netbufs requested.
+ * @return
+ *   Number of allocated netbufs, in range [0, count].
+ */
+unsigned int uk_netbuf_pool_alloc_batch(struct uk_netbuf_pool_cache *c,
+					struct uk_netbuf *m[],
+					unsigned int count);
+
+/**
+ * Allocates one netbuf with a queue cache.
+ *
+ * @param c
+ *   Queue cache.
+ * @return
+ *   - (NULL): The pool is exhausted
+ *   - Initialized uk_netbuf
+ */
+static inline struct uk_netbuf *uk_netbuf_pool_alloc(
+						struct uk_netbuf_pool_cache *c)
+{
+	struct uk_netbuf *m;
+
+	if (unlikely(!uk_netbuf_pool_alloc_batch(c, &m, 1)))
+		return NULL;
+	return m;
+}
+
+/**
+ * Releases a reference of multiple single netbufs that were allocated from
+ * the pool of a queue cache. Netbufs whose reference count reaches zero are
+ * disconnected from their chain, destructed, and put back to the cache.
+ * When the cache overflows, half of it is returned to the pool.
+ *
+ * @param c
+ *   Queue cache.
+ * @param m
+ *   Array of netbufs to release.
+ * @param count
+ *   Number of netbufs in `m`.
+ */
+void uk_netbuf_pool_free_batch(struct uk_netbuf_pool_cache *c,
+			       struct uk_netbuf *m[], unsigned int count);
+
+/**
+ * Receive buffer allocator for uk_netdev_rxq_configure()
+ * (`rx_conf->alloc_rxpkts`). Set `rx_conf->alloc_rxpkts_argp` to the
+ * queue cache returned by uk_netbuf_pool_cache_get().
+ * The length of the returned netbufs covers their whole buffer area behind
+ * the headroom, which drivers use as receive buffer size.
+ *
+ * @param argp
+ *   Queue cache (`struct uk_netbuf_pool_cache *`).
+ * @param pkts
+ *   Array that is filled with the allocated netbufs.
+ * @param count
+ *   Number of netbufs requested.
+ * @return
+ *   Number of allocated netbufs, in range [0, count].
+ */
+uint16_t uk_netbuf_pool_alloc_rxpkts(void *argp, struct uk_netbuf *pkts[],
+				     uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_NETBUF_POOL__ */
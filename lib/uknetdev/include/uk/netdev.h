@@ -38,6 +38,12 @@
 #include <uk/netdev_core.h>
 #include <uk/assert.h>
 #include <uk/errptr.h>
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+#include <uk/netdev_capture.h>
+#endif
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+#include <uk/netdev_filter.h>
+#endif
 
 /**
  * Unikraft Network API
@@ -225,6 +231,27 @@ int uk_netdev_rxq_configure(struct uk_netdev *dev, uint16_t queue_id,
 			    uint16_t nb_desc,
 			    struct uk_netdev_rxqueue_conf *rx_conf);
 
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+/**
+ * Retrieves the counters of the dispatcher thread of a receive queue.
+ * They show how often the dispatcher switched between interrupt and
+ * polling mode (see `poll_budget` of `struct uk_netdev_rxqueue_conf`).
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of a configured receive queue.
+ * @param stats
+ *   A pointer to a structure that is filled out with the counters.
+ * @return
+ *   - (0): Success, stats is filled out.
+ *   - (-EINVAL): The receive queue has no dispatcher thread.
+ */
+int uk_netdev_rxq_dispatcher_stats_get(struct uk_netdev *dev,
+				       uint16_t queue_id,
+				       struct uk_netdev_dispatcher_stats *stats);
+#endif
+
 /**
  * Query device transmit queue capabilities.
  * Information that is useful for device queue initialization (e.g.,
@@ -388,6 +415,11 @@ static inline int uk_netdev_rxq_intr_enable(struct uk_netdev *dev,
 
 	if (unlikely(!dev->ops->rxq_intr_enable))
 		return -ENOTSUP;
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	dev->_data->rxq_intr[queue_id] = 1;
+	if (unlikely(dev->_data->steering))
+		return _uk_netdev_filter_rxq_intr_enable(dev, queue_id);
+#endif
 	return dev->ops->rxq_intr_enable(dev, dev->_rx_queue[queue_id]);
 }
 
@@ -416,9 +448,176 @@ static inline int uk_netdev_rxq_intr_disable(struct uk_netdev *dev,
 
 	if (unlikely(!dev->ops->rxq_intr_disable))
 		return -ENOTSUP;
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	dev->_data->rxq_intr[queue_id] = 0;
+#endif
 	return dev->ops->rxq_intr_disable(dev, dev->_rx_queue[queue_id]);
 }
 
+#ifdef CONFIG_LIBUKNETDEV_STATS
+/**
+ * Retrieves the statistics of a network device.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param stats
+ *   A pointer to a structure that is filled out with the counters of
+ *   each queue.
+ * @return
+ *   - (0): Success, stats is filled out.
+ */
+int uk_netdev_stats_get(struct uk_netdev *dev, struct uk_netdev_stats *stats);
+
+/**
+ * Resets the statistics of a network device to zero.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ */
+void uk_netdev_stats_reset(struct uk_netdev *dev);
+
+/* Total number of bytes of a netbuf chain */
+static inline uint64_t _uk_netdev_pktlen(struct uk_netbuf *pkt)
+{
+	struct uk_netbuf *iter;
+	uint64_t len = 0;
+
+	UK_NETBUF_CHAIN_FOREACH(iter, pkt)
+		len += iter->len;
+	return len;
+}
+
+static inline void _uk_netdev_rxq_stats_update(struct uk_netdev *dev,
+					       uint16_t queue_id, int rc,
+					       struct uk_netbuf **pkt,
+					       uint16_t cnt)
+{
+	struct uk_netdev_queue_stats *s = &dev->_data->stats.rxq[queue_id];
+	uint16_t i;
+
+	if (unlikely(rc < 0)) {
+		s->errors++;
+		return;
+	}
+	if (unlikely(rc & UK_NETDEV_STATUS_UNDERRUN))
+		s->ring_full++;
+	if (!(rc & UK_NETDEV_STATUS_SUCCESS))
+		return;
+
+	s->packets += cnt;
+	for (i = 0; i < cnt; ++i)
+		s->bytes += _uk_netdev_pktlen(pkt[i]);
+}
+
+static inline void _uk_netdev_txq_stats_update(struct uk_netdev *dev,
+					       uint16_t queue_id, int rc,
+					       uint16_t req, uint16_t cnt,
+					       uint64_t len)
+{
+	struct uk_netdev_queue_stats *s = &dev->_data->stats.txq[queue_id];
+
+	if (unlikely(rc < 0)) {
+		s->errors++;
+		return;
+	}
+	if (unlikely(cnt < req))
+		s->ring_full++;
+	s->packets += cnt;
+	s->bytes += len;
+}
+#endif /* CONFIG_LIBUKNETDEV_STATS */
+
+/* Accounts packets that are handed out by a receive function */
+static inline void _uk_netdev_rx_account(struct uk_netdev *dev __maybe_unused,
+					 uint16_t queue_id __maybe_unused,
+					 int rc __maybe_unused,
+					 struct uk_netbuf **pkt __maybe_unused,
+					 uint16_t cnt __maybe_unused)
+{
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+	if (rc > 0)
+		dev->_data->rxq_handler[queue_id].rx_pkts += cnt;
+#endif
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	_uk_netdev_rxq_stats_update(dev, queue_id, rc, pkt, cnt);
+#endif
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+	if (unlikely(dev->_data->capture) && rc > 0 && cnt > 0)
+		_uk_netdev_capture_rx(dev, queue_id, pkt, cnt);
+#endif
+}
+
+/* Receives one packet from the driver */
+static inline int _uk_netdev_rx_one(struct uk_netdev *dev, uint16_t queue_id,
+				    struct uk_netbuf **pkt)
+{
+	int rc;
+
+	rc = dev->rx_one(dev, dev->_rx_queue[queue_id], pkt);
+	_uk_netdev_rx_account(dev, queue_id, rc, pkt,
+			      (rc > 0 && (rc & UK_NETDEV_STATUS_SUCCESS))
+			      ? 1 : 0);
+	return rc;
+}
+
+/* Receives multiple packets from the driver */
+static inline int _uk_netdev_rx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				      struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	int rc;
+
+	rc = dev->rx_burst(dev, dev->_rx_queue[queue_id], pkt, cnt);
+	_uk_netdev_rx_account(dev, queue_id, rc, pkt, (rc > 0) ? *cnt : 0);
+	return rc;
+}
+
+/* Transmits one packet without capturing it */
+static inline int _uk_netdev_tx_one(struct uk_netdev *dev, uint16_t queue_id,
+				    struct uk_netbuf *pkt)
+{
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	uint64_t len;
+	int rc;
+
+	/* The packet is owned by the driver after a successful call */
+	len = _uk_netdev_pktlen(pkt);
+	rc = dev->tx_one(dev, dev->_tx_queue[queue_id], pkt);
+	_uk_netdev_txq_stats_update(dev, queue_id, rc, 1,
+				    (rc & UK_NETDEV_STATUS_SUCCESS) ? 1 : 0,
+				    len);
+	return rc;
+#else
+	return dev->tx_one(dev, dev->_tx_queue[queue_id], pkt);
+#endif
+}
+
+/* Transmits multiple packets without capturing them */
+static inline int _uk_netdev_tx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				      struct uk_netbuf **pkt, uint16_t *cnt)
+{
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	uint16_t i, req;
+	uint64_t len;
+	int rc;
+
+	/* Packets are owned by the driver after they were put to the ring,
+	 * so we sum up all lengths in advance and subtract the ones of the
+	 * packets that were left to the caller.
+	 */
+	for (i = 0, len = 0; i < *cnt; ++i)
+		len += _uk_netdev_pktlen(pkt[i]);
+	req = *cnt;
+	rc = dev->tx_burst(dev, dev->_tx_queue[queue_id], pkt, cnt);
+	if (rc >= 0)
+		for (i = *cnt; i < req; ++i)
+			len -= _uk_netdev_pktlen(pkt[i]);
+	_uk_netdev_txq_stats_update(dev, queue_id, rc, req, *cnt, len);
+	return rc;
+#else
+	return dev->tx_burst(dev, dev->_tx_queue[queue_id], pkt, cnt);
+#endif
+}
+
 /**
  * Receive one packet and re-program used receive descriptors. In order to avoid
  * race conditions, queue interrupts have to be off while executing this
@@ -465,7 +664,11 @@ static inline int uk_netdev_rx_one(struct uk_netdev *dev, uint16_t queue_id,
 	UK_ASSERT(!PTRISERR(dev->_rx_queue[queue_id]));
 	UK_ASSERT(pkt);
 
-	return dev->rx_one(dev, dev->_rx_queue[queue_id], pkt);
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	if (unlikely(dev->_data->steering))
+		return _uk_netdev_filter_rx_one(dev, queue_id, pkt);
+#endif
+	return _uk_netdev_rx_one(dev, queue_id, pkt);
 }
 
 /**
@@ -504,7 +707,102 @@ static inline int uk_netdev_tx_one(struct uk_netdev *dev, uint16_t queue_id,
 	UK_ASSERT(!PTRISERR(dev->_tx_queue[queue_id]));
 	UK_ASSERT(pkt);
 
-	return dev->tx_one(dev, dev->_tx_queue[queue_id], pkt);
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+	if (unlikely(dev->_data->capture))
+		return _uk_netdev_capture_tx_one(dev, queue_id, pkt);
+#endif
+	return _uk_netdev_tx_one(dev, queue_id, pkt);
+}
+
+/**
+ * Receive multiple packets and re-program used receive descriptors once for
+ * the whole burst. The same rules regarding queue interrupts as for
+ * uk_netdev_rx_one() apply: interrupts are enabled again as soon as the
+ * queue was drained.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of the receive queue to receive from.
+ *   The value must be in the range [0, nb_rx_queue - 1] previously supplied
+ *   to uk_netdev_configure().
+ * @param pkt
+ *   Array of netbuf pointers that is filled with the received packets.
+ * @param cnt
+ *   On entry, the number of entries in `pkt` (must be greater than 0).
+ *   On return, the number of packets that were received.
+ * @return
+ *   - (>=0): Positive value with status flags
+ *     - UK_NETDEV_STATUS_SUCCESS: At least one packet was received.
+ *     - UK_NETDEV_STATUS_MORE: Indicates that more received packets are
+ *        available on the receive queue.
+ *        This flag may only be set together with UK_NETDEV_STATUS_SUCCESS.
+ *     - UK_NETDEV_STATUS_UNDERRUN: Informs that some available slots of the
+ *        receive queue could not be programmed with a receive buffer.
+ *   - (<0): Negative value with error code from driver, no packet is returned.
+ */
+static inline int uk_netdev_rx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				     struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->rx_burst);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	UK_ASSERT(dev->_data->state == UK_NETDEV_RUNNING);
+	UK_ASSERT(!PTRISERR(dev->_rx_queue[queue_id]));
+	UK_ASSERT(pkt);
+	UK_ASSERT(cnt && *cnt > 0);
+
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	if (unlikely(dev->_data->steering))
+		return _uk_netdev_filter_rx_burst(dev, queue_id, pkt, cnt);
+#endif
+	return _uk_netdev_rx_burst(dev, queue_id, pkt, cnt);
+}
+
+/**
+ * Transmit multiple packets. Drivers notify the device only once per
+ * burst, which is considerably cheaper than calling uk_netdev_tx_one()
+ * for each packet on paravirtualized devices.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of the transmit queue to send on.
+ *   The value must be in the range [0, nb_tx_queue - 1] previously supplied
+ *   to uk_netdev_configure().
+ * @param pkt
+ *   Array of netbufs to send. Packets are free'd by the driver after
+ *   sending was successfully finished by the device.
+ * @param cnt
+ *   On entry, the number of packets in `pkt` (must be greater than 0).
+ *   On return, the number of packets that were put to the transmit queue.
+ *   These are always the first packets of `pkt`; the remaining ones are
+ *   still owned by the caller.
+ * @return
+ *   - (>=0): Positive value with status flags
+ *     - UK_NETDEV_STATUS_SUCCESS: At least one packet was put to the
+ *        transmit queue.
+ *     - UK_NETDEV_STATUS_MORE: Indicates there is still at least one
+ *        descriptor available for a subsequent transmission.
+ *        This flag may only be set together with UK_NETDEV_STATUS_SUCCESS.
+ *   - (<0): Negative value with error code from driver, no packet was sent.
+ */
+static inline int uk_netdev_tx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				     struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->tx_burst);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	UK_ASSERT(dev->_data->state == UK_NETDEV_RUNNING);
+	UK_ASSERT(!PTRISERR(dev->_tx_queue[queue_id]));
+	UK_ASSERT(pkt);
+	UK_ASSERT(cnt && *cnt > 0);
+
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+	if (unlikely(dev->_data->capture))
+		return _uk_netdev_capture_tx_burst(dev, queue_id, pkt, cnt);
+#endif
+	return _uk_netdev_tx_burst(dev, queue_id, pkt, cnt);
 }
 
 /**
@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Packet capture for network devices
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __UK_NETDEV_CAPTURE__
+#define __UK_NETDEV_CAPTURE__
+
+#include <stdint.h>
+#include <uk/config.h>
+#include <uk/netbuf.h>
+#include <uk/netdev_core.h>
+#include <uk/alloc.h>
+#include <uk/sched.h>
+
+/**
+ * Packets that pass the receive and transmit functions of a network device
+ * are captured without copying them: A reference is taken on the netbuf and
+ * handed over to a background writer thread that emits the packets in
+ * pcapng format to a file, or mirrors them to another network device.
+ * Because the packet data is not copied, changes that the application
+ * applies to a received packet before the writer processed it become
+ * visible in the capture.
+ * Capturing is enabled per device; as long as it is not started, the
+ * overhead in the packet path is a single predictable branch.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Packet directions, used for uk_netdev_capture_conf.dirs */
+#define UK_NETDEV_CAPTURE_RX (0x1)
+#define UK_NETDEV_CAPTURE_TX (0x2)
+
+/**
+ * Function type for capture filters.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The receive or transmit queue of the packet.
+ * @param dir
+ *   The direction of the packet (UK_NETDEV_CAPTURE_RX/TX).
+ * @param pkt
+ *   The packet. The filter must not modify it.
+ * @param arg
+ *   Argument that was provided together with the filter.
+ * @return
+ *   - (0): Packet is not captured.
+ *   - (!=0): Packet is captured.
+ */
+typedef int (*uk_netdev_capture_filter_t)(struct uk_netdev *dev,
+					  uint16_t queue_id, int dir,
+					  const struct uk_netbuf *pkt,
+					  void *arg);
+
+/**
+ * Capture configuration. Exactly one of `path` and `mirror` is set.
+ */
+struct uk_netdev_capture_conf {
+	/* Allocator for the capture state and for mirrored packets */
+	struct uk_alloc *a;
+	/* Scheduler for the writer thread */
+	struct uk_sched *s;
+
+	/* pcapng file that is created (requires vfscore) */
+	const char *path;
+	/* Running network device to which captured packets are sent */
+	struct uk_netdev *mirror;
+	/* Configured transmit queue of `mirror` that is used by the writer
+	 * thread. The queue is owned by the capture until it is stopped:
+	 * transmit functions are not thread-safe, so the application must not
+	 * send on this queue in the meantime.
+	 */
+	uint16_t mirror_queue_id;
+
+	/* Directions to capture (UK_NETDEV_CAPTURE_RX/TX), 0 for both */
+	int dirs;
+	/* Maximum number of bytes that are captured per packet, 0 for 65535 */
+	uint32_t snaplen;
+	/* Number of packets that can be pending for the writer,
+	 * 0 for CONFIG_LIBUKNETDEV_CAPTURE_QUEUELEN
+	 */
+	uint16_t nb_pending;
+
+	/* Optional filter that selects the packets to capture */
+	uk_netdev_capture_filter_t filter;
+	void *filter_arg;
+};
+
+struct uk_netdev_capture_stats {
+	uint64_t captured; /* Packets handed over to the writer */
+	uint64_t dropped;  /* Packets skipped because the writer lagged */
+	uint64_t written;  /* Packets written to the file or mirror */
+	uint64_t errors;   /* Packets lost due to file or mirror errors */
+	uint64_t txfull;   /* Packets lost because the mirror queue was full */
+};
+
+/**
+ * Starts capturing packets of a network device. The device can already be
+ * running; capturing takes effect for the next packet.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param conf
+ *   The capture configuration. The structure is not referenced after the
+ *   call, but `path` and `filter_arg` have to stay valid.
+ * @return
+ *   - (0): Success, capturing is started.
+ *   - (-EBUSY): A capture is already running on `dev`, or
+ *     `mirror_queue_id` is used by another capture.
+ *   - (-EINVAL): Invalid configuration.
+ *   - (-ENOTSUP): File capture requested but vfscore is not available.
+ *   - (<0): Error code from creating the file or writer thread.
+ */
+int uk_netdev_capture_start(struct uk_netdev *dev,
+			    const struct uk_netdev_capture_conf *conf);
+
+/**
+ * Stops capturing packets of a network device. Pending packets are written
+ * out and the file is closed before the function returns. The function
+ * must not be called from interrupt context.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param stats
+ *   Optional, filled out with the final statistics of the capture.
+ * @return
+ *   - (0): Success, capturing is stopped.
+ *   - (-ENODEV): No capture is running on `dev`.
+ */
+int uk_netdev_capture_stop(struct uk_netdev *dev,
+			   struct uk_netdev_capture_stats *stats);
+
+/**
+ * Replaces the filter of a running capture.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param filter
+ *   The new filter, `NULL` captures all packets.
+ * @param arg
+ *   Argument that is passed to `filter`.
+ * @return
+ *   - (0): Success.
+ *   - (-ENODEV): No capture is running on `dev`.
+ */
+int uk_netdev_capture_filter_set(struct uk_netdev *dev,
+				 uk_netdev_capture_filter_t filter, void *arg);
+
+/**
+ * Retrieves the statistics of a running capture.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param stats
+ *   Filled out with the current counters.
+ * @return
+ *   - (0): Success.
+ *   - (-ENODEV): No capture is running on `dev`.
+ */
+int uk_netdev_capture_stats_get(struct uk_netdev *dev,
+				struct uk_netdev_capture_stats *stats);
+
+/* Internal functions, called by the packet functions in <uk/netdev.h>
+ * when a capture is running on the device
+ */
+void _uk_netdev_capture_rx(struct uk_netdev *dev, uint16_t queue_id,
+			   struct uk_netbuf **pkt, uint16_t cnt);
+int _uk_netdev_capture_tx_one(struct uk_netdev *dev, uint16_t queue_id,
+			      struct uk_netbuf *pkt);
+int _uk_netdev_capture_tx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				struct uk_netbuf **pkt, uint16_t *cnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_NETDEV_CAPTURE__ */
@@ -68,6 +68,13 @@ extern "C" {
 #endif /* CONFIG_UK_NETDEV_SCRATCH_SIZE */
 
 struct uk_netdev;
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+struct uk_netdev_capture;
+#endif
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+struct uk_netdev_filter;
+struct uk_netdev_steering;
+#endif
 UK_TAILQ_HEAD(uk_netdev_list, struct uk_netdev);
 
 /**
@@ -135,6 +142,26 @@ struct uk_hwaddr {
 #define uk_netdev_rxintr_supported(feature)	\
 	(feature & (UK_FEATURE_RXQ_INTR_AVAILABLE))
 
+/**
+ * Offload capabilities. See UK_NETBUF_F_* for the according netbuf meta data.
+ */
+/* The device completes partial checksums on transmission */
+#define UK_FEATURE_TX_CSUM_BIT		    2
+#define UK_FEATURE_TX_CSUM		(1UL << UK_FEATURE_TX_CSUM_BIT)
+/* Received packets may be flagged with DATA_VALID or PARTIAL_CSUM */
+#define UK_FEATURE_RX_CSUM_BIT		    3
+#define UK_FEATURE_RX_CSUM		(1UL << UK_FEATURE_RX_CSUM_BIT)
+/* The device segments large TCP/IPv4 and TCP/IPv6 packets on transmission */
+#define UK_FEATURE_TX_TSO4_BIT		    4
+#define UK_FEATURE_TX_TSO4		(1UL << UK_FEATURE_TX_TSO4_BIT)
+#define UK_FEATURE_TX_TSO6_BIT		    5
+#define UK_FEATURE_TX_TSO6		(1UL << UK_FEATURE_TX_TSO6_BIT)
+/* Large (unsegmented) TCP/IPv4 and TCP/IPv6 packets may be received */
+#define UK_FEATURE_RX_TSO4_BIT		    6
+#define UK_FEATURE_RX_TSO4		(1UL << UK_FEATURE_RX_TSO4_BIT)
+#define UK_FEATURE_RX_TSO6_BIT		    7
+#define UK_FEATURE_RX_TSO6		(1UL << UK_FEATURE_RX_TSO6_BIT)
+
 /**
  * A structure used to describe network device capabilities.
  */
@@ -201,6 +228,7 @@ enum uk_netdev_state {
  * The extra information can available in one of the following formats:
  * - *_NINT16: Network-order raw int (4 bytes)
  * - *_STR: Null-terminated string
+ * - *_XSTATS: `struct uk_netdev_xstats`
  */
 enum uk_netdev_einfo_type {
 	/* IPv4 address and mask */
@@ -220,8 +248,60 @@ enum uk_netdev_einfo_type {
 	/* IPv4 Secondary DNS */
 	UK_NETDEV_IPV4_DNS1_NINT16,
 	UK_NETDEV_IPV4_DNS1_STR,
+
+	/* Driver-specific statistics */
+	UK_NETDEV_XSTATS,
 };
 
+/**
+ * A named driver-specific counter.
+ */
+struct uk_netdev_xstat {
+	const char *name;     /**< Name of the counter */
+	uint16_t queue_id;    /**< Queue the counter relates to */
+	uint64_t value;
+};
+
+/**
+ * Driver-specific statistics as returned for UK_NETDEV_XSTATS. The
+ * values are updated by the driver on each query.
+ */
+struct uk_netdev_xstats {
+	unsigned int count;                 /**< Number of counters */
+	const struct uk_netdev_xstat *xstat;
+};
+
+#ifdef CONFIG_LIBUKNETDEV_STATS
+/**
+ * Statistics of a receive or transmit queue. Packets, bytes, errors, and
+ * ring stalls are counted by libuknetdev for every receive and transmit
+ * call, interrupts by the receive event dispatching. Drivers account for
+ * device notifications and packets they drop.
+ */
+struct uk_netdev_queue_stats {
+	uint64_t packets;    /**< Received/transmitted packets */
+	uint64_t bytes;      /**< Received/transmitted bytes */
+	uint64_t drops;      /**< Packets dropped by the driver */
+	uint64_t errors;     /**< Calls that failed with an error */
+	/** RX: buffers could not be refilled (UK_NETDEV_STATUS_UNDERRUN),
+	 *  TX: packets were rejected because the ring was full
+	 */
+	uint64_t ring_full;
+	uint64_t notifies;   /**< Notifications sent to the device */
+	uint64_t interrupts; /**< Queue interrupts */
+	uint64_t filtered;   /**< RX: Packets dropped by the receive filter */
+	uint64_t steered;    /**< RX: Packets moved to another queue */
+};
+
+/**
+ * Statistics of a network device.
+ */
+struct uk_netdev_stats {
+	struct uk_netdev_queue_stats rxq[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	struct uk_netdev_queue_stats txq[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+};
+#endif
+
 /**
  * Function type used for queue event callbacks.
  *
@@ -267,6 +347,17 @@ struct uk_netdev_rxqueue_conf {
 	void *alloc_rxpkts_argp;             /**< Argument for alloc_rxpkts */
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
 	struct uk_sched *s;               /**< Scheduler for dispatcher. */
+
+	/**
+	 * Adaptive interrupt/poll mode of the dispatcher (0 disables it).
+	 * After an event, the dispatcher masks the queue interrupt and calls
+	 * the callback in a loop. The CPU is yielded every `poll_budget`
+	 * callback rounds.
+	 */
+	uint16_t poll_budget;
+	/**< Busy-poll window: time without received packets after which
+	 *   the dispatcher re-arms the queue interrupt. */
+	__nsec poll_idle;
 #endif
 };
 
@@ -368,6 +459,24 @@ typedef int (*uk_netdev_tx_one_t)(struct uk_netdev *dev,
 				  struct uk_netdev_tx_queue *queue,
 				  struct uk_netbuf *pkt);
 
+/**
+ * Driver callback type to retrieve multiple packets from a RX queue.
+ * `cnt` holds the size of `pkt` on entry and the number of received
+ * packets on return.
+ */
+typedef int (*uk_netdev_rx_burst_t)(struct uk_netdev *dev,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkt, uint16_t *cnt);
+
+/**
+ * Driver callback type to submit multiple packets to a TX queue.
+ * `cnt` holds the number of packets in `pkt` on entry and the number of
+ * enqueued packets on return.
+ */
+typedef int (*uk_netdev_tx_burst_t)(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkt, uint16_t *cnt);
+
 /**
  * A structure containing the functions exported by a driver.
  */
@@ -405,6 +514,19 @@ struct uk_netdev_ops {
  * @internal
  * Event handler configuration (internal to libuknetdev)
  */
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+/**
+ * Counters of a receive queue dispatcher thread.
+ */
+struct uk_netdev_dispatcher_stats {
+	uint64_t wakeups; /**< Wake-ups by queue events */
+	uint64_t polls;   /**< Callback rounds in polling mode */
+	uint64_t to_poll; /**< Switches from interrupt to polling mode */
+	uint64_t to_intr; /**< Switches from polling to interrupt mode */
+	uint64_t yields;  /**< CPU yields due to an exhausted poll budget */
+};
+#endif
+
 struct uk_netdev_event_handler {
 	uk_netdev_queue_event_t callback;
 	void                    *cookie;
@@ -416,6 +538,11 @@ struct uk_netdev_event_handler {
 	struct uk_thread    *dispatcher; /**< dispatcher thread */
 	char                *dispatcher_name; /**< reference to thread name */
 	struct uk_sched     *dispatcher_s;    /**< Scheduler for dispatcher. */
+
+	uint16_t            poll_budget; /**< adaptive mode poll budget */
+	__nsec              poll_idle;   /**< adaptive mode busy-poll window */
+	uint64_t            rx_pkts;     /**< packets received on the queue */
+	struct uk_netdev_dispatcher_stats stats;
 #endif
 };
 
@@ -431,6 +558,25 @@ struct uk_netdev_data {
 
 	const uint16_t       id;    /**< ID is assigned during registration */
 	const char           *drv_name;
+
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	struct uk_netdev_stats stats;
+#endif
+#ifdef CONFIG_LIBUKNETDEV_CAPTURE
+	/* Set while packets of this device are captured */
+	struct uk_netdev_capture * volatile capture;
+	/* Transmit queues reserved by a capture that mirrors to this device */
+	uint8_t txq_mirror[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+#endif
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	/* Receive filters, see <uk/netdev_filter.h> */
+	struct uk_netdev_filter * volatile
+			     rxq_filter[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	/* Set as soon as a filter was attached to any queue */
+	struct uk_netdev_steering *steering;
+	/* Receive queues with interrupts enabled by the user */
+	uint8_t rxq_intr[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+#endif
 };
 
 struct uk_netdev_einfo {
@@ -447,13 +593,18 @@ struct uk_netdev_einfo {
  * registering the netdev. They change during device life time. Packet RX/TX
  * functions are added directly to this structure for performance reasons.
  * It prevents another indirection to ops.
+ * The burst functions (tx_burst, rx_burst) are optional for drivers. If a
+ * driver does not provide them, libuknetdev installs a fallback that calls
+ * tx_one or rx_one for each packet.
  */
 struct uk_netdev {
 	/** Packet transmission. */
 	uk_netdev_tx_one_t          tx_one; /* by driver */
+	uk_netdev_tx_burst_t        tx_burst; /* by driver (optional) */
 
 	/** Packet reception. */
 	uk_netdev_rx_one_t          rx_one; /* by driver */
+	uk_netdev_rx_burst_t        rx_burst; /* by driver (optional) */
 
 	/** Pointer to API-internal state data. */
 	struct uk_netdev_data       *_data;
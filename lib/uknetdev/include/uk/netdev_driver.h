@@ -34,6 +34,9 @@
 
 #include <uk/netdev_core.h>
 #include <uk/assert.h>
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+#include <uk/netdev_filter.h>
+#endif
 
 /**
  * Unikraft network driver API.
@@ -85,6 +88,10 @@ static inline void uk_netdev_drv_rx_event(struct uk_netdev *dev,
 
 	rxq_handler = &dev->_data->rxq_handler[queue_id];
 
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	dev->_data->stats.rxq[queue_id].interrupts++;
+#endif
+
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
 	uk_semaphore_up(&rxq_handler->events);
 #else
@@ -93,6 +100,69 @@ static inline void uk_netdev_drv_rx_event(struct uk_netdev *dev,
 #endif
 }
 
+/* Verdicts of uk_netdev_drv_rx_filter() */
+#define UK_NETDEV_RX_PASS    0 /* Hand the packet out to the API user */
+#define UK_NETDEV_RX_DROP    1 /* Recycle the packet buffers to the ring */
+#define UK_NETDEV_RX_STOLEN  2 /* libuknetdev took over the packet */
+
+/**
+ * Applies the receive filter of a queue to a packet that was just
+ * dequeued from the device (see <uk/netdev_filter.h>). Drivers call this
+ * before handing out a packet with their receive functions.
+ *
+ * @param dev
+ *   Unikraft network device that received the packet
+ * @param queue_id
+ *   receive queue ID on which the packet was received
+ * @param pkt
+ *   The received packet
+ * @return
+ *   - UK_NETDEV_RX_PASS: The packet is handed out as usual.
+ *   - UK_NETDEV_RX_DROP: The packet is unwanted. The driver should put
+ *     its buffers back to the receive ring or free it.
+ *   - UK_NETDEV_RX_STOLEN: The packet was steered to another queue, the
+ *     driver must not touch it anymore.
+ */
+static inline int uk_netdev_drv_rx_filter(struct uk_netdev *dev __maybe_unused,
+					  uint16_t queue_id __maybe_unused,
+					  struct uk_netbuf *pkt __maybe_unused)
+{
+#ifdef CONFIG_LIBUKNETDEV_FILTER
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+
+	if (unlikely(dev->_data->rxq_filter[queue_id]))
+		return _uk_netdev_rx_filter(dev, queue_id, pkt);
+#endif
+	return UK_NETDEV_RX_PASS;
+}
+
+/**
+ * Adds a value to a statistics counter of a receive or transmit queue
+ * (see `struct uk_netdev_queue_stats`). Drivers use these helpers to account
+ * for device notifications and dropped packets. Without
+ * CONFIG_LIBUKNETDEV_STATS, they compile to nothing.
+ *
+ * @param dev
+ *   Unikraft network device
+ * @param queue_id
+ *   Queue ID to which the counter relates to
+ * @param field
+ *   Name of the counter in `struct uk_netdev_queue_stats`
+ * @param val
+ *   Value to add
+ */
+#ifdef CONFIG_LIBUKNETDEV_STATS
+#define uk_netdev_drv_rxq_stats_add(dev, queue_id, field, val)		\
+	((dev)->_data->stats.rxq[(queue_id)].field += (val))
+#define uk_netdev_drv_txq_stats_add(dev, queue_id, field, val)		\
+	((dev)->_data->stats.txq[(queue_id)].field += (val))
+#else
+#define uk_netdev_drv_rxq_stats_add(dev, queue_id, field, val)		\
+	do {} while (0)
+#define uk_netdev_drv_txq_stats_add(dev, queue_id, field, val)		\
+	do {} while (0)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
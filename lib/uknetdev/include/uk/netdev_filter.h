@@ -0,0 +1,232 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Receive packet filters for network devices
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __UK_NETDEV_FILTER__
+#define __UK_NETDEV_FILTER__
+
+#include <stdint.h>
+#include <uk/config.h>
+#include <uk/netbuf.h>
+#include <uk/netdev_core.h>
+#include <uk/alloc.h>
+
+/**
+ * Receive filters are classic BPF programs that are attached to a receive
+ * queue. Drivers run them right after a packet was dequeued from the
+ * device, before it is handed out by uk_netdev_rx_one()/uk_netdev_rx_burst().
+ * The return value of a program decides about the packet:
+ *   - UK_NETDEV_FILTER_DROP (0): The packet is dropped and its buffer is
+ *     recycled to the device ring without involving the application.
+ *   - UK_NETDEV_FILTER_STEER(q): The packet is moved to receive queue `q`
+ *     of the same device and returned by the next receive call on that
+ *     queue. If interrupts are enabled on `q`, its event callback is
+ *     triggered.
+ *   - Any other value: The packet is accepted.
+ * Programs produced by tools that return the snap length for accepted
+ * packets (e.g., `tcpdump -dd`) can be used without changes.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Instruction classes */
+#define UK_BPF_LD    0x00
+#define UK_BPF_LDX   0x01
+#define UK_BPF_ST    0x02
+#define UK_BPF_STX   0x03
+#define UK_BPF_ALU   0x04
+#define UK_BPF_JMP   0x05
+#define UK_BPF_RET   0x06
+#define UK_BPF_MISC  0x07
+#define UK_BPF_CLASS(code) ((code) & 0x07)
+
+/* Load and store sizes */
+#define UK_BPF_W     0x00
+#define UK_BPF_H     0x08
+#define UK_BPF_B     0x10
+#define UK_BPF_SIZE(code) ((code) & 0x18)
+
+/* Load and store modes */
+#define UK_BPF_IMM   0x00
+#define UK_BPF_ABS   0x20
+#define UK_BPF_IND   0x40
+#define UK_BPF_MEM   0x60
+#define UK_BPF_LEN   0x80
+#define UK_BPF_MSH   0xa0
+#define UK_BPF_MODE(code) ((code) & 0xe0)
+
+/* ALU and jump operations */
+#define UK_BPF_ADD   0x00
+#define UK_BPF_SUB   0x10
+#define UK_BPF_MUL   0x20
+#define UK_BPF_DIV   0x30
+#define UK_BPF_OR    0x40
+#define UK_BPF_AND   0x50
+#define UK_BPF_LSH   0x60
+#define UK_BPF_RSH   0x70
+#define UK_BPF_NEG   0x80
+#define UK_BPF_MOD   0x90
+#define UK_BPF_XOR   0xa0
+#define UK_BPF_JA    0x00
+#define UK_BPF_JEQ   0x10
+#define UK_BPF_JGT   0x20
+#define UK_BPF_JGE   0x30
+#define UK_BPF_JSET  0x40
+#define UK_BPF_OP(code) ((code) & 0xf0)
+
+/* Operand sources */
+#define UK_BPF_K     0x00
+#define UK_BPF_X     0x08
+#define UK_BPF_SRC(code) ((code) & 0x08)
+
+/* Return values */
+#define UK_BPF_A     0x10
+#define UK_BPF_RVAL(code) ((code) & 0x18)
+
+/* Register transfers */
+#define UK_BPF_TAX   0x00
+#define UK_BPF_TXA   0x80
+#define UK_BPF_MISCOP(code) ((code) & 0xf8)
+
+/* Number of scratch memory words */
+#define UK_BPF_MEMWORDS 16
+/* Maximum number of instructions of a program */
+#define UK_BPF_MAXINSNS 4096
+
+/**
+ * A classic BPF instruction (same layout as `struct bpf_insn`/`struct
+ * sock_filter`)
+ */
+struct uk_bpf_insn {
+	uint16_t code;
+	uint8_t  jt;
+	uint8_t  jf;
+	uint32_t k;
+};
+
+#define UK_BPF_STMT(code, k) \
+	{ (uint16_t) (code), 0, 0, (uint32_t) (k) }
+#define UK_BPF_JUMP(code, k, jt, jf) \
+	{ (uint16_t) (code), (uint8_t) (jt), (uint8_t) (jf), (uint32_t) (k) }
+
+/* Program return values */
+#define UK_NETDEV_FILTER_DROP      (0x0U)
+#define UK_NETDEV_FILTER_ACCEPT    (0xffffffffU)
+#define UK_NETDEV_FILTER_STEER(q)  (0xfffe0000U | (uint16_t) (q))
+#define UK_NETDEV_FILTER_IS_STEER(ret) (((ret) & 0xffff0000U) == 0xfffe0000U)
+#define UK_NETDEV_FILTER_STEER_QUEUE(ret) ((uint16_t) ((ret) & 0xffffU))
+
+struct uk_netdev_filter;
+
+/**
+ * Validates a classic BPF program and creates a filter from it. Programs
+ * are accepted when they only jump forward, stay within their bounds,
+ * use valid scratch memory words, do not divide by a constant zero, and
+ * end with a return instruction; so they always terminate.
+ *
+ * @param a
+ *   Allocator for the filter.
+ * @param insns
+ *   The instructions of the program. They are copied.
+ * @param len
+ *   Number of instructions, in range [1, UK_BPF_MAXINSNS].
+ * @return
+ *   - (!PTRISERR): Reference to the filter.
+ *   - (-EINVAL): The program is invalid.
+ *   - (-ENOMEM): Out of memory.
+ */
+struct uk_netdev_filter *uk_netdev_filter_create(struct uk_alloc *a,
+						 const struct uk_bpf_insn *insns,
+						 uint16_t len);
+
+/**
+ * Releases a filter. It must not be attached to a queue anymore.
+ *
+ * @param filter
+ *   The filter.
+ */
+void uk_netdev_filter_destroy(struct uk_netdev_filter *filter);
+
+/**
+ * Runs a filter on a packet.
+ *
+ * @param filter
+ *   The filter.
+ * @param pkt
+ *   The packet, may be a netbuf chain.
+ * @return
+ *   The return value of the program. Loads beyond the end of the packet
+ *   and divisions by zero terminate the program with
+ *   UK_NETDEV_FILTER_DROP.
+ */
+uint32_t uk_netdev_filter_run(const struct uk_netdev_filter *filter,
+			      const struct uk_netbuf *pkt);
+
+/**
+ * Attaches a filter to a receive queue or detaches the current one.
+ * The same filter can be attached to several queues. Packets can only be
+ * steered to queues that were configured when a filter was attached.
+ * After the function returned, the previous filter is not used anymore
+ * for packets of this queue. The function must not be called from
+ * interrupt context.
+ *
+ * @param dev
+ *   The Unikraft Network Device.
+ * @param queue_id
+ *   The index of a configured receive queue.
+ * @param filter
+ *   The filter, `NULL` detaches the current filter.
+ * @return
+ *   - (0): Success.
+ *   - (-EINVAL): The queue is not configured.
+ *   - (-ENOMEM): Out of memory for the steering backlogs.
+ */
+int uk_netdev_rxq_filter_set(struct uk_netdev *dev, uint16_t queue_id,
+			     struct uk_netdev_filter *filter);
+
+/* Internal functions, called by the packet functions in <uk/netdev.h> and
+ * <uk/netdev_driver.h> while filters are used on a device
+ */
+int _uk_netdev_rx_filter(struct uk_netdev *dev, uint16_t queue_id,
+			 struct uk_netbuf *pkt);
+int _uk_netdev_filter_rx_one(struct uk_netdev *dev, uint16_t queue_id,
+			     struct uk_netbuf **pkt);
+int _uk_netdev_filter_rx_burst(struct uk_netdev *dev, uint16_t queue_id,
+			       struct uk_netbuf **pkt, uint16_t *cnt);
+int _uk_netdev_filter_rxq_intr_enable(struct uk_netdev *dev,
+				      uint16_t queue_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_NETDEV_FILTER__ */
@@ -52,6 +52,7 @@ void uk_netbuf_init_indir(struct uk_netbuf *m,
 	m->buflen = buflen;
 	m->data   = (void *) ((uintptr_t) buf + headroom);
 	m->len    = 0;
+	m->flags  = 0;
 	m->prev   = NULL;
 	m->next   = NULL;
 
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Netbuf pools
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <uk/netbuf_pool.h>
+#include <uk/assert.h>
+#include <uk/print.h>
+
+struct uk_netbuf_pool {
+	struct uk_netbuf_pool_cache cache[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+
+	struct uk_allocpool *ap;
+	struct uk_alloc *ap_a;   /**< uk_alloc interface of `ap` */
+	size_t meta_len;         /**< netbuf and priv, cache line aligned */
+	size_t buflen;
+	size_t privlen;
+	uint16_t headroom;
+	struct uk_alloc *a;      /**< Allocator used for the pool */
+};
+
+#define NETBUF_POOL_CACHESIZE CONFIG_LIBUKNETDEV_NETBUFPOOL_CACHESIZE
+
+static inline void _netbuf_pool_init(struct uk_netbuf_pool *p,
+				     struct uk_netbuf *m)
+{
+	uk_netbuf_init_indir(m,
+			     (void *) ((__uptr) m + p->meta_len),
+			     p->buflen,
+			     p->headroom,
+			     p->privlen > 0 ? (void *) ((__uptr) m + sizeof(*m))
+					    : NULL,
+			     NULL);
+
+	/* uk_netbuf_free() returns the netbuf directly to the pool */
+	m->_a = p->ap_a;
+	m->_b = m;
+}
+
+struct uk_netbuf_pool *uk_netbuf_pool_create(struct uk_alloc *a,
+					     unsigned int count,
+					     size_t buflen, uint16_t headroom,
+					     size_t privlen)
+{
+	struct uk_netbuf_pool *p;
+	unsigned int i;
+
+	UK_ASSERT(a);
+	UK_ASSERT(count > 0);
+	UK_ASSERT(buflen > 0);
+	UK_ASSERT(headroom <= buflen);
+
+	p = uk_memalign(a, CACHE_LINE_SIZE, sizeof(*p));
+	if (!p)
+		return NULL;
+
+	p->a        = a;
+	p->meta_len = ALIGN_UP(sizeof(struct uk_netbuf) + privlen,
+			       CACHE_LINE_SIZE);
+	p->buflen   = ALIGN_UP(buflen, CACHE_LINE_SIZE);
+	p->privlen  = privlen;
+	p->headroom = headroom;
+
+	p->ap = uk_allocpool_alloc(a, count, p->meta_len + p->buflen,
+				   CACHE_LINE_SIZE);
+	if (!p->ap) {
+		uk_free(a, p);
+		return NULL;
+	}
+	p->ap_a = uk_allocpool2ukalloc(p->ap);
+
+	for (i = 0; i < CONFIG_LIBUKNETDEV_MAXNBQUEUES; ++i) {
+		p->cache[i].pool  = p;
+		p->cache[i].count = 0;
+	}
+
+	uk_pr_debug("Created netbuf pool %p: %u netbufs with %"__PRIsz
+		    " bytes buffer area\n", p, count, p->buflen);
+	return p;
+}
+
+void uk_netbuf_pool_destroy(struct uk_netbuf_pool *p)
+{
+	unsigned int i;
+
+	UK_ASSERT(p);
+
+	for (i = 0; i < CONFIG_LIBUKNETDEV_MAXNBQUEUES; ++i) {
+		uk_allocpool_return_batch(p->ap, (void **) p->cache[i].nb,
+					  p->cache[i].count);
+		p->cache[i].count = 0;
+	}
+	uk_allocpool_free(p->ap);
+	uk_free(p->a, p);
+}
+
+struct uk_netbuf_pool_cache *uk_netbuf_pool_cache_get(struct uk_netbuf_pool *p,
+						      uint16_t queue_id)
+{
+	UK_ASSERT(p);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+
+	return &p->cache[queue_id];
+}
+
+unsigned int uk_netbuf_pool_availcount(struct uk_netbuf_pool *p)
+{
+	UK_ASSERT(p);
+
+	return uk_allocpool_availcount(p->ap);
+}
+
+unsigned int uk_netbuf_pool_alloc_batch(struct uk_netbuf_pool_cache *c,
+					struct uk_netbuf *m[],
+					unsigned int count)
+{
+	struct uk_netbuf_pool *p;
+	unsigned int i;
+
+	UK_ASSERT(c);
+	UK_ASSERT(c->pool);
+	UK_ASSERT(m);
+
+	p = c->pool;
+	for (i = 0; i < count; ++i) {
+		if (unlikely(!c->count)) {
+			c->count = uk_allocpool_take_batch(p->ap,
+							   (void **) c->nb,
+							   NETBUF_POOL_CACHESIZE);
+			if (unlikely(!c->count))
+				break;
+		}
+		m[i] = c->nb[--c->count];
+		_netbuf_pool_init(p, m[i]);
+	}
+	return i;
+}
+
+void uk_netbuf_pool_free_batch(struct uk_netbuf_pool_cache *c,
+			       struct uk_netbuf *m[], unsigned int count)
+{
+	struct uk_netbuf_pool *p;
+	unsigned int i;
+
+	UK_ASSERT(c);
+	UK_ASSERT(c->pool);
+	UK_ASSERT(m);
+
+	p = c->pool;
+	for (i = 0; i < count; ++i) {
+		UK_ASSERT(m[i]);
+		UK_ASSERT(m[i]->_a == p->ap_a);
+
+		if (uk_refcount_release(&m[i]->refcount) != 1)
+			continue;
+
+		uk_netbuf_disconnect(m[i]);
+		if (m[i]->dtor)
+			m[i]->dtor(m[i]);
+
+		if (unlikely(c->count == NETBUF_POOL_CACHESIZE)) {
+			c->count -= NETBUF_POOL_CACHESIZE / 2;
+			uk_allocpool_return_batch(p->ap,
+						  (void **) &c->nb[c->count],
+						  NETBUF_POOL_CACHESIZE / 2);
+		}
+		c->nb[c->count++] = m[i];
+	}
+}
+
+uint16_t uk_netbuf_pool_alloc_rxpkts(void *argp, struct uk_netbuf *pkts[],
+				     uint16_t count)
+{
+	uint16_t i, cnt;
+
+	cnt = (uint16_t) uk_netbuf_pool_alloc_batch(
+		(struct uk_netbuf_pool_cache *) argp, pkts, count);
+
+	/* Drivers take the size of a receive buffer from its length */
+	for (i = 0; i < cnt; ++i)
+		pkts[i]->len = uk_netbuf_tailroom(pkts[i]);
+	return cnt;
+}
@@ -38,6 +38,9 @@
 #include <uk/netdev.h>
 #include <uk/print.h>
 #include <uk/libparam.h>
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+#include <uk/plat/time.h>
+#endif
 
 struct uk_netdev_list uk_netdev_list =
 	UK_TAILQ_HEAD_INITIALIZER(uk_netdev_list);
@@ -132,6 +135,64 @@ static struct uk_netdev_einfo *_alloc_einfo(struct uk_alloc *a)
 	return _einfo;
 }
 
+/*
+ * Fallback burst functions for drivers that implement only single packet
+ * operations
+ */
+static int _tx_burst_one(struct uk_netdev *dev,
+			 struct uk_netdev_tx_queue *queue,
+			 struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	int status = 0x0;
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < *cnt; ++i) {
+		rc = dev->tx_one(dev, queue, pkt[i]);
+		if (unlikely(rc < 0)) {
+			if (i == 0)
+				return rc;
+			break;
+		}
+		status = rc;
+		if (!uk_netdev_status_more(rc)) {
+			if (uk_netdev_status_successful(rc))
+				++i;
+			break;
+		}
+	}
+
+	*cnt = i;
+	return (i > 0) ? (status | UK_NETDEV_STATUS_SUCCESS) : status;
+}
+
+static int _rx_burst_one(struct uk_netdev *dev,
+			 struct uk_netdev_rx_queue *queue,
+			 struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	int status = 0x0;
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < *cnt; ++i) {
+		rc = dev->rx_one(dev, queue, &pkt[i]);
+		if (unlikely(rc < 0)) {
+			if (i == 0)
+				return rc;
+			break;
+		}
+		status = (status & UK_NETDEV_STATUS_UNDERRUN) | rc;
+		if (!uk_netdev_status_more(rc)) {
+			if (uk_netdev_status_successful(rc))
+				++i;
+			break;
+		}
+	}
+
+	*cnt = i;
+	return (i > 0) ? (status | UK_NETDEV_STATUS_SUCCESS) : status;
+}
+
 int uk_netdev_drv_register(struct uk_netdev *dev, struct uk_alloc *a,
 			   const char *drv_name)
 {
@@ -155,6 +216,11 @@ int uk_netdev_drv_register(struct uk_netdev *dev, struct uk_alloc *a,
 	UK_ASSERT(dev->rx_one);
 	UK_ASSERT(dev->tx_one);
 
+	if (!dev->rx_burst)
+		dev->rx_burst = _rx_burst_one;
+	if (!dev->tx_burst)
+		dev->tx_burst = _tx_burst_one;
+
 	dev->_data = _alloc_data(a, netdev_count,  drv_name);
 	if (!dev->_data)
 		return -ENOMEM;
@@ -263,13 +329,34 @@ const void *uk_netdev_einfo_get(struct uk_netdev *dev,
 	UK_ASSERT(dev);
 	UK_ASSERT(dev->ops);
 
-	if (dev->_einfo)
+	/* Driver-specific statistics are always provided by the driver */
+	if (dev->_einfo && einfo != UK_NETDEV_XSTATS)
 		return _netdev_einfo_get(dev, einfo);
 	else if (dev->ops->einfo_get)
 		return dev->ops->einfo_get(dev, einfo);
 	return NULL;
 }
 
+#ifdef CONFIG_LIBUKNETDEV_STATS
+int uk_netdev_stats_get(struct uk_netdev *dev, struct uk_netdev_stats *stats)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+	UK_ASSERT(stats);
+
+	*stats = dev->_data->stats;
+	return 0;
+}
+
+void uk_netdev_stats_reset(struct uk_netdev *dev)
+{
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+
+	memset(&dev->_data->stats, 0, sizeof(dev->_data->stats));
+}
+#endif
+
 int uk_netdev_rxq_info_get(struct uk_netdev *dev, uint16_t queue_id,
 			   struct uk_netdev_queue_info *queue_info)
 {
@@ -332,6 +419,66 @@ int uk_netdev_configure(struct uk_netdev *dev,
 }
 
 #ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+/*
+ * Adaptive mode: The queue interrupt stays masked and the callback is
+ * called in a loop for as long as it keeps receiving packets. As soon as
+ * no packet was received for `poll_idle` nanoseconds, the interrupt is
+ * re-armed and the dispatcher goes back to sleep. Every `poll_budget`
+ * rounds the CPU is yielded so that polling does not starve other threads.
+ */
+static void _dispatcher_poll(struct uk_netdev_event_handler *handler)
+{
+	__nsec idle_since;
+	uint64_t rx_pkts;
+	uint16_t budget;
+	int rc;
+
+	rc = uk_netdev_rxq_intr_disable(handler->dev, handler->queue_id);
+	if (unlikely(rc < 0)) {
+		/* The driver cannot mask the queue, stay in interrupt mode */
+		handler->callback(handler->dev,
+				  handler->queue_id,
+				  handler->cookie);
+		return;
+	}
+	handler->stats.to_poll++;
+
+	budget = handler->poll_budget;
+	idle_since = ukplat_monotonic_clock();
+	for (;;) {
+		rx_pkts = handler->rx_pkts;
+		handler->callback(handler->dev,
+				  handler->queue_id,
+				  handler->cookie);
+		handler->stats.polls++;
+
+		if (handler->rx_pkts != rx_pkts) {
+			idle_since = ukplat_monotonic_clock();
+		} else if (ukplat_monotonic_clock() - idle_since
+			   >= handler->poll_idle) {
+			/* Events signaled while polling are stale now */
+			while (uk_semaphore_down_try(&handler->events))
+				;
+			rc = uk_netdev_rxq_intr_enable(handler->dev,
+						       handler->queue_id);
+			if (rc != 1)
+				break;
+
+			/* Packets arrived in between, continue polling */
+			uk_netdev_rxq_intr_disable(handler->dev,
+						   handler->queue_id);
+			idle_since = ukplat_monotonic_clock();
+		}
+
+		if (--budget == 0) {
+			handler->stats.yields++;
+			uk_sched_yield();
+			budget = handler->poll_budget;
+		}
+	}
+	handler->stats.to_intr++;
+}
+
 static void _dispatcher(void *arg)
 {
 	struct uk_netdev_event_handler *handler =
@@ -342,6 +489,12 @@ static void _dispatcher(void *arg)
 
 	for (;;) {
 		uk_semaphore_down(&handler->events);
+		handler->stats.wakeups++;
+
+		if (handler->poll_budget) {
+			_dispatcher_poll(handler);
+			continue;
+		}
 		handler->callback(handler->dev,
 				  handler->queue_id,
 				  handler->cookie);
@@ -374,6 +527,8 @@ static int _create_event_handler(uk_netdev_queue_event_t callback,
 
 	h->dev = dev;
 	h->queue_id = queue_id;
+	h->rx_pkts = 0;
+	memset(&h->stats, 0, sizeof(h->stats));
 	uk_semaphore_init(&h->events, 0);
 	h->dispatcher_s = s;
 
@@ -452,6 +607,10 @@ int uk_netdev_rxq_configure(struct uk_netdev *dev, uint16_t queue_id,
 				    &dev->_data->rxq_handler[queue_id]);
 	if (err)
 		goto err_out;
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+	dev->_data->rxq_handler[queue_id].poll_budget = rx_conf->poll_budget;
+	dev->_data->rxq_handler[queue_id].poll_idle = rx_conf->poll_idle;
+#endif
 
 	dev->_rx_queue[queue_id] = dev->ops->rxq_configure(dev, queue_id,
 							   nb_desc, rx_conf);
@@ -470,6 +629,27 @@ err_out:
 	return err;
 }
 
+#ifdef CONFIG_LIBUKNETDEV_DISPATCHERTHREADS
+int uk_netdev_rxq_dispatcher_stats_get(struct uk_netdev *dev,
+				       uint16_t queue_id,
+				       struct uk_netdev_dispatcher_stats *stats)
+{
+	struct uk_netdev_event_handler *h;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	UK_ASSERT(stats);
+
+	h = &dev->_data->rxq_handler[queue_id];
+	if (!h->dispatcher)
+		return -EINVAL;
+
+	*stats = h->stats;
+	return 0;
+}
+#endif
+
 int uk_netdev_txq_configure(struct uk_netdev *dev, uint16_t queue_id,
 			    uint16_t nb_desc,
 			    struct uk_netdev_txqueue_conf *tx_conf)
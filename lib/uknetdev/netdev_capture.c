@@ -0,0 +1,782 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Packet capture for network devices
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <uk/netdev.h>
+#include <uk/netdev_capture.h>
+#include <uk/ring.h>
+#include <uk/semaphore.h>
+#include <uk/thread.h>
+#include <uk/print.h>
+#include <uk/arch/atomic.h>
+#include <uk/plat/time.h>
+#if CONFIG_LIBVFSCORE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Maximum number of packets of a transmit burst whose capture state is
+ * kept on the stack; larger bursts are handed to the driver in chunks
+ */
+#define CAPTURE_TX_CHUNK 32
+
+/* Size of the pcapng output buffer, in addition to one maximum sized block */
+#define CAPTURE_BUFLEN (64 * 1024)
+
+#define CAPTURE_SNAPLEN_MAX 65535
+
+/* pcapng block types and options (IETF draft-tuexen-opsawg-pcapng) */
+#define PCAPNG_BT_SHB           0x0A0D0D0A
+#define PCAPNG_BT_IDB           0x00000001
+#define PCAPNG_BT_EPB           0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_LINKTYPE_ETHER   1
+#define PCAPNG_OPT_ENDOFOPT     0
+#define PCAPNG_OPT_IF_NAME      2
+#define PCAPNG_OPT_IF_TSRESOL   9
+#define PCAPNG_OPT_EPB_FLAGS    2
+#define PCAPNG_EPB_INBOUND      0x1
+#define PCAPNG_EPB_OUTBOUND     0x2
+
+#define PCAPNG_PAD(len) ALIGN_UP((len), 4)
+
+struct pcapng_block_hdr {
+	uint32_t type;
+	uint32_t len;
+};
+
+struct pcapng_shb {
+	struct pcapng_block_hdr hdr;
+	uint32_t byte_order_magic;
+	uint16_t major;
+	uint16_t minor;
+	int64_t  section_len;
+};
+
+struct pcapng_idb {
+	struct pcapng_block_hdr hdr;
+	uint16_t linktype;
+	uint16_t reserved;
+	uint32_t snaplen;
+};
+
+struct pcapng_epb {
+	struct pcapng_block_hdr hdr;
+	uint32_t if_id;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint32_t caplen;
+	uint32_t len;
+};
+
+struct pcapng_opt {
+	uint16_t code;
+	uint16_t len;
+};
+
+/* A captured packet on its way to the writer. `data` and `len` are taken
+ * from the head netbuf at capture time because drivers adjust them when
+ * they prepend or strip headers.
+ */
+struct uk_netdev_capture_rec {
+	struct uk_netbuf *pkt;
+	const void *data;
+	uint32_t len;
+	uint32_t pktlen;
+	__nsec ts;
+	uint16_t queue_id;
+	int dir;
+};
+
+struct uk_netdev_capture {
+	struct uk_netdev *dev;
+	int dirs;
+	uint32_t snaplen;
+	uk_netdev_capture_filter_t volatile filter;
+	void * volatile filter_arg;
+
+	/* Packet functions currently using this capture */
+	volatile uint32_t users;
+
+	/* Records cycle between the free and the pending ring */
+	struct uk_ring *free;
+	struct uk_ring *pending;
+	struct uk_netdev_capture_rec *recs;
+
+	struct uk_alloc *a;
+	struct uk_semaphore events;
+	struct uk_thread *writer;
+	char *writer_name;
+	volatile int stop;
+
+	/* File sink */
+	int fd;
+	char *buf;
+	size_t buflen;
+	size_t bufpos;
+	uint64_t bufpkts;
+	__snsec wall_offset;
+
+	/* Mirror sink */
+	struct uk_netdev *mirror;
+	uint16_t mirror_queue_id;
+	uint16_t mirror_headroom;
+
+	struct uk_netdev_capture_stats stats;
+};
+
+static inline struct uk_netdev_capture *_capture_get(struct uk_netdev *dev)
+{
+	struct uk_netdev_capture *c;
+
+	c = dev->_data->capture;
+	if (unlikely(!c))
+		return NULL;
+
+	/* uk_netdev_capture_stop() detaches the capture first and waits
+	 * until all users left before it is released
+	 */
+	ukarch_inc(&c->users);
+	if (unlikely(dev->_data->capture != c)) {
+		ukarch_dec(&c->users);
+		return NULL;
+	}
+	return c;
+}
+
+static inline void _capture_put(struct uk_netdev_capture *c)
+{
+	ukarch_dec(&c->users);
+}
+
+static inline int _capture_select(struct uk_netdev_capture *c,
+				  struct uk_netdev *dev, uint16_t queue_id,
+				  int dir, struct uk_netbuf *pkt)
+{
+	uk_netdev_capture_filter_t filter = c->filter;
+
+	return !filter || filter(dev, queue_id, dir, pkt, c->filter_arg);
+}
+
+static struct uk_netdev_capture_rec *_capture_take(struct uk_netdev_capture *c,
+						   uint16_t queue_id, int dir,
+						   struct uk_netbuf *pkt,
+						   __nsec ts)
+{
+	struct uk_netdev_capture_rec *rec;
+	struct uk_netbuf *iter;
+
+	rec = uk_ring_dequeue_mc(c->free);
+	if (unlikely(!rec)) {
+		ukarch_inc(&c->stats.dropped);
+		return NULL;
+	}
+
+	rec->pkt = uk_netbuf_ref(pkt);
+	rec->data = pkt->data;
+	rec->len = pkt->len;
+	rec->pktlen = 0;
+	UK_NETBUF_CHAIN_FOREACH(iter, pkt)
+		rec->pktlen += iter->len;
+	rec->ts = ts;
+	rec->queue_id = queue_id;
+	rec->dir = dir;
+	return rec;
+}
+
+static void _capture_release(struct uk_netdev_capture *c,
+			     struct uk_netdev_capture_rec *rec)
+{
+	int rc __maybe_unused;
+
+	uk_netbuf_free(rec->pkt);
+	rec->pkt = NULL;
+	rc = uk_ring_enqueue(c->free, rec);
+	UK_ASSERT(rc == 0);
+}
+
+static void _capture_pass(struct uk_netdev_capture *c,
+			  struct uk_netdev_capture_rec *rec)
+{
+	int rc __maybe_unused;
+
+	/* The pending ring has room for all records */
+	rc = uk_ring_enqueue(c->pending, rec);
+	UK_ASSERT(rc == 0);
+	ukarch_inc(&c->stats.captured);
+}
+
+void _uk_netdev_capture_rx(struct uk_netdev *dev, uint16_t queue_id,
+			   struct uk_netbuf **pkt, uint16_t cnt)
+{
+	struct uk_netdev_capture *c;
+	struct uk_netdev_capture_rec *rec;
+	uint16_t i, n = 0;
+	__nsec ts;
+
+	c = _capture_get(dev);
+	if (unlikely(!c))
+		return;
+	if (!(c->dirs & UK_NETDEV_CAPTURE_RX))
+		goto out;
+
+	ts = ukplat_monotonic_clock();
+	for (i = 0; i < cnt; ++i) {
+		if (!_capture_select(c, dev, queue_id,
+				     UK_NETDEV_CAPTURE_RX, pkt[i]))
+			continue;
+		rec = _capture_take(c, queue_id, UK_NETDEV_CAPTURE_RX,
+				    pkt[i], ts);
+		if (unlikely(!rec))
+			break;
+		_capture_pass(c, rec);
+		++n;
+	}
+	if (n)
+		uk_semaphore_up(&c->events);
+out:
+	_capture_put(c);
+}
+
+int _uk_netdev_capture_tx_one(struct uk_netdev *dev, uint16_t queue_id,
+			      struct uk_netbuf *pkt)
+{
+	struct uk_netdev_capture *c;
+	struct uk_netdev_capture_rec *rec = NULL;
+	int rc;
+
+	c = _capture_get(dev);
+	if (unlikely(!c))
+		return _uk_netdev_tx_one(dev, queue_id, pkt);
+
+	/* The reference has to be taken before the driver owns the packet */
+	if ((c->dirs & UK_NETDEV_CAPTURE_TX)
+	    && _capture_select(c, dev, queue_id, UK_NETDEV_CAPTURE_TX, pkt))
+		rec = _capture_take(c, queue_id, UK_NETDEV_CAPTURE_TX, pkt,
+				    ukplat_monotonic_clock());
+
+	rc = _uk_netdev_tx_one(dev, queue_id, pkt);
+	if (rec) {
+		if (rc > 0 && (rc & UK_NETDEV_STATUS_SUCCESS)) {
+			_capture_pass(c, rec);
+			uk_semaphore_up(&c->events);
+		} else {
+			_capture_release(c, rec);
+		}
+	}
+
+	_capture_put(c);
+	return rc;
+}
+
+int _uk_netdev_capture_tx_burst(struct uk_netdev *dev, uint16_t queue_id,
+				struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	struct uk_netdev_capture *c;
+	struct uk_netdev_capture_rec *rec[CAPTURE_TX_CHUNK];
+	uint16_t total, sent = 0, req, i, n, queued = 0;
+	int rc;
+	__nsec ts;
+
+	c = _capture_get(dev);
+	if (unlikely(!c))
+		return _uk_netdev_tx_burst(dev, queue_id, pkt, cnt);
+	if (!(c->dirs & UK_NETDEV_CAPTURE_TX)) {
+		rc = _uk_netdev_tx_burst(dev, queue_id, pkt, cnt);
+		goto out;
+	}
+
+	ts = ukplat_monotonic_clock();
+	total = *cnt;
+	do {
+		req = MIN(total - sent, CAPTURE_TX_CHUNK);
+		for (i = 0; i < req; ++i) {
+			rec[i] = NULL;
+			if (_capture_select(c, dev, queue_id,
+					    UK_NETDEV_CAPTURE_TX, pkt[sent + i]))
+				rec[i] = _capture_take(c, queue_id,
+						       UK_NETDEV_CAPTURE_TX,
+						       pkt[sent + i], ts);
+		}
+
+		n = req;
+		rc = _uk_netdev_tx_burst(dev, queue_id, &pkt[sent], &n);
+		if (rc < 0)
+			n = 0;
+		for (i = 0; i < req; ++i) {
+			if (!rec[i])
+				continue;
+			if (i < n) {
+				_capture_pass(c, rec[i]);
+				++queued;
+			} else {
+				_capture_release(c, rec[i]);
+			}
+		}
+		sent += n;
+	} while (rc >= 0 && n == req && sent < total);
+
+	/* Report a successful transmission if an earlier chunk went out */
+	if (sent > 0)
+		rc = (rc < 0 ? 0 : rc) | UK_NETDEV_STATUS_SUCCESS;
+	*cnt = sent;
+	if (queued)
+		uk_semaphore_up(&c->events);
+out:
+	_capture_put(c);
+	return rc;
+}
+
+/* Copies up to `len` bytes of a captured packet to `dst` */
+static void _capture_copy(struct uk_netdev_capture_rec *rec, void *dst,
+			  uint32_t len)
+{
+	struct uk_netbuf *iter;
+	uint32_t n;
+
+	n = MIN(len, rec->len);
+	memcpy(dst, rec->data, n);
+	dst = (uint8_t *) dst + n;
+	len -= n;
+
+	for (iter = rec->pkt->next; iter && len; iter = iter->next) {
+		n = MIN(len, iter->len);
+		memcpy(dst, iter->data, n);
+		dst = (uint8_t *) dst + n;
+		len -= n;
+	}
+}
+
+#if CONFIG_LIBVFSCORE
+static int _capture_flush(struct uk_netdev_capture *c)
+{
+	size_t off = 0;
+	ssize_t rc;
+
+	while (off < c->bufpos) {
+		rc = write(c->fd, c->buf + off, c->bufpos - off);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0) {
+			c->stats.errors += c->bufpkts;
+			c->bufpos = 0;
+			c->bufpkts = 0;
+			return (rc < 0) ? -errno : -EIO;
+		}
+		off += rc;
+	}
+
+	c->stats.written += c->bufpkts;
+	c->bufpos = 0;
+	c->bufpkts = 0;
+	return 0;
+}
+
+/* Returns buffer space for a block of `len` bytes, flushes the buffer if
+ * it is too full
+ */
+static void *_capture_reserve(struct uk_netdev_capture *c, size_t len)
+{
+	void *ptr;
+
+	UK_ASSERT(len <= c->buflen);
+
+	if (c->bufpos + len > c->buflen)
+		_capture_flush(c);
+	ptr = c->buf + c->bufpos;
+	memset(ptr, 0, len);
+	c->bufpos += len;
+	return ptr;
+}
+
+static void *_capture_opt(void *pos, uint16_t code, const void *val,
+			  uint16_t len)
+{
+	struct pcapng_opt *opt = pos;
+
+	opt->code = code;
+	opt->len = len;
+	if (len)
+		memcpy(opt + 1, val, len);
+	return (uint8_t *) (opt + 1) + PCAPNG_PAD(len);
+}
+
+static void _capture_write_hdr(struct uk_netdev_capture *c)
+{
+	struct pcapng_shb *shb;
+	struct pcapng_idb *idb;
+	char name[16];
+	uint16_t namelen;
+	uint8_t tsresol = 9; /* nanoseconds */
+	uint32_t len;
+	void *pos;
+
+	len = sizeof(*shb) + sizeof(uint32_t);
+	shb = _capture_reserve(c, len);
+	shb->hdr.type = PCAPNG_BT_SHB;
+	shb->hdr.len = len;
+	shb->byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC;
+	shb->major = 1;
+	shb->minor = 0;
+	shb->section_len = -1; /* unspecified */
+	*((uint32_t *) (shb + 1)) = len;
+
+	namelen = snprintf(name, sizeof(name), "netdev%"PRIu16,
+			   uk_netdev_id_get(c->dev));
+	len = sizeof(*idb)
+	      + sizeof(struct pcapng_opt) + PCAPNG_PAD(namelen)
+	      + sizeof(struct pcapng_opt) + PCAPNG_PAD(sizeof(tsresol))
+	      + sizeof(struct pcapng_opt) + sizeof(uint32_t);
+	idb = _capture_reserve(c, len);
+	idb->hdr.type = PCAPNG_BT_IDB;
+	idb->hdr.len = len;
+	idb->linktype = PCAPNG_LINKTYPE_ETHER;
+	idb->snaplen = c->snaplen;
+	pos = _capture_opt(idb + 1, PCAPNG_OPT_IF_NAME, name, namelen);
+	pos = _capture_opt(pos, PCAPNG_OPT_IF_TSRESOL,
+			   &tsresol, sizeof(tsresol));
+	pos = _capture_opt(pos, PCAPNG_OPT_ENDOFOPT, NULL, 0);
+	*((uint32_t *) pos) = len;
+}
+
+static void _capture_write_epb(struct uk_netdev_capture *c,
+			       struct uk_netdev_capture_rec *rec)
+{
+	struct pcapng_epb *epb;
+	uint32_t caplen, flags, len;
+	uint64_t ts;
+	void *pos;
+
+	caplen = MIN(rec->pktlen, c->snaplen);
+	flags = (rec->dir == UK_NETDEV_CAPTURE_RX) ? PCAPNG_EPB_INBOUND
+						   : PCAPNG_EPB_OUTBOUND;
+	len = sizeof(*epb) + PCAPNG_PAD(caplen)
+	      + sizeof(struct pcapng_opt) + sizeof(flags)
+	      + sizeof(struct pcapng_opt) + sizeof(uint32_t);
+	ts = (uint64_t) ((__snsec) rec->ts + c->wall_offset);
+
+	epb = _capture_reserve(c, len);
+	epb->hdr.type = PCAPNG_BT_EPB;
+	epb->hdr.len = len;
+	epb->if_id = 0;
+	epb->ts_high = (uint32_t) (ts >> 32);
+	epb->ts_low = (uint32_t) ts;
+	epb->caplen = caplen;
+	epb->len = rec->pktlen;
+	_capture_copy(rec, epb + 1, caplen);
+	pos = (uint8_t *) (epb + 1) + PCAPNG_PAD(caplen);
+	pos = _capture_opt(pos, PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+	pos = _capture_opt(pos, PCAPNG_OPT_ENDOFOPT, NULL, 0);
+	*((uint32_t *) pos) = len;
+	c->bufpkts++;
+}
+#endif /* CONFIG_LIBVFSCORE */
+
+static void _capture_mirror(struct uk_netdev_capture *c,
+			    struct uk_netdev_capture_rec *rec)
+{
+	struct uk_netbuf *nb;
+	uint32_t caplen;
+	int rc;
+
+	caplen = MIN(rec->pktlen, c->snaplen);
+	nb = uk_netbuf_alloc_buf(c->a, c->mirror_headroom + caplen, 8,
+				 c->mirror_headroom, 0, NULL);
+	if (unlikely(!nb)) {
+		c->stats.errors++;
+		return;
+	}
+	_capture_copy(rec, nb->data, caplen);
+	nb->len = caplen;
+
+	/* The queue is reserved for the capture, the writer is its only user */
+	rc = uk_netdev_tx_one(c->mirror, c->mirror_queue_id, nb);
+	if (unlikely(rc < 0 || !(rc & UK_NETDEV_STATUS_SUCCESS))) {
+		uk_netbuf_free(nb);
+		if (rc >= 0 || rc == -ENOSPC)
+			c->stats.txfull++;
+		else
+			c->stats.errors++;
+		return;
+	}
+	c->stats.written++;
+}
+
+static void _capture_drain(struct uk_netdev_capture *c)
+{
+	struct uk_netdev_capture_rec *rec;
+
+	while ((rec = uk_ring_dequeue_sc(c->pending)) != NULL) {
+#if CONFIG_LIBVFSCORE
+		if (c->fd >= 0)
+			_capture_write_epb(c, rec);
+		else
+#endif
+			_capture_mirror(c, rec);
+		_capture_release(c, rec);
+	}
+#if CONFIG_LIBVFSCORE
+	if (c->fd >= 0 && c->bufpos)
+		_capture_flush(c);
+#endif
+}
+
+static void _capture_writer(void *arg)
+{
+	struct uk_netdev_capture *c = (struct uk_netdev_capture *) arg;
+
+	UK_ASSERT(c);
+
+	while (!c->stop) {
+		uk_semaphore_down(&c->events);
+		_capture_drain(c);
+	}
+	/* No packet function uses the capture anymore */
+	_capture_drain(c);
+	uk_sched_thread_exit();
+}
+
+static void _capture_free(struct uk_netdev_capture *c)
+{
+#if CONFIG_LIBVFSCORE
+	if (c->fd >= 0)
+		close(c->fd);
+#endif
+	if (c->buf)
+		uk_free(c->a, c->buf);
+	if (c->writer_name)
+		free(c->writer_name);
+	if (c->pending)
+		uk_ring_free(c->pending, c->a);
+	if (c->free)
+		uk_ring_free(c->free, c->a);
+	if (c->recs)
+		uk_free(c->a, c->recs);
+	if (c->mirror)
+		c->mirror->_data->txq_mirror[c->mirror_queue_id] = 0;
+	uk_free(c->a, c);
+}
+
+int uk_netdev_capture_start(struct uk_netdev *dev,
+			    const struct uk_netdev_capture_conf *conf)
+{
+	struct uk_netdev_capture *c;
+	struct uk_netdev_info info;
+	uint16_t nb_pending, i;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+	UK_ASSERT(conf);
+	UK_ASSERT(conf->a);
+	UK_ASSERT(conf->s);
+
+	if (dev->_data->capture)
+		return -EBUSY;
+	if ((conf->path == NULL) == (conf->mirror == NULL))
+		return -EINVAL;
+	if (conf->snaplen > CAPTURE_SNAPLEN_MAX)
+		return -EINVAL;
+	nb_pending = conf->nb_pending ? conf->nb_pending
+				      : CONFIG_LIBUKNETDEV_CAPTURE_QUEUELEN;
+	if (nb_pending & (nb_pending - 1) || nb_pending > 0x4000)
+		return -EINVAL;
+	if (conf->mirror) {
+		/* Mirrored packets would be captured again */
+		if (conf->mirror == dev)
+			return -EINVAL;
+		if (conf->mirror->_data->state != UK_NETDEV_RUNNING)
+			return -EINVAL;
+		if (conf->mirror_queue_id >= CONFIG_LIBUKNETDEV_MAXNBQUEUES
+		    || PTRISERR(conf->mirror->_tx_queue[conf->mirror_queue_id]))
+			return -EINVAL;
+		if (conf->mirror->_data->txq_mirror[conf->mirror_queue_id])
+			return -EBUSY;
+	}
+#if !CONFIG_LIBVFSCORE
+	if (conf->path)
+		return -ENOTSUP;
+#endif
+
+	c = uk_calloc(conf->a, 1, sizeof(*c));
+	if (!c)
+		return -ENOMEM;
+	c->a = conf->a;
+	c->dev = dev;
+	c->fd = -1;
+	c->dirs = conf->dirs ? conf->dirs
+			     : (UK_NETDEV_CAPTURE_RX | UK_NETDEV_CAPTURE_TX);
+	c->snaplen = conf->snaplen ? conf->snaplen : CAPTURE_SNAPLEN_MAX;
+	c->filter = conf->filter;
+	c->filter_arg = conf->filter_arg;
+	uk_semaphore_init(&c->events, 0);
+
+	/* Both rings can hold all records (a ring keeps one slot empty) */
+	c->recs = uk_calloc(c->a, nb_pending, sizeof(*c->recs));
+	c->free = uk_ring_alloc(nb_pending * 2, c->a);
+	c->pending = uk_ring_alloc(nb_pending * 2, c->a);
+	if (!c->recs || !c->free || !c->pending) {
+		rc = -ENOMEM;
+		goto err_free;
+	}
+	for (i = 0; i < nb_pending; ++i)
+		uk_ring_enqueue(c->free, &c->recs[i]);
+
+	if (conf->mirror) {
+		uk_netdev_info_get(conf->mirror, &info);
+		c->mirror = conf->mirror;
+		c->mirror_queue_id = conf->mirror_queue_id;
+		c->mirror_headroom = info.nb_encap_tx;
+		c->mirror->_data->txq_mirror[c->mirror_queue_id] = 1;
+	}
+#if CONFIG_LIBVFSCORE
+	if (conf->path) {
+		/* Room for a block with a full-sized packet and its options */
+		c->buflen = CAPTURE_BUFLEN + sizeof(struct pcapng_epb)
+			    + PCAPNG_PAD(c->snaplen) + 32;
+		c->buf = uk_malloc(c->a, c->buflen);
+		if (!c->buf) {
+			rc = -ENOMEM;
+			goto err_free;
+		}
+		c->fd = open(conf->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (c->fd < 0) {
+			rc = -errno;
+			goto err_free;
+		}
+		c->wall_offset = (__snsec) ukplat_wall_clock()
+				 - (__snsec) ukplat_monotonic_clock();
+		_capture_write_hdr(c);
+		rc = _capture_flush(c);
+		if (rc < 0)
+			goto err_free;
+	}
+#endif
+
+	if (asprintf(&c->writer_name, "netdev%"PRIu16"-capture",
+		     dev->_data->id) < 0)
+		c->writer_name = NULL;
+	c->writer = uk_sched_thread_create(conf->s, c->writer_name, NULL,
+					   _capture_writer, c);
+	if (!c->writer) {
+		rc = -ENOMEM;
+		goto err_free;
+	}
+
+	if (conf->path)
+		uk_pr_info("netdev%"PRIu16": Capturing to %s\n",
+			   dev->_data->id, conf->path);
+	else
+		uk_pr_info("netdev%"PRIu16": Mirroring to netdev%"PRIu16"\n",
+			   dev->_data->id, conf->mirror->_data->id);
+	dev->_data->capture = c;
+	return 0;
+
+err_free:
+	_capture_free(c);
+	return rc;
+}
+
+int uk_netdev_capture_stop(struct uk_netdev *dev,
+			   struct uk_netdev_capture_stats *stats)
+{
+	struct uk_netdev_capture *c;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+
+	c = dev->_data->capture;
+	if (!c)
+		return -ENODEV;
+
+	/* Detach the capture and wait for packet functions that still use it.
+	 * After this, no new packet is passed to the writer.
+	 */
+	dev->_data->capture = NULL;
+	barrier();
+	while (c->users)
+		uk_sched_yield();
+
+	c->stop = 1;
+	uk_semaphore_up(&c->events);
+	uk_thread_wait(c->writer);
+	c->writer = NULL;
+
+	if (stats)
+		*stats = c->stats;
+	uk_pr_info("netdev%"PRIu16": Capture stopped (%"PRIu64" captured, %"PRIu64" dropped, %"PRIu64" written, %"PRIu64" errors, %"PRIu64" queue full)\n",
+		   dev->_data->id, c->stats.captured, c->stats.dropped,
+		   c->stats.written, c->stats.errors, c->stats.txfull);
+	_capture_free(c);
+	return 0;
+}
+
+int uk_netdev_capture_filter_set(struct uk_netdev *dev,
+				 uk_netdev_capture_filter_t filter, void *arg)
+{
+	struct uk_netdev_capture *c;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+
+	c = dev->_data->capture;
+	if (!c)
+		return -ENODEV;
+
+	/* Capture everything while filter and argument are swapped so that
+	 * a packet function never calls the new filter with the old argument
+	 */
+	c->filter = NULL;
+	barrier();
+	c->filter_arg = arg;
+	barrier();
+	c->filter = filter;
+	return 0;
+}
+
+int uk_netdev_capture_stats_get(struct uk_netdev *dev,
+				struct uk_netdev_capture_stats *stats)
+{
+	struct uk_netdev_capture *c;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+	UK_ASSERT(stats);
+
+	c = dev->_data->capture;
+	if (!c)
+		return -ENODEV;
+	*stats = c->stats;
+	return 0;
+}
@@ -0,0 +1,673 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Receive packet filters for network devices
+ *
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <string.h>
+#include <uk/netdev.h>
+#include <uk/netdev_driver.h>
+#include <uk/netdev_filter.h>
+#include <uk/ring.h>
+#include <uk/errptr.h>
+#include <uk/print.h>
+
+struct uk_netdev_filter {
+	struct uk_alloc *a;
+	uint16_t len;
+	struct uk_bpf_insn insns[];
+};
+
+struct uk_netdev_steering {
+	/* Packets that were steered to a queue and are not received yet */
+	struct uk_ring *backlog[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	/* Queues whose event callback has to be triggered */
+	volatile uint8_t notify[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	volatile int notify_any;
+	/* Queues with interrupts turned off by an event, like drivers do,
+	 * until they are drained
+	 */
+	volatile uint8_t rearm[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+};
+
+#define FILTER_BACKLOG_LEN CONFIG_LIBUKNETDEV_FILTER_BACKLOG
+
+static int _filter_validate(const struct uk_bpf_insn *insns, uint16_t len)
+{
+	const struct uk_bpf_insn *p;
+	uint32_t remaining;
+	uint16_t i;
+
+	if (len == 0 || len > UK_BPF_MAXINSNS)
+		return -EINVAL;
+
+	for (i = 0; i < len; ++i) {
+		p = &insns[i];
+		/* Instructions behind this one */
+		remaining = len - i - 1;
+
+		/* Opcodes are 8 bits wide, the interpreter matches all bits */
+		if (p->code & ~0xff)
+			return -EINVAL;
+
+		switch (UK_BPF_CLASS(p->code)) {
+		case UK_BPF_LD:
+			switch (p->code) {
+			case UK_BPF_LD | UK_BPF_W | UK_BPF_IMM:
+			case UK_BPF_LD | UK_BPF_W | UK_BPF_LEN:
+			case UK_BPF_LD | UK_BPF_W | UK_BPF_ABS:
+			case UK_BPF_LD | UK_BPF_H | UK_BPF_ABS:
+			case UK_BPF_LD | UK_BPF_B | UK_BPF_ABS:
+			case UK_BPF_LD | UK_BPF_W | UK_BPF_IND:
+			case UK_BPF_LD | UK_BPF_H | UK_BPF_IND:
+			case UK_BPF_LD | UK_BPF_B | UK_BPF_IND:
+				break;
+			case UK_BPF_LD | UK_BPF_W | UK_BPF_MEM:
+				if (p->k >= UK_BPF_MEMWORDS)
+					return -EINVAL;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case UK_BPF_LDX:
+			switch (p->code) {
+			case UK_BPF_LDX | UK_BPF_W | UK_BPF_IMM:
+			case UK_BPF_LDX | UK_BPF_W | UK_BPF_LEN:
+			case UK_BPF_LDX | UK_BPF_B | UK_BPF_MSH:
+				break;
+			case UK_BPF_LDX | UK_BPF_W | UK_BPF_MEM:
+				if (p->k >= UK_BPF_MEMWORDS)
+					return -EINVAL;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case UK_BPF_ST:
+		case UK_BPF_STX:
+			if (p->code != UK_BPF_CLASS(p->code)
+			    || p->k >= UK_BPF_MEMWORDS)
+				return -EINVAL;
+			break;
+		case UK_BPF_ALU:
+			switch (UK_BPF_OP(p->code)) {
+			case UK_BPF_DIV:
+			case UK_BPF_MOD:
+				if (UK_BPF_SRC(p->code) == UK_BPF_K
+				    && p->k == 0)
+					return -EINVAL;
+				/* fall through */
+			case UK_BPF_ADD:
+			case UK_BPF_SUB:
+			case UK_BPF_MUL:
+			case UK_BPF_OR:
+			case UK_BPF_AND:
+			case UK_BPF_XOR:
+			case UK_BPF_LSH:
+			case UK_BPF_RSH:
+				break;
+			case UK_BPF_NEG:
+				if (p->code != (UK_BPF_ALU | UK_BPF_NEG))
+					return -EINVAL;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case UK_BPF_JMP:
+			switch (UK_BPF_OP(p->code)) {
+			case UK_BPF_JA:
+				/* Only forward jumps, programs terminate */
+				if (p->code != (UK_BPF_JMP | UK_BPF_JA)
+				    || p->k >= remaining)
+					return -EINVAL;
+				break;
+			case UK_BPF_JEQ:
+			case UK_BPF_JGT:
+			case UK_BPF_JGE:
+			case UK_BPF_JSET:
+				if (p->jt >= remaining || p->jf >= remaining)
+					return -EINVAL;
+				break;
+			default:
+				return -EINVAL;
+			}
+			break;
+		case UK_BPF_RET:
+			if (p->code != (UK_BPF_RET | UK_BPF_K)
+			    && p->code != (UK_BPF_RET | UK_BPF_A))
+				return -EINVAL;
+			break;
+		case UK_BPF_MISC:
+			if (p->code != (UK_BPF_MISC | UK_BPF_TAX)
+			    && p->code != (UK_BPF_MISC | UK_BPF_TXA))
+				return -EINVAL;
+			break;
+		}
+	}
+
+	/* The last instruction has to end the program */
+	if (UK_BPF_CLASS(insns[len - 1].code) != UK_BPF_RET)
+		return -EINVAL;
+	return 0;
+}
+
+struct uk_netdev_filter *uk_netdev_filter_create(struct uk_alloc *a,
+						 const struct uk_bpf_insn *insns,
+						 uint16_t len)
+{
+	struct uk_netdev_filter *filter;
+	int rc;
+
+	UK_ASSERT(a);
+	UK_ASSERT(insns);
+
+	rc = _filter_validate(insns, len);
+	if (rc < 0)
+		return ERR2PTR(rc);
+
+	filter = uk_malloc(a, sizeof(*filter) + len * sizeof(*insns));
+	if (!filter)
+		return ERR2PTR(-ENOMEM);
+	filter->a = a;
+	filter->len = len;
+	memcpy(filter->insns, insns, len * sizeof(*insns));
+	return filter;
+}
+
+void uk_netdev_filter_destroy(struct uk_netdev_filter *filter)
+{
+	UK_ASSERT(filter);
+
+	uk_free(filter->a, filter);
+}
+
+/* Loads `size` bytes in network byte order from offset `off` of a packet.
+ * Returns -1 if the packet is too short.
+ */
+static inline int _filter_load(const struct uk_netbuf *pkt, uint32_t off,
+			       uint32_t size, uint32_t *val)
+{
+	const struct uk_netbuf *iter;
+	const uint8_t *p;
+	uint8_t tmp[4];
+	uint32_t i, n;
+
+	if (likely((uint64_t) off + size <= pkt->len)) {
+		p = (const uint8_t *) pkt->data + off;
+	} else {
+		/* The bytes are spread over the netbuf chain */
+		for (iter = pkt; iter && off >= iter->len; iter = iter->next)
+			off -= iter->len;
+		for (i = 0; i < size && iter; iter = iter->next, off = 0) {
+			n = MIN(size - i, iter->len - off);
+			memcpy(&tmp[i], (const uint8_t *) iter->data + off, n);
+			i += n;
+		}
+		if (i < size)
+			return -1;
+		p = tmp;
+	}
+
+	switch (size) {
+	case 4:
+		*val = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16)
+		       | ((uint32_t) p[2] << 8) | p[3];
+		break;
+	case 2:
+		*val = ((uint32_t) p[0] << 8) | p[1];
+		break;
+	default:
+		*val = p[0];
+		break;
+	}
+	return 0;
+}
+
+#define FILTER_LOAD(pkt, off, size, dst)			\
+	do {							\
+		if (unlikely(_filter_load((pkt), (off),		\
+					  (size), (dst)) < 0))	\
+			return UK_NETDEV_FILTER_DROP;		\
+	} while (0)
+
+uint32_t uk_netdev_filter_run(const struct uk_netdev_filter *filter,
+			      const struct uk_netbuf *pkt)
+{
+	const struct uk_bpf_insn *pc;
+	const struct uk_netbuf *iter;
+	/* Loads from scratch memory that was not stored must not leak
+	 * stack contents
+	 */
+	uint32_t mem[UK_BPF_MEMWORDS] = { 0 };
+	uint32_t A = 0, X = 0, len = 0, v;
+
+	UK_ASSERT(filter);
+	UK_ASSERT(pkt);
+
+	UK_NETBUF_CHAIN_FOREACH(iter, pkt)
+		len += iter->len;
+
+	/* Validation guarantees that we hit a return instruction */
+	for (pc = filter->insns; ; ++pc) {
+		switch (pc->code) {
+		case UK_BPF_RET | UK_BPF_K:
+			return pc->k;
+		case UK_BPF_RET | UK_BPF_A:
+			return A;
+
+		case UK_BPF_LD | UK_BPF_W | UK_BPF_ABS:
+			FILTER_LOAD(pkt, pc->k, 4, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_H | UK_BPF_ABS:
+			FILTER_LOAD(pkt, pc->k, 2, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_B | UK_BPF_ABS:
+			FILTER_LOAD(pkt, pc->k, 1, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_W | UK_BPF_IND:
+			if (unlikely(X > UINT32_MAX - pc->k))
+				return UK_NETDEV_FILTER_DROP;
+			FILTER_LOAD(pkt, X + pc->k, 4, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_H | UK_BPF_IND:
+			if (unlikely(X > UINT32_MAX - pc->k))
+				return UK_NETDEV_FILTER_DROP;
+			FILTER_LOAD(pkt, X + pc->k, 2, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_B | UK_BPF_IND:
+			if (unlikely(X > UINT32_MAX - pc->k))
+				return UK_NETDEV_FILTER_DROP;
+			FILTER_LOAD(pkt, X + pc->k, 1, &A);
+			break;
+		case UK_BPF_LD | UK_BPF_W | UK_BPF_LEN:
+			A = len;
+			break;
+		case UK_BPF_LD | UK_BPF_W | UK_BPF_IMM:
+			A = pc->k;
+			break;
+		case UK_BPF_LD | UK_BPF_W | UK_BPF_MEM:
+			A = mem[pc->k];
+			break;
+
+		case UK_BPF_LDX | UK_BPF_W | UK_BPF_LEN:
+			X = len;
+			break;
+		case UK_BPF_LDX | UK_BPF_W | UK_BPF_IMM:
+			X = pc->k;
+			break;
+		case UK_BPF_LDX | UK_BPF_W | UK_BPF_MEM:
+			X = mem[pc->k];
+			break;
+		case UK_BPF_LDX | UK_BPF_B | UK_BPF_MSH:
+			FILTER_LOAD(pkt, pc->k, 1, &v);
+			X = (v & 0xf) << 2;
+			break;
+
+		case UK_BPF_ST:
+			mem[pc->k] = A;
+			break;
+		case UK_BPF_STX:
+			mem[pc->k] = X;
+			break;
+
+		case UK_BPF_JMP | UK_BPF_JA:
+			pc += pc->k;
+			break;
+		case UK_BPF_JMP | UK_BPF_JEQ | UK_BPF_K:
+			pc += (A == pc->k) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JGT | UK_BPF_K:
+			pc += (A > pc->k) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JGE | UK_BPF_K:
+			pc += (A >= pc->k) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JSET | UK_BPF_K:
+			pc += (A & pc->k) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JEQ | UK_BPF_X:
+			pc += (A == X) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JGT | UK_BPF_X:
+			pc += (A > X) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JGE | UK_BPF_X:
+			pc += (A >= X) ? pc->jt : pc->jf;
+			break;
+		case UK_BPF_JMP | UK_BPF_JSET | UK_BPF_X:
+			pc += (A & X) ? pc->jt : pc->jf;
+			break;
+
+		case UK_BPF_ALU | UK_BPF_ADD | UK_BPF_K:
+			A += pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_SUB | UK_BPF_K:
+			A -= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_MUL | UK_BPF_K:
+			A *= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_DIV | UK_BPF_K:
+			A /= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_MOD | UK_BPF_K:
+			A %= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_AND | UK_BPF_K:
+			A &= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_OR | UK_BPF_K:
+			A |= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_XOR | UK_BPF_K:
+			A ^= pc->k;
+			break;
+		case UK_BPF_ALU | UK_BPF_LSH | UK_BPF_K:
+			A = (pc->k < 32) ? A << pc->k : 0;
+			break;
+		case UK_BPF_ALU | UK_BPF_RSH | UK_BPF_K:
+			A = (pc->k < 32) ? A >> pc->k : 0;
+			break;
+		case UK_BPF_ALU | UK_BPF_ADD | UK_BPF_X:
+			A += X;
+			break;
+		case UK_BPF_ALU | UK_BPF_SUB | UK_BPF_X:
+			A -= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_MUL | UK_BPF_X:
+			A *= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_DIV | UK_BPF_X:
+			if (unlikely(X == 0))
+				return UK_NETDEV_FILTER_DROP;
+			A /= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_MOD | UK_BPF_X:
+			if (unlikely(X == 0))
+				return UK_NETDEV_FILTER_DROP;
+			A %= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_AND | UK_BPF_X:
+			A &= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_OR | UK_BPF_X:
+			A |= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_XOR | UK_BPF_X:
+			A ^= X;
+			break;
+		case UK_BPF_ALU | UK_BPF_LSH | UK_BPF_X:
+			A = (X < 32) ? A << X : 0;
+			break;
+		case UK_BPF_ALU | UK_BPF_RSH | UK_BPF_X:
+			A = (X < 32) ? A >> X : 0;
+			break;
+		case UK_BPF_ALU | UK_BPF_NEG:
+			A = -A;
+			break;
+
+		case UK_BPF_MISC | UK_BPF_TAX:
+			X = A;
+			break;
+		case UK_BPF_MISC | UK_BPF_TXA:
+			A = X;
+			break;
+
+		default:
+			/* Rejected by validation */
+			UK_CRASH("Invalid filter instruction: %"PRIx16"\n",
+				 pc->code);
+		}
+	}
+}
+
+int uk_netdev_rxq_filter_set(struct uk_netdev *dev, uint16_t queue_id,
+			     struct uk_netdev_filter *filter)
+{
+	struct uk_netdev_steering *st;
+	struct uk_alloc *a;
+	uint16_t i;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(dev->_data);
+	UK_ASSERT(queue_id < CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+
+	if (PTRISERR(dev->_rx_queue[queue_id]))
+		return -EINVAL;
+
+	if (filter) {
+		/* Packets can be steered to every configured queue */
+		a = filter->a;
+		st = dev->_data->steering;
+		if (!st) {
+			st = uk_calloc(a, 1, sizeof(*st));
+			if (!st)
+				return -ENOMEM;
+		}
+		for (i = 0; i < CONFIG_LIBUKNETDEV_MAXNBQUEUES; ++i) {
+			if (st->backlog[i] || PTRISERR(dev->_rx_queue[i]))
+				continue;
+			st->backlog[i] = uk_ring_alloc(FILTER_BACKLOG_LEN, a);
+			if (!st->backlog[i]) {
+				/* Keep the backlogs that were allocated
+				 * for earlier filters
+				 */
+				if (!dev->_data->steering)
+					uk_free(a, st);
+				return -ENOMEM;
+			}
+		}
+		/* From now on, receive calls pick up steered packets */
+		dev->_data->steering = st;
+	}
+
+	dev->_data->rxq_filter[queue_id] = filter;
+	uk_pr_info("netdev%"PRIu16": %s filter on receive queue %"PRIu16"\n",
+		   dev->_data->id, filter ? "Attached" : "Detached", queue_id);
+	return 0;
+}
+
+int _uk_netdev_rx_filter(struct uk_netdev *dev, uint16_t queue_id,
+			 struct uk_netbuf *pkt)
+{
+	struct uk_netdev_filter *filter;
+	struct uk_netdev_steering *st;
+	uint32_t ret;
+	uint16_t target;
+
+	filter = dev->_data->rxq_filter[queue_id];
+	if (unlikely(!filter))
+		return UK_NETDEV_RX_PASS;
+
+	ret = uk_netdev_filter_run(filter, pkt);
+	if (ret == UK_NETDEV_FILTER_DROP) {
+		uk_netdev_drv_rxq_stats_add(dev, queue_id, filtered, 1);
+		return UK_NETDEV_RX_DROP;
+	}
+	if (likely(!UK_NETDEV_FILTER_IS_STEER(ret)))
+		return UK_NETDEV_RX_PASS;
+
+	/* Packets steered to their own queue or to a queue without backlog
+	 * are accepted
+	 */
+	target = UK_NETDEV_FILTER_STEER_QUEUE(ret);
+	st = dev->_data->steering;
+	if (target == queue_id || target >= CONFIG_LIBUKNETDEV_MAXNBQUEUES
+	    || !st->backlog[target])
+		return UK_NETDEV_RX_PASS;
+
+	if (unlikely(uk_ring_enqueue(st->backlog[target], pkt) < 0)) {
+		uk_netdev_drv_rxq_stats_add(dev, queue_id, drops, 1);
+		return UK_NETDEV_RX_DROP;
+	}
+	uk_netdev_drv_rxq_stats_add(dev, queue_id, steered, 1);
+
+	/* The event is forwarded when the receive call returns so that the
+	 * callback of the target queue does not run inside the driver
+	 */
+	st->notify[target] = 1;
+	st->notify_any = 1;
+	return UK_NETDEV_RX_STOLEN;
+}
+
+/* Forwards events to the queues that got packets steered to */
+static void _filter_notify(struct uk_netdev *dev,
+			   struct uk_netdev_steering *st)
+{
+	uint16_t i;
+
+	if (likely(!st->notify_any))
+		return;
+
+	st->notify_any = 0;
+	for (i = 0; i < CONFIG_LIBUKNETDEV_MAXNBQUEUES; ++i) {
+		if (!st->notify[i])
+			continue;
+		st->notify[i] = 0;
+
+		/* Polled queues pick the packets up with their next receive
+		 * call, and an event was already sent if interrupts are off
+		 */
+		if (!dev->_data->rxq_intr[i] || st->rearm[i])
+			continue;
+
+		/* The queue must not be interrupted while it is drained */
+		dev->ops->rxq_intr_disable(dev, dev->_rx_queue[i]);
+		st->rearm[i] = 1;
+		uk_netdev_drv_rx_event(dev, i);
+	}
+}
+
+/* Enables interrupts again after a queue was drained */
+static int _filter_rearm(struct uk_netdev *dev,
+			 struct uk_netdev_steering *st, uint16_t queue_id)
+{
+	struct uk_ring *backlog = st->backlog[queue_id];
+
+	if (backlog && !uk_ring_empty(backlog))
+		return UK_NETDEV_STATUS_MORE;
+
+	st->rearm[queue_id] = 0;
+	if (!dev->_data->rxq_intr[queue_id])
+		return 0x0;
+	return (dev->ops->rxq_intr_enable(dev, dev->_rx_queue[queue_id]) == 1)
+	       ? UK_NETDEV_STATUS_MORE : 0x0;
+}
+
+int _uk_netdev_filter_rx_burst(struct uk_netdev *dev, uint16_t queue_id,
+			       struct uk_netbuf **pkt, uint16_t *cnt)
+{
+	struct uk_netdev_steering *st = dev->_data->steering;
+	struct uk_ring *backlog = st->backlog[queue_id];
+	uint16_t n = 0, m;
+	int rc;
+
+	/* Packets that were steered to this queue are handed out first */
+	if (backlog) {
+		while (n < *cnt
+		       && (pkt[n] = uk_ring_dequeue_sc(backlog)) != NULL)
+			++n;
+		if (n > 0)
+			_uk_netdev_rx_account(dev, queue_id,
+					      UK_NETDEV_STATUS_SUCCESS, pkt, n);
+		if (n == *cnt) {
+			rc = UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
+			goto out;
+		}
+	}
+
+	m = *cnt - n;
+	rc = _uk_netdev_rx_burst(dev, queue_id, &pkt[n], &m);
+	if (unlikely(rc < 0)) {
+		/* Report the error with the next call */
+		if (n == 0)
+			goto out;
+		rc = 0;
+		m = 0;
+	}
+	*cnt = n + m;
+	if (*cnt > 0) {
+		rc |= UK_NETDEV_STATUS_SUCCESS;
+		if (backlog && !uk_ring_empty(backlog))
+			rc |= UK_NETDEV_STATUS_MORE;
+	}
+	if (unlikely(st->rearm[queue_id]) && !(rc & UK_NETDEV_STATUS_MORE))
+		rc |= _filter_rearm(dev, st, queue_id);
+
+out:
+	_filter_notify(dev, st);
+	return rc;
+}
+
+int _uk_netdev_filter_rx_one(struct uk_netdev *dev, uint16_t queue_id,
+			     struct uk_netbuf **pkt)
+{
+	struct uk_netdev_steering *st = dev->_data->steering;
+	struct uk_ring *backlog = st->backlog[queue_id];
+	int rc;
+
+	if (backlog) {
+		*pkt = uk_ring_dequeue_sc(backlog);
+		if (*pkt) {
+			rc = UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
+			_uk_netdev_rx_account(dev, queue_id, rc, pkt, 1);
+			goto out;
+		}
+	}
+
+	rc = _uk_netdev_rx_one(dev, queue_id, pkt);
+	if (unlikely(rc < 0))
+		goto out;
+	if ((rc & UK_NETDEV_STATUS_SUCCESS)
+	    && backlog && !uk_ring_empty(backlog))
+		rc |= UK_NETDEV_STATUS_MORE;
+	if (unlikely(st->rearm[queue_id]) && !(rc & UK_NETDEV_STATUS_MORE))
+		rc |= _filter_rearm(dev, st, queue_id);
+
+out:
+	_filter_notify(dev, st);
+	return rc;
+}
+
+int _uk_netdev_filter_rxq_intr_enable(struct uk_netdev *dev, uint16_t queue_id)
+{
+	struct uk_netdev_steering *st = dev->_data->steering;
+	struct uk_ring *backlog = st->backlog[queue_id];
+
+	/* Like drivers do with a non-empty ring, interrupts are enabled as
+	 * soon as the steered packets were received
+	 */
+	if (backlog && !uk_ring_empty(backlog)) {
+		st->rearm[queue_id] = 1;
+		return 1;
+	}
+	st->rearm[queue_id] = 0;
+	return dev->ops->rxq_intr_enable(dev, dev->_rx_queue[queue_id]);
+}
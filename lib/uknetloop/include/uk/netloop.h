@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UK_NETLOOP__
+#define __UK_NETLOOP__
+
+#include <uk/netdev_core.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Loopback network devices are registered in connected pairs with
+ * consecutive device IDs. A packet that is sent on transmit queue `q` of one
+ * device is received on receive queue `q` (modulo the number of receive
+ * queues) of its peer. The netbuf itself is handed over, so the receiving
+ * side has to free it; the receive buffer allocator of a queue is not used.
+ * Offload flags of a netbuf are passed on unchanged.
+ */
+
+/**
+ * Returns the peer of a loopback network device.
+ * @param dev
+ *   Network device.
+ * @return
+ *   - (NULL): `dev` is not a loopback device
+ *   - The connected peer device
+ */
+struct uk_netdev *uk_netloop_peer_get(struct uk_netdev *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UK_NETLOOP__ */
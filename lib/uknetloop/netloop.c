@@ -0,0 +1,534 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <uk/print.h>
+#include <uk/assert.h>
+#include <uk/essentials.h>
+#include <uk/bus.h>
+#include <uk/ring.h>
+#include <uk/netbuf.h>
+#include <uk/netdev.h>
+#include <uk/netdev_core.h>
+#include <uk/netdev_driver.h>
+#include <uk/netloop.h>
+#include <uk/plat/lcpu.h>
+
+#define DRIVER_NAME          "netloop"
+
+#define NETLOOP_MTU            1500
+#define NETLOOP_MAX_NB_DESC    4096
+#define NETLOOP_DEF_NB_DESC    512
+
+#define NETLOOP_INTR_EN        (1 << 0)
+#define NETLOOP_INTR_USR_EN    (1 << 1)
+
+#define to_netloopdev(ndev) \
+	__containerof(ndev, struct netloop_device, netdev)
+
+struct netloop_device;
+
+struct uk_netdev_rx_queue {
+	struct netloop_device *ldev;
+	/* Netbufs that were sent by the peer */
+	struct uk_ring *ring;
+	/* User queue identifier */
+	__u16 lqueue_id;
+	/* Interrupt state: NETLOOP_INTR_* */
+	__u8 intr_enabled;
+};
+
+struct uk_netdev_tx_queue {
+	struct netloop_device *ldev;
+	/* User queue identifier */
+	__u16 lqueue_id;
+};
+
+struct netloop_device {
+	/* Network device */
+	struct uk_netdev netdev;
+	/* Connected device */
+	struct netloop_device *peer;
+	/* Network device identifier */
+	__u16 uid;
+	/* Set when the receive queues are ready to take packets */
+	int started;
+	/* Configured queues */
+	__u16 rxq_cnt;
+	__u16 txq_cnt;
+	struct uk_netdev_rx_queue rxqs[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	struct uk_netdev_tx_queue txqs[CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+	/* MAC address */
+	struct uk_hwaddr hw_addr;
+	__u16 mtu;
+};
+
+static const char *drv_name = DRIVER_NAME;
+static struct uk_alloc *a;
+
+struct uk_netdev *uk_netloop_peer_get(struct uk_netdev *dev)
+{
+	UK_ASSERT(dev);
+
+	if (uk_netdev_drv_name_get(dev) != drv_name)
+		return NULL;
+	return &to_netloopdev(dev)->peer->netdev;
+}
+
+/**
+ * Signals the peer that packets were queued on one of its receive queues,
+ * if it waits for an interrupt.
+ */
+static void netloop_rxq_notify(struct uk_netdev_rx_queue *rxq)
+{
+	unsigned long flags;
+	int notify = 0;
+
+	/* Fast path: Nobody waits */
+	if (likely(!(rxq->intr_enabled & NETLOOP_INTR_EN)))
+		return;
+
+	flags = ukplat_lcpu_save_irqf();
+	if (rxq->intr_enabled & NETLOOP_INTR_EN) {
+		/* Interrupts stay off until the user re-enables them */
+		rxq->intr_enabled &= ~NETLOOP_INTR_EN;
+		notify = 1;
+	}
+	ukplat_lcpu_restore_irqf(flags);
+
+	if (notify)
+		uk_netdev_drv_rx_event(&rxq->ldev->netdev, rxq->lqueue_id);
+}
+
+static int netloop_xmit_burst(struct uk_netdev *dev,
+			      struct uk_netdev_tx_queue *queue,
+			      struct uk_netbuf **pkt, __u16 *cnt)
+{
+	struct netloop_device *peer;
+	struct uk_netdev_rx_queue *rxq;
+	__u16 i;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkt && cnt);
+
+	peer = queue->ldev->peer;
+	if (unlikely(!peer->started)) {
+		/* Like an unplugged cable: The packets get lost */
+		for (i = 0; i < *cnt; ++i)
+			uk_netbuf_free(pkt[i]);
+		uk_netdev_drv_txq_stats_add(dev, queue->lqueue_id,
+					    drops, *cnt);
+		return UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
+	}
+
+	rxq = &peer->rxqs[queue->lqueue_id % peer->rxq_cnt];
+	for (i = 0; i < *cnt; ++i) {
+		if (unlikely(uk_ring_enqueue(rxq->ring, pkt[i]) < 0))
+			break;
+	}
+	*cnt = i;
+	if (unlikely(i == 0))
+		return 0x0; /* The peer queue is full */
+
+	netloop_rxq_notify(rxq);
+	return UK_NETDEV_STATUS_SUCCESS
+	       | (uk_ring_full(rxq->ring) ? 0x0 : UK_NETDEV_STATUS_MORE);
+}
+
+static int netloop_xmit(struct uk_netdev *dev,
+			struct uk_netdev_tx_queue *queue,
+			struct uk_netbuf *pkt)
+{
+	__u16 cnt = 1;
+
+	return netloop_xmit_burst(dev, queue, &pkt, &cnt);
+}
+
+static int netloop_recv_burst(struct uk_netdev *dev,
+			      struct uk_netdev_rx_queue *queue,
+			      struct uk_netbuf **pkt, __u16 *cnt)
+{
+	int status = 0x0;
+	unsigned long flags;
+	__u16 i = 0;
+
+	UK_ASSERT(dev && queue);
+	UK_ASSERT(pkt && cnt);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(queue->intr_enabled & NETLOOP_INTR_EN));
+
+dequeue:
+	while (i < *cnt) {
+		pkt[i] = uk_ring_dequeue_sc(queue->ring);
+		if (!pkt[i])
+			break;
+
+		switch (uk_netdev_drv_rx_filter(dev, queue->lqueue_id,
+						pkt[i])) {
+		case UK_NETDEV_RX_PASS:
+			i++;
+			break;
+		case UK_NETDEV_RX_DROP:
+			/* The buffers came from the peer, there is no ring
+			 * to recycle them to
+			 */
+			uk_netbuf_free(pkt[i]);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (!uk_ring_empty(queue->ring)) {
+		/* There are further packets */
+		status |= UK_NETDEV_STATUS_MORE;
+	} else if (queue->intr_enabled & NETLOOP_INTR_USR_EN) {
+		/* The queue is drained: Enable the interrupt again */
+		flags = ukplat_lcpu_save_irqf();
+		if (uk_ring_empty(queue->ring))
+			queue->intr_enabled |= NETLOOP_INTR_EN;
+		ukplat_lcpu_restore_irqf(flags);
+
+		if (!(queue->intr_enabled & NETLOOP_INTR_EN)) {
+			/**
+			 * Packet arrived after reading the queue and before
+			 * enabling the interrupt
+			 */
+			if (i == 0)
+				goto dequeue;
+			status |= UK_NETDEV_STATUS_MORE;
+		}
+	}
+
+	*cnt = i;
+	if (i > 0)
+		status |= UK_NETDEV_STATUS_SUCCESS;
+	return status;
+}
+
+static int netloop_recv(struct uk_netdev *dev,
+			struct uk_netdev_rx_queue *queue,
+			struct uk_netbuf **pkt)
+{
+	__u16 cnt = 1;
+	int status;
+
+	status = netloop_recv_burst(dev, queue, pkt, &cnt);
+	if (cnt == 0)
+		*pkt = NULL;
+	return status;
+}
+
+static int netloop_rx_intr_enable(struct uk_netdev *n,
+				  struct uk_netdev_rx_queue *queue)
+{
+	unsigned long flags;
+	int rc = 0;
+
+	UK_ASSERT(n);
+	/* If the interrupt is enabled */
+	if (queue->intr_enabled & NETLOOP_INTR_EN)
+		return 0;
+
+	/**
+	 * Enable the user configuration bit. This would cause the interrupt to
+	 * be enabled automatically when the queue got drained, if the
+	 * interrupt could not be enabled now due to packets in the queue.
+	 */
+	flags = ukplat_lcpu_save_irqf();
+	queue->intr_enabled = NETLOOP_INTR_USR_EN;
+	if (!uk_ring_empty(queue->ring))
+		rc = 1;
+	else
+		queue->intr_enabled |= NETLOOP_INTR_EN;
+	ukplat_lcpu_restore_irqf(flags);
+
+	return rc;
+}
+
+static int netloop_rx_intr_disable(struct uk_netdev *n,
+				   struct uk_netdev_rx_queue *queue)
+{
+	UK_ASSERT(n);
+	queue->intr_enabled &= ~(NETLOOP_INTR_USR_EN | NETLOOP_INTR_EN);
+	return 0;
+}
+
+static struct uk_netdev_rx_queue *netloop_rx_queue_setup(
+				struct uk_netdev *n, uint16_t queue_id,
+				uint16_t nb_desc,
+				struct uk_netdev_rxqueue_conf *conf)
+{
+	struct netloop_device *ldev;
+	struct uk_netdev_rx_queue *rxq;
+
+	UK_ASSERT(n);
+	UK_ASSERT(conf);
+
+	ldev = to_netloopdev(n);
+	if (queue_id >= ldev->rxq_cnt) {
+		uk_pr_err(DRIVER_NAME": Invalid queue identifier: %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+	if (nb_desc == 0)
+		nb_desc = NETLOOP_DEF_NB_DESC;
+	if (!POWER_OF_2(nb_desc) || nb_desc > NETLOOP_MAX_NB_DESC) {
+		uk_pr_err(DRIVER_NAME": Invalid number of descriptors: %"__PRIu16"\n",
+			  nb_desc);
+		return ERR2PTR(-EINVAL);
+	}
+
+	rxq = &ldev->rxqs[queue_id];
+	rxq->ring = uk_ring_alloc(nb_desc, conf->a);
+	if (!rxq->ring)
+		return ERR2PTR(-ENOMEM);
+	rxq->ldev = ldev;
+	rxq->lqueue_id = queue_id;
+	return rxq;
+}
+
+static struct uk_netdev_tx_queue *netloop_tx_queue_setup(
+				struct uk_netdev *n, uint16_t queue_id,
+				uint16_t nb_desc __unused,
+				struct uk_netdev_txqueue_conf *conf __unused)
+{
+	struct netloop_device *ldev;
+	struct uk_netdev_tx_queue *txq;
+
+	UK_ASSERT(n);
+	ldev = to_netloopdev(n);
+	if (queue_id >= ldev->txq_cnt) {
+		uk_pr_err(DRIVER_NAME": Invalid queue identifier: %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+
+	txq = &ldev->txqs[queue_id];
+	txq->ldev = ldev;
+	txq->lqueue_id = queue_id;
+	return txq;
+}
+
+static int netloop_queue_info_get(struct uk_netdev *dev __unused,
+				  __u16 queue_id __unused,
+				  struct uk_netdev_queue_info *qinfo)
+{
+	UK_ASSERT(qinfo);
+
+	/* The ring of a receive queue holds one descriptor less */
+	qinfo->nb_min = 2;
+	qinfo->nb_max = NETLOOP_MAX_NB_DESC;
+	qinfo->nb_align = 0;
+	qinfo->nb_is_power_of_two = 1;
+	return 0;
+}
+
+static int netloop_configure(struct uk_netdev *n,
+			     const struct uk_netdev_conf *conf)
+{
+	struct netloop_device *ldev;
+
+	UK_ASSERT(n);
+	UK_ASSERT(conf);
+	ldev = to_netloopdev(n);
+
+	ldev->rxq_cnt = conf->nb_rx_queues;
+	ldev->txq_cnt = conf->nb_tx_queues;
+	return 0;
+}
+
+static int netloop_start(struct uk_netdev *n)
+{
+	struct netloop_device *ldev;
+	__u16 i;
+
+	UK_ASSERT(n != NULL);
+	ldev = to_netloopdev(n);
+
+	/*
+	 * By default, interrupts are disabled and it is up to the user or
+	 * network stack to manually enable them with a call to
+	 * enable_tx|rx_intr()
+	 */
+	for (i = 0; i < ldev->rxq_cnt; i++) {
+		if (unlikely(!ldev->rxqs[i].ring)) {
+			uk_pr_err(DRIVER_NAME": Receive queue %"__PRIu16" is not set up\n",
+				  i);
+			return -EINVAL;
+		}
+		ldev->rxqs[i].intr_enabled = 0;
+	}
+
+	/* The peer may send from now on */
+	ldev->started = (ldev->rxq_cnt > 0);
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" started\n", ldev->uid);
+	return 0;
+}
+
+static void netloop_info_get(struct uk_netdev *dev __unused,
+			     struct uk_netdev_info *dev_info)
+{
+	UK_ASSERT(dev_info);
+
+	dev_info->max_rx_queues = CONFIG_LIBUKNETDEV_MAXNBQUEUES;
+	dev_info->max_tx_queues = CONFIG_LIBUKNETDEV_MAXNBQUEUES;
+	dev_info->in_queue_pairs = 0;
+	dev_info->max_mtu = NETLOOP_MTU;
+	dev_info->nb_encap_tx = 0;
+	dev_info->nb_encap_rx = 0;
+	dev_info->ioalign = 1;
+	/* Offload flags are handed over to the peer unchanged */
+	dev_info->features = UK_FEATURE_RXQ_INTR_AVAILABLE
+			     | UK_FEATURE_TX_CSUM
+			     | UK_FEATURE_RX_CSUM
+			     | UK_FEATURE_TX_TSO4
+			     | UK_FEATURE_TX_TSO6
+			     | UK_FEATURE_RX_TSO4
+			     | UK_FEATURE_RX_TSO6;
+}
+
+static unsigned netloop_promisc_get(struct uk_netdev *n __unused)
+{
+	/* The peer is the only sender, its packets are never filtered */
+	return 1;
+}
+
+static const struct uk_hwaddr *netloop_mac_get(struct uk_netdev *n)
+{
+	UK_ASSERT(n);
+	return &to_netloopdev(n)->hw_addr;
+}
+
+static int netloop_mac_set(struct uk_netdev *n,
+			   const struct uk_hwaddr *hwaddr)
+{
+	UK_ASSERT(n && hwaddr);
+	to_netloopdev(n)->hw_addr = *hwaddr;
+	return 0;
+}
+
+static __u16 netloop_mtu_get(struct uk_netdev *n)
+{
+	UK_ASSERT(n);
+	return to_netloopdev(n)->mtu;
+}
+
+static const struct uk_netdev_ops netloop_ops = {
+	.configure = netloop_configure,
+	.rxq_configure = netloop_rx_queue_setup,
+	.txq_configure = netloop_tx_queue_setup,
+	.start = netloop_start,
+	.rxq_intr_enable = netloop_rx_intr_enable,
+	.rxq_intr_disable = netloop_rx_intr_disable,
+	.info_get = netloop_info_get,
+	.promiscuous_get = netloop_promisc_get,
+	.hwaddr_get = netloop_mac_get,
+	.hwaddr_set = netloop_mac_set,
+	.mtu_get = netloop_mtu_get,
+	.txq_info_get = netloop_queue_info_get,
+	.rxq_info_get = netloop_queue_info_get,
+};
+
+static struct netloop_device *netloop_add_dev(__u16 pair, __u8 side)
+{
+	struct netloop_device *ldev;
+	int rc;
+
+	ldev = uk_calloc(a, 1, sizeof(*ldev));
+	if (!ldev)
+		return ERR2PTR(-ENOMEM);
+
+	/* Locally administered address: 02:75:6b:6c:<pair>:<side> */
+	ldev->hw_addr.addr_bytes[0] = 0x02;
+	ldev->hw_addr.addr_bytes[1] = 0x75;
+	ldev->hw_addr.addr_bytes[2] = 0x6b;
+	ldev->hw_addr.addr_bytes[3] = 0x6c;
+	ldev->hw_addr.addr_bytes[4] = pair & 0xff;
+	ldev->hw_addr.addr_bytes[5] = side;
+	ldev->mtu = NETLOOP_MTU;
+
+	ldev->netdev.rx_one = netloop_recv;
+	ldev->netdev.tx_one = netloop_xmit;
+	ldev->netdev.rx_burst = netloop_recv_burst;
+	ldev->netdev.tx_burst = netloop_xmit_burst;
+	ldev->netdev.ops = &netloop_ops;
+
+	rc = uk_netdev_drv_register(&ldev->netdev, a, drv_name);
+	if (rc < 0) {
+		uk_pr_err(DRIVER_NAME": Failed to register with libuknetdev: %d\n",
+			  rc);
+		uk_free(a, ldev);
+		return ERR2PTR(rc);
+	}
+	ldev->uid = rc;
+	return ldev;
+}
+
+static int netloop_probe(void)
+{
+	struct netloop_device *ldev0, *ldev1;
+	__u16 pair;
+
+	for (pair = 0; pair < CONFIG_LIBUKNETLOOP_PAIRS; pair++) {
+		ldev0 = netloop_add_dev(pair, 0);
+		if (PTRISERR(ldev0))
+			return PTR2ERR(ldev0);
+		ldev1 = netloop_add_dev(pair, 1);
+		if (PTRISERR(ldev1)) {
+			/* The registered device loops back to itself */
+			ldev0->peer = ldev0;
+			return PTR2ERR(ldev1);
+		}
+		ldev0->peer = ldev1;
+		ldev1->peer = ldev0;
+
+		uk_pr_info(DRIVER_NAME": Connected %"__PRIu16" <-> %"__PRIu16"\n",
+			   ldev0->uid, ldev1->uid);
+	}
+	return 0;
+}
+
+static int netloop_init(struct uk_alloc *drv_allocator)
+{
+	/* driver initialization */
+	if (!drv_allocator)
+		return -EINVAL;
+
+	a = drv_allocator;
+	return 0;
+}
+
+static struct uk_bus netloop_bus = {
+	.init = netloop_init,
+	.probe = netloop_probe,
+};
+UK_BUS_REGISTER(&netloop_bus);
@@ -150,8 +150,133 @@ struct pci_device {
 
 	uint16_t base;
 	unsigned long irq;
+
+	/* MSI-X vector table (if enabled) */
+	volatile uint32_t *msix_table;
+	/* Number of enabled MSI-X vectors */
+	uint16_t msix_nr;
 };
 
+/**
+ * Standard registers of the PCI configuration space header.
+ */
+#define PCI_COMMAND                 (0x04)
+#define PCI_COMMAND_IO              (0x1)
+#define PCI_COMMAND_MEMORY          (0x2)
+#define PCI_COMMAND_MASTER          (0x4)
+#define PCI_COMMAND_INTX_DISABLE    (0x400)
+#define PCI_STATUS                  (0x06)
+#define PCI_STATUS_CAP_LIST         (0x10)
+#define PCI_BASE_ADDRESS_0          (0x10)
+#define PCI_BASE_ADDRESS_SPACE_IO   (0x1)
+#define PCI_BASE_ADDRESS_MEM_TYPE_64 (0x4)
+#define PCI_BASE_ADDRESS_MEM_MASK   (~0xfUL)
+#define PCI_CAPABILITY_LIST         (0x34)
+#define PCI_MAX_BARS                (6)
+
+/** Capability identifiers */
+#define PCI_CAP_ID_MSI              (0x05)
+#define PCI_CAP_ID_VNDR             (0x09)
+#define PCI_CAP_ID_MSIX             (0x11)
+
+/**
+ * Read from the configuration space of a PCI device.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param offset
+ *	Offset into the configuration space; aligned to the access width.
+ * @return
+ *	The value of the register.
+ */
+uint8_t pci_config_read8(struct pci_device *dev, uint8_t offset);
+uint16_t pci_config_read16(struct pci_device *dev, uint8_t offset);
+uint32_t pci_config_read32(struct pci_device *dev, uint8_t offset);
+
+/**
+ * Write to the configuration space of a PCI device.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param offset
+ *	Offset into the configuration space; aligned to the access width.
+ * @param val
+ *	The value to write.
+ */
+void pci_config_write16(struct pci_device *dev, uint8_t offset, uint16_t val);
+void pci_config_write32(struct pci_device *dev, uint8_t offset, uint32_t val);
+
+/**
+ * Find the next capability of a given type in the capability list of a PCI
+ * device.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param cap_id
+ *	The capability identifier to look for.
+ * @param pos
+ *	Offset of the capability to continue the search from, 0 to start at
+ *	the beginning of the list.
+ * @return
+ *	Offset of the capability in the configuration space, 0 if none found.
+ */
+uint8_t pci_cap_next(struct pci_device *dev, uint8_t cap_id, uint8_t pos);
+
+/**
+ * Get an address through which a memory BAR of a PCI device can be
+ * accessed. Only BARs that are located in the PCI memory hole mapped by the
+ * platform are supported.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param bar
+ *	The index of the base address register.
+ * @param len
+ *	Set to the size of the BAR on success (optional).
+ * @return
+ *	The virtual address of the BAR, NULL if the BAR is not an accessible
+ *	memory BAR.
+ */
+void *pci_bar_map(struct pci_device *dev, uint8_t bar, __sz *len);
+
+/**
+ * Switch a PCI device to MSI-X interrupts and allocate a platform IRQ for
+ * each vector. Legacy interrupts (INTx) of the device are disabled.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param irqs
+ *	Array that is filled with the IRQ number of each vector.
+ * @param nr
+ *	The number of vectors to enable.
+ * @return
+ *	0 on success,
+ *	-ENOTSUP if the device does not support MSI-X with nr vectors,
+ *	-ENOSPC if the platform ran out of IRQs.
+ */
+int pci_msix_enable(struct pci_device *dev, unsigned long *irqs, uint16_t nr);
+
+/**
+ * Disable the MSI-X vectors of a PCI device that were enabled with
+ * pci_msix_enable() and release their IRQs. Interrupt handlers have to be
+ * unregistered before. Legacy interrupts (INTx) of the device are enabled
+ * again.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param irqs
+ *	The IRQ numbers returned by pci_msix_enable().
+ */
+void pci_msix_disable(struct pci_device *dev, const unsigned long *irqs);
+
+/**
+ * Switch a PCI device to a single MSI interrupt. Legacy interrupts (INTx) of
+ * the device are disabled.
+ * @param dev
+ *	Reference to the PCI device.
+ * @param irq
+ *	Set to the IRQ number of the interrupt.
+ * @return
+ *	0 on success,
+ *	-ENOTSUP if the device does not support MSI,
+ *	-ENOSPC if the platform ran out of IRQs.
+ */
+int pci_msi_enable(struct pci_device *dev, unsigned long *irq);
+
 
 #define PCI_REGISTER_DRIVER(b)                  \
 	_PCI_REGISTER_DRIVER(__LIBNAME__, b)
@@ -33,6 +33,7 @@
 #ifndef __PLAT_CMN_IRQ_H__
 #define __PLAT_CMN_IRQ_H__
 
+#include <uk/arch/types.h>
 #include <uk/plat/irq.h>
 
 #if defined(__X86_64__)
@@ -59,4 +60,26 @@ enum uk_irq_polarity {
 	UK_IRQ_POLARITY_MAX
 };
 
+/**
+ * Allocate an IRQ for a message-signaled interrupt (MSI/MSI-X) and compose
+ * the message that raises it. Provided by platforms with PCI support.
+ * @param irq
+ *	Set to the IRQ number that handlers are registered for.
+ * @param msg_addr
+ *	Set to the message address that the device has to write to.
+ * @param msg_data
+ *	Set to the message data that the device has to write.
+ * @return
+ *	0 on success, -ENOSPC if there are no more IRQs available.
+ */
+int _ukplat_msi_alloc(unsigned long *irq, __u64 *msg_addr, __u32 *msg_data);
+
+/**
+ * Release an IRQ of a message-signaled interrupt. The device must not
+ * signal the interrupt anymore.
+ * @param irq
+ *	The IRQ number returned by _ukplat_msi_alloc().
+ */
+void _ukplat_msi_free(unsigned long irq);
+
 #endif /* __PLAT_CMN_IRQ_H__ */
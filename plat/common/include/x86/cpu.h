@@ -257,6 +257,47 @@ static inline void outl(__u16 port, __u32 v)
 	__asm__ __volatile__("outl %0,%1" : : "a" (v), "dN" (port));
 }
 
+/* accessing devices via memory-mapped registers */
+static inline __u8 ioreg_read8(const volatile __u8 *address)
+{
+	return *address;
+}
+
+static inline __u16 ioreg_read16(const volatile __u16 *address)
+{
+	return *address;
+}
+
+static inline __u32 ioreg_read32(const volatile __u32 *address)
+{
+	return *address;
+}
+
+static inline __u64 ioreg_read64(const volatile __u64 *address)
+{
+	return *address;
+}
+
+static inline void ioreg_write8(const volatile __u8 *address, __u8 value)
+{
+	*(volatile __u8 *) address = value;
+}
+
+static inline void ioreg_write16(const volatile __u16 *address, __u16 value)
+{
+	*(volatile __u16 *) address = value;
+}
+
+static inline void ioreg_write32(const volatile __u32 *address, __u32 value)
+{
+	*(volatile __u32 *) address = value;
+}
+
+static inline void ioreg_write64(const volatile __u64 *address, __u64 value)
+{
+	*(volatile __u64 *) address = value;
+}
+
 static inline __u64 mul64_32(__u64 a, __u32 b)
 {
 	__u64 prod;
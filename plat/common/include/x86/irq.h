@@ -84,6 +84,7 @@ static inline int irqs_disabled(void)
 #define local_irq_disable()      __cli()
 #define local_irq_enable()       __sti()
 
-#define __MAX_IRQ	16
+/* IRQs 0-15 are the legacy PIC lines, the others are message-signaled */
+#define __MAX_IRQ	48
 
 #endif /* __PLAT_CMN_X86_IRQ_H__ */
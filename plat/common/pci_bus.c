@@ -54,6 +54,7 @@
 #include <string.h>
 #include <uk/print.h>
 #include <uk/plat/common/cpu.h>
+#include <uk/plat/common/irq.h>
 #include <pci/pci_bus.h>
 
 struct pci_bus_handler {
@@ -130,6 +131,328 @@ static struct pci_bus_handler ph;
 		*(ret) = (type) _conf_data;				\
 	} while (0)
 
+/*
+ * The 32-bit PCI memory hole is identity mapped by the platform, so BARs
+ * located in this range can be accessed directly.
+ */
+#define PCI_MMIO_HOLE_START         (0xC0000000UL)
+#define PCI_MMIO_HOLE_END           (0x100000000UL)
+
+static inline uint32_t pci_device_config_addr(struct pci_device *dev)
+{
+	return (PCI_ENABLE_BIT)
+		| (dev->addr.bus << PCI_BUS_SHIFT)
+		| (dev->addr.devid << PCI_DEVICE_SHIFT)
+		| (dev->addr.function << PCI_FUNCTION_SHIFT);
+}
+
+uint8_t pci_config_read8(struct pci_device *dev, uint8_t offset)
+{
+	UK_ASSERT(dev != NULL);
+
+	outl(PCI_CONFIG_ADDR, pci_device_config_addr(dev) | (offset & ~0x3));
+	return inb(PCI_CONFIG_DATA + (offset & 0x3));
+}
+
+uint16_t pci_config_read16(struct pci_device *dev, uint8_t offset)
+{
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT((offset & 0x1) == 0);
+
+	outl(PCI_CONFIG_ADDR, pci_device_config_addr(dev) | (offset & ~0x3));
+	return inw(PCI_CONFIG_DATA + (offset & 0x2));
+}
+
+uint32_t pci_config_read32(struct pci_device *dev, uint8_t offset)
+{
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT((offset & 0x3) == 0);
+
+	outl(PCI_CONFIG_ADDR, pci_device_config_addr(dev) | offset);
+	return inl(PCI_CONFIG_DATA);
+}
+
+void pci_config_write16(struct pci_device *dev, uint8_t offset, uint16_t val)
+{
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT((offset & 0x1) == 0);
+
+	outl(PCI_CONFIG_ADDR, pci_device_config_addr(dev) | (offset & ~0x3));
+	outw(PCI_CONFIG_DATA + (offset & 0x2), val);
+}
+
+void pci_config_write32(struct pci_device *dev, uint8_t offset, uint32_t val)
+{
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT((offset & 0x3) == 0);
+
+	outl(PCI_CONFIG_ADDR, pci_device_config_addr(dev) | offset);
+	outl(PCI_CONFIG_DATA, val);
+}
+
+uint8_t pci_cap_next(struct pci_device *dev, uint8_t cap_id, uint8_t pos)
+{
+	/* Bound the walk in case of a malformed (cyclic) list */
+	int ttl = 48;
+
+	if (!pos) {
+		if (!(pci_config_read16(dev, PCI_STATUS) & PCI_STATUS_CAP_LIST))
+			return 0;
+		pos = pci_config_read8(dev, PCI_CAPABILITY_LIST);
+	} else {
+		pos = pci_config_read8(dev, pos + 1);
+	}
+
+	while (pos >= 0x40 && ttl--) {
+		pos &= ~0x3;
+		if (pci_config_read8(dev, pos) == cap_id)
+			return pos;
+		pos = pci_config_read8(dev, pos + 1);
+	}
+	return 0;
+}
+
+void *pci_bar_map(struct pci_device *dev, uint8_t bar, __sz *len)
+{
+	uint8_t offset = PCI_BASE_ADDRESS_0 + bar * 4;
+	uint64_t addr, size;
+	uint32_t lo, hi = 0;
+	uint16_t cmd;
+	int is64;
+
+	UK_ASSERT(dev != NULL);
+
+	if (bar >= PCI_MAX_BARS)
+		return NULL;
+
+	lo = pci_config_read32(dev, offset);
+	if (lo & PCI_BASE_ADDRESS_SPACE_IO)
+		return NULL;
+
+	is64 = (lo & PCI_BASE_ADDRESS_MEM_TYPE_64) && bar + 1 < PCI_MAX_BARS;
+	if (is64)
+		hi = pci_config_read32(dev, offset + 4);
+	addr = (((uint64_t) hi << 32) | lo) & PCI_BASE_ADDRESS_MEM_MASK;
+
+	/* Size the BAR with decoding disabled */
+	cmd = pci_config_read16(dev, PCI_COMMAND);
+	pci_config_write16(dev, PCI_COMMAND,
+			   cmd & ~(PCI_COMMAND_IO | PCI_COMMAND_MEMORY));
+	pci_config_write32(dev, offset, ~0U);
+	size = pci_config_read32(dev, offset);
+	pci_config_write32(dev, offset, lo);
+	if (is64) {
+		pci_config_write32(dev, offset + 4, ~0U);
+		size |= (uint64_t) pci_config_read32(dev, offset + 4) << 32;
+		pci_config_write32(dev, offset + 4, hi);
+	} else {
+		size |= 0xFFFFFFFF00000000ULL;
+	}
+	pci_config_write16(dev, PCI_COMMAND, cmd);
+	size = ~(size & PCI_BASE_ADDRESS_MEM_MASK) + 1;
+
+	if (!addr || addr < PCI_MMIO_HOLE_START
+	    || size > PCI_MMIO_HOLE_END - addr) {
+		uk_pr_err("PCI %02x:%02x.%02x: BAR%d at 0x%"__PRIx64" (size 0x%"__PRIx64") is not accessible\n",
+			  (int) dev->addr.bus,
+			  (int) dev->addr.devid,
+			  (int) dev->addr.function,
+			  (int) bar, addr, size);
+		return NULL;
+	}
+
+	if (len)
+		*len = size;
+	return (void *)(uintptr_t) addr;
+}
+
+/* MSI capability */
+#define PCI_MSI_FLAGS               (0x02)    /* 16-bit */
+#define PCI_MSI_FLAGS_ENABLE        (0x1)
+#define PCI_MSI_FLAGS_QSIZE         (0x70)
+#define PCI_MSI_FLAGS_64BIT         (0x80)
+#define PCI_MSI_ADDRESS_LO          (0x04)    /* 32-bit */
+#define PCI_MSI_ADDRESS_HI          (0x08)    /* 32-bit, 64-bit only */
+#define PCI_MSI_DATA_32             (0x08)    /* 16-bit */
+#define PCI_MSI_DATA_64             (0x0C)    /* 16-bit */
+
+/* MSI-X capability */
+#define PCI_MSIX_FLAGS              (0x02)    /* 16-bit */
+#define PCI_MSIX_FLAGS_QSIZE        (0x07FF)
+#define PCI_MSIX_FLAGS_MASKALL      (0x4000)
+#define PCI_MSIX_FLAGS_ENABLE       (0x8000)
+#define PCI_MSIX_TABLE              (0x04)    /* 32-bit */
+#define PCI_MSIX_TABLE_BIR          (0x7)
+
+/* MSI-X table entry: 4 dwords */
+#define PCI_MSIX_ENTRY_DWORDS       (4)
+#define PCI_MSIX_ENTRY_ADDR_LO      (0)
+#define PCI_MSIX_ENTRY_ADDR_HI      (1)
+#define PCI_MSIX_ENTRY_DATA         (2)
+#define PCI_MSIX_ENTRY_CTRL         (3)
+#define PCI_MSIX_ENTRY_CTRL_MASKBIT (0x1)
+
+/* Mask the first nr entries of a MSI-X table and release their vectors */
+static void pci_msix_release(volatile uint32_t *table,
+			     const unsigned long *irqs, uint16_t nr)
+{
+	volatile uint32_t *entry;
+
+	while (nr-- > 0) {
+		entry = &table[nr * PCI_MSIX_ENTRY_DWORDS];
+		ioreg_write32(&entry[PCI_MSIX_ENTRY_CTRL],
+			      ioreg_read32(&entry[PCI_MSIX_ENTRY_CTRL])
+			      | PCI_MSIX_ENTRY_CTRL_MASKBIT);
+		_ukplat_msi_free(irqs[nr]);
+	}
+}
+
+int pci_msix_enable(struct pci_device *dev, unsigned long *irqs, uint16_t nr)
+{
+	volatile uint32_t *table, *entry;
+	uint32_t table_info, msg_data;
+	uint64_t msg_addr;
+	uint16_t flags, cmd, i;
+	uint8_t cap;
+	__sz bar_len;
+	int rc;
+
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(irqs != NULL);
+
+	cap = pci_cap_next(dev, PCI_CAP_ID_MSIX, 0);
+	if (!cap)
+		return -ENOTSUP;
+
+	flags = pci_config_read16(dev, cap + PCI_MSIX_FLAGS);
+	if (nr == 0 || nr > (flags & PCI_MSIX_FLAGS_QSIZE) + 1)
+		return -ENOTSUP;
+
+	table_info = pci_config_read32(dev, cap + PCI_MSIX_TABLE);
+	table = pci_bar_map(dev, table_info & PCI_MSIX_TABLE_BIR, &bar_len);
+	if (!table)
+		return -ENOTSUP;
+	table_info &= ~PCI_MSIX_TABLE_BIR;
+	if (table_info + nr * PCI_MSIX_ENTRY_DWORDS * sizeof(*table)
+	    > bar_len)
+		return -ENOTSUP;
+	table = (volatile uint32_t *)((uintptr_t) table + table_info);
+
+	/* Keep all vectors masked while the table is programmed */
+	pci_config_write16(dev, cap + PCI_MSIX_FLAGS,
+			   flags | PCI_MSIX_FLAGS_ENABLE
+			   | PCI_MSIX_FLAGS_MASKALL);
+	cmd = pci_config_read16(dev, PCI_COMMAND);
+	pci_config_write16(dev, PCI_COMMAND, cmd | PCI_COMMAND_MEMORY);
+
+	for (i = 0; i < nr; i++) {
+		rc = _ukplat_msi_alloc(&irqs[i], &msg_addr, &msg_data);
+		if (rc < 0) {
+			uk_pr_err("PCI %02x:%02x.%02x: Failed to allocate MSI-X vector %"__PRIu16": %d\n",
+				  (int) dev->addr.bus,
+				  (int) dev->addr.devid,
+				  (int) dev->addr.function,
+				  i, rc);
+			goto err_free;
+		}
+		entry = &table[i * PCI_MSIX_ENTRY_DWORDS];
+		ioreg_write32(&entry[PCI_MSIX_ENTRY_ADDR_LO],
+			      (uint32_t) msg_addr);
+		ioreg_write32(&entry[PCI_MSIX_ENTRY_ADDR_HI],
+			      (uint32_t) (msg_addr >> 32));
+		ioreg_write32(&entry[PCI_MSIX_ENTRY_DATA], msg_data);
+		ioreg_write32(&entry[PCI_MSIX_ENTRY_CTRL],
+			      ioreg_read32(&entry[PCI_MSIX_ENTRY_CTRL])
+			      & ~PCI_MSIX_ENTRY_CTRL_MASKBIT);
+	}
+
+	dev->msix_table = table;
+	dev->msix_nr = nr;
+
+	pci_config_write16(dev, PCI_COMMAND,
+			   pci_config_read16(dev, PCI_COMMAND)
+			   | PCI_COMMAND_INTX_DISABLE);
+	pci_config_write16(dev, cap + PCI_MSIX_FLAGS,
+			   (flags | PCI_MSIX_FLAGS_ENABLE)
+			   & ~PCI_MSIX_FLAGS_MASKALL);
+	return 0;
+
+err_free:
+	/* Mask and release the vectors that were programmed already */
+	pci_msix_release(table, irqs, i);
+	pci_config_write16(dev, PCI_COMMAND, cmd);
+	pci_config_write16(dev, cap + PCI_MSIX_FLAGS,
+			   flags & ~PCI_MSIX_FLAGS_ENABLE);
+	return rc;
+}
+
+void pci_msix_disable(struct pci_device *dev, const unsigned long *irqs)
+{
+	uint16_t flags;
+	uint8_t cap;
+
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(irqs != NULL);
+	UK_ASSERT(dev->msix_table != NULL);
+
+	cap = pci_cap_next(dev, PCI_CAP_ID_MSIX, 0);
+	UK_ASSERT(cap);
+
+	flags = pci_config_read16(dev, cap + PCI_MSIX_FLAGS);
+	pci_config_write16(dev, cap + PCI_MSIX_FLAGS,
+			   flags | PCI_MSIX_FLAGS_MASKALL);
+	pci_msix_release(dev->msix_table, irqs, dev->msix_nr);
+	pci_config_write16(dev, cap + PCI_MSIX_FLAGS,
+			   flags & ~(PCI_MSIX_FLAGS_ENABLE
+				     | PCI_MSIX_FLAGS_MASKALL));
+	/* Hand the interrupts back to the legacy line */
+	pci_config_write16(dev, PCI_COMMAND,
+			   pci_config_read16(dev, PCI_COMMAND)
+			   & ~PCI_COMMAND_INTX_DISABLE);
+
+	dev->msix_table = NULL;
+	dev->msix_nr = 0;
+}
+
+int pci_msi_enable(struct pci_device *dev, unsigned long *irq)
+{
+	uint32_t msg_data;
+	uint64_t msg_addr;
+	uint16_t flags;
+	uint8_t cap;
+	int rc;
+
+	UK_ASSERT(dev != NULL);
+	UK_ASSERT(irq != NULL);
+
+	cap = pci_cap_next(dev, PCI_CAP_ID_MSI, 0);
+	if (!cap)
+		return -ENOTSUP;
+
+	rc = _ukplat_msi_alloc(irq, &msg_addr, &msg_data);
+	if (rc < 0)
+		return rc;
+
+	flags = pci_config_read16(dev, cap + PCI_MSI_FLAGS);
+	pci_config_write32(dev, cap + PCI_MSI_ADDRESS_LO, (uint32_t) msg_addr);
+	if (flags & PCI_MSI_FLAGS_64BIT) {
+		pci_config_write32(dev, cap + PCI_MSI_ADDRESS_HI,
+				   (uint32_t) (msg_addr >> 32));
+		pci_config_write16(dev, cap + PCI_MSI_DATA_64, msg_data);
+	} else {
+		pci_config_write16(dev, cap + PCI_MSI_DATA_32, msg_data);
+	}
+
+	pci_config_write16(dev, PCI_COMMAND,
+			   pci_config_read16(dev, PCI_COMMAND)
+			   | PCI_COMMAND_INTX_DISABLE);
+	/* We use a single message */
+	pci_config_write16(dev, cap + PCI_MSI_FLAGS,
+			   (flags & ~PCI_MSI_FLAGS_QSIZE)
+			   | PCI_MSI_FLAGS_ENABLE);
+	return 0;
+}
+
 static inline int pci_device_id_match(const struct pci_device_id *id0,
 					const struct pci_device_id *id1)
 {
@@ -215,9 +538,7 @@ static inline int pci_driver_add_device(struct pci_driver *drv,
 	memcpy(&dev->addr, addr,  sizeof(dev->addr));
 	dev->drv = drv;
 
-	config_addr = (PCI_ENABLE_BIT)
-			| (addr->bus << PCI_BUS_SHIFT)
-			| (addr->devid << PCI_DEVICE_SHIFT);
+	config_addr = pci_device_config_addr(dev);
 	PCI_CONF_READ(uint16_t, &dev->base, config_addr, IOBAR);
 	PCI_CONF_READ(uint8_t, &dev->irq, config_addr, IRQ);
 
@@ -91,7 +91,7 @@ struct virtio_config_ops {
 	/** Get the feature */
 	__u64 (*features_get)(struct virtio_dev *vdev);
 	/** Set the feature */
-	void (*features_set)(struct virtio_dev *vdev, __u64 features);
+	int (*features_set)(struct virtio_dev *vdev, __u64 features);
 	/** Get and Set Status */
 	__u8 (*status_get)(struct virtio_dev *vdev);
 	void (*status_set)(struct virtio_dev *vdev, __u8 status);
@@ -216,13 +216,28 @@ static inline __u64 virtio_feature_get(struct virtio_dev *vdev)
  *	Reference to the virtio device.
  * @param feature
  *	A bit map of the feature negotiated.
+ * @return
+ *	0 on success.
+ *	-ENOTSUP, if the device does not accept the features or the
+ *	operation is not supported on the virtio device.
  */
-static inline void virtio_feature_set(struct virtio_dev *vdev, __u32 feature)
+static inline int virtio_feature_set(struct virtio_dev *vdev, __u64 feature)
 {
+	__u64 ring_features;
+	int rc = -ENOTSUP;
+
 	UK_ASSERT(vdev);
 
+	/**
+	 * Ring features are accepted on behalf of the driver whenever the
+	 * device offers them.
+	 */
+	ring_features = virtio_feature_get(vdev) & VIRTQUEUE_FEATURES;
+	vdev->features |= ring_features;
+
 	if (likely(vdev->cops->features_set))
-		vdev->cops->features_set(vdev, feature);
+		rc = vdev->cops->features_set(vdev, feature | ring_features);
+	return rc;
 }
 
 /**
@@ -34,8 +34,7 @@
 extern "C" {
 #endif /* __cplusplus __ */
 
-/* virtio config space layout */
-/* TODO we currently support only the legacy interface */
+/* virtio config space layout (legacy interface) */
 #define VIRTIO_PCI_HOST_FEATURES        0    /* 32-bit r/o */
 #define VIRTIO_PCI_GUEST_FEATURES       4    /* 32-bit r/w */
 #define VIRTIO_PCI_QUEUE_PFN            8    /* 32-bit r/w */
@@ -63,10 +62,61 @@ extern "C" {
 #define VIRTIO_PCI_ISR_HAS_INTR         0x1  /* interrupt is for this device */
 #define VIRTIO_PCI_ISR_CONFIG           0x2  /* config change bit */
 
-/* TODO Revisit when adding MSI support. */
-#define VIRTIO_PCI_CONFIG_OFF           20
+/*
+ * With MSI-X enabled, the legacy layout carries the vector registers and the
+ * device configuration moves behind them.
+ */
+#define VIRTIO_MSI_CONFIG_VECTOR        20   /* 16-bit r/w */
+#define VIRTIO_MSI_QUEUE_VECTOR         22   /* 16-bit r/w */
+#define VIRTIO_MSI_NO_VECTOR            0xffff
+
+#define VIRTIO_PCI_CONFIG_OFF(msix_enabled) ((msix_enabled) ? 24 : 20)
 #define VIRTIO_PCI_VRING_ALIGN          4096
 
+/*
+ * Non-legacy interface: the device exposes its register blocks through
+ * vendor-specific PCI capabilities pointing into memory BARs.
+ */
+/* Common configuration */
+#define VIRTIO_PCI_CAP_COMMON_CFG       1
+/* Notifications */
+#define VIRTIO_PCI_CAP_NOTIFY_CFG       2
+/* ISR Status */
+#define VIRTIO_PCI_CAP_ISR_CFG          3
+/* Device specific configuration */
+#define VIRTIO_PCI_CAP_DEVICE_CFG       4
+/* PCI configuration access */
+#define VIRTIO_PCI_CAP_PCI_CFG          5
+
+/* Offsets of the fields of the virtio PCI capability */
+#define VIRTIO_PCI_CAP_CFG_TYPE         3    /* 8-bit */
+#define VIRTIO_PCI_CAP_BAR              4    /* 8-bit */
+#define VIRTIO_PCI_CAP_OFFSET           8    /* 32-bit */
+#define VIRTIO_PCI_CAP_LENGTH           12   /* 32-bit */
+/* Only for VIRTIO_PCI_CAP_NOTIFY_CFG */
+#define VIRTIO_PCI_NOTIFY_CAP_MULT      16   /* 32-bit */
+
+/* Common configuration layout */
+#define VIRTIO_PCI_COMMON_DFSELECT      0    /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_DF            4    /* 32-bit r/o */
+#define VIRTIO_PCI_COMMON_GFSELECT      8    /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_GF            12   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_MSIX          16   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_NUMQ          18   /* 16-bit r/o */
+#define VIRTIO_PCI_COMMON_STATUS        20   /* 8-bit r/w */
+#define VIRTIO_PCI_COMMON_CFGGENERATION 21   /* 8-bit r/o */
+#define VIRTIO_PCI_COMMON_Q_SELECT      22   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_SIZE        24   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_MSIX        26   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_ENABLE      28   /* 16-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_NOFF        30   /* 16-bit r/o */
+#define VIRTIO_PCI_COMMON_Q_DESCLO      32   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_DESCHI      36   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_AVAILLO     40   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_AVAILHI     44   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_USEDLO      48   /* 32-bit r/w */
+#define VIRTIO_PCI_COMMON_Q_USEDHI      52   /* 32-bit r/w */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus __ */
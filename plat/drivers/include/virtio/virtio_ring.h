@@ -81,6 +81,24 @@ extern "C" {
 /* Arbitrary descriptor layouts. */
 #define VIRTIO_F_ANY_LAYOUT       27
 
+/* Support for the packed virtqueue layout */
+#define VIRTIO_F_RING_PACKED      34
+
+/*
+ * Mark a descriptor as available or used in the packed layout. The driver
+ * and the device flip the meaning of the bits on every ring wrap-around.
+ */
+#define VRING_PACKED_DESC_F_AVAIL       (1 << 7)
+#define VRING_PACKED_DESC_F_USED        (1 << 15)
+
+/* Event suppression flags of the packed layout */
+#define VRING_PACKED_EVENT_FLAG_ENABLE  0x0
+#define VRING_PACKED_EVENT_FLAG_DISABLE 0x1
+/* Only with VIRTIO_F_EVENT_IDX: signal at the descriptor in off_wrap */
+#define VRING_PACKED_EVENT_FLAG_DESC    0x2
+/* Position of the wrap counter in the off_wrap field */
+#define VRING_PACKED_EVENT_F_WRAP_CTR   15
+
 /**
  * Virtqueue descriptors: 16 bytes.
  * These can chain together via "next".
@@ -157,7 +175,9 @@ struct vring {
  * versa. They are at the end for backwards compatibility.
  */
 #define vring_used_event(vr) ((vr)->avail->ring[(vr)->num])
-#define vring_avail_event(vr) (*(__virtio16 *)&(vr)->used->ring[(vr)->num])
+#define vring_avail_event(vr) \
+	(*(__virtio_le16 *)((__u8 *)(vr)->used->ring \
+			    + (vr)->num * sizeof(struct vring_used_elem)))
 
 static inline void vring_init(struct vring *vr, unsigned int num, uint8_t *p,
 			      unsigned long align)
@@ -183,6 +203,67 @@ static inline unsigned int vring_size(unsigned int num, unsigned long align)
 	return size;
 }
 
+/**
+ * Packed virtqueue descriptors: 16 bytes.
+ * The buffer id is written back by the device for a used descriptor chain.
+ */
+struct vring_packed_desc {
+	/* Address (guest-physical). */
+	__virtio_le64 addr;
+	/* Length. */
+	__virtio_le32 len;
+	/* Buffer id. */
+	__virtio_le16 id;
+	/* The flags as indicated above. */
+	__virtio_le16 flags;
+};
+
+/* Driver and device event suppression structure of the packed layout */
+struct vring_packed_desc_event {
+	/* Descriptor ring change event offset and wrap counter */
+	__virtio_le16 off_wrap;
+	/* Descriptor ring change event flags */
+	__virtio_le16 flags;
+};
+
+struct vring_packed {
+	unsigned int num;
+
+	struct vring_packed_desc *desc;
+	struct vring_packed_desc_event *driver;
+	struct vring_packed_desc_event *device;
+};
+
+/* The packed layout places the event suppression structures right after
+ * the descriptor ring:
+ *
+ * struct vring_packed {
+ *      // The descriptor ring (16 bytes each)
+ *      struct vring_packed_desc desc[num];
+ *
+ *      // Driver event suppression (written by the driver)
+ *      struct vring_packed_desc_event driver;
+ *
+ *      // Device event suppression (written by the device)
+ *      struct vring_packed_desc_event device;
+ * };
+ */
+static inline void vring_packed_init(struct vring_packed *vr,
+				     unsigned int num, uint8_t *p)
+{
+	vr->num = num;
+	vr->desc = (struct vring_packed_desc *) p;
+	vr->driver = (struct vring_packed_desc_event *) (p +
+			num * sizeof(struct vring_packed_desc));
+	vr->device = vr->driver + 1;
+}
+
+static inline unsigned int vring_packed_size(unsigned int num)
+{
+	return num * sizeof(struct vring_packed_desc) +
+		2 * sizeof(struct vring_packed_desc_event);
+}
+
 static inline int vring_need_event(__u16 event_idx, __u16 new_idx,
 				   __u16 old_idx)
 {
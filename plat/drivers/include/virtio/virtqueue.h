@@ -70,6 +70,25 @@ struct virtqueue {
 	void *priv;
 };
 
+/**
+ * Transport features that are supported by the virtqueue implementation.
+ * They are negotiated on behalf of the device drivers.
+ */
+#if CONFIG_VIRTIO_INDIRECT_DESC_MAX > 0
+#define VIRTQUEUE_FEATURES ((1ULL << VIRTIO_F_EVENT_IDX) | \
+			    (1ULL << VIRTIO_F_RING_PACKED) | \
+			    (1ULL << VIRTIO_F_INDIRECT_DESC))
+#else
+#define VIRTQUEUE_FEATURES ((1ULL << VIRTIO_F_EVENT_IDX) | \
+			    (1ULL << VIRTIO_F_RING_PACKED))
+#endif
+
+/**
+ * Suggested minimum number of segments of a request to use an indirect
+ * descriptor table for it
+ */
+#define VIRTQUEUE_INDIRECT_THRESHOLD_DEFAULT 2
+
 /**
  * Fetch the physical address of the descriptor ring.
  * @param vq
@@ -80,6 +99,22 @@ struct virtqueue {
  */
 __phys_addr virtqueue_physaddr(struct virtqueue *vq);
 
+/**
+ * Fetch the physical addresses of the areas of the virtqueue, as they are
+ * programmed separately into a non-legacy device. For the packed layout,
+ * the driver and device areas are the event suppression structures.
+ * @param vq
+ *	Reference to the virtqueue.
+ * @param desc
+ *	Set to the guest physical address of the descriptor area.
+ * @param driver
+ *	Set to the guest physical address of the driver area.
+ * @param device
+ *	Set to the guest physical address of the device area.
+ */
+void virtqueue_ring_addrs(struct virtqueue *vq, __phys_addr *desc,
+			  __phys_addr *driver, __phys_addr *device);
+
 /**
  * Ring interrupt handler. This function is invoked from the interrupt handler
  * in the virtio device for interrupt specific to the ring.
@@ -104,7 +139,8 @@ int virtqueue_ring_interrupt(void *obj);
 __u64 virtqueue_feature_negotiate(__u64 feature_set);
 
 /**
- * Check if host notification is enabled.
+ * Check if host notification is enabled. With event indexes, this function
+ * considers all entries that were added since it was called the last time.
  *
  * @param vq
  *	Reference to the virtqueue.
@@ -186,6 +222,26 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 				   virtqueue_notify_host_t notify,
 				   struct virtio_dev *vdev, struct uk_alloc *a);
 
+/**
+ * Set the minimum number of segments from which on requests are enqueued
+ * with an indirect descriptor table. Indirect descriptors are disabled
+ * until a driver enables them; the tables are allocated at that time. The
+ * setting has no effect if indirect descriptors were not negotiated with
+ * the device.
+ * @param vq
+ *	A reference to the virtqueue.
+ * @param threshold
+ *	Minimum number of segments, 0 disables indirect descriptors.
+ * @param a
+ *	The allocator for the indirect tables. It has to be the allocator
+ *	of the virtqueue, as the tables are released with it.
+ * @return
+ *	0 on success.
+ *	-ENOMEM if the indirect tables could not be allocated.
+ */
+int virtqueue_indirect_threshold_set(struct virtqueue *vq, __u16 threshold,
+				     struct uk_alloc *a);
+
 /**
  * Check the virtqueue if full.
  * @param vq
@@ -236,8 +292,11 @@ int virtqueue_intr_enable(struct virtqueue *vq);
  * Notify the host of an event.
  * @param vq
  *      Reference to the virtual queue.
+ * @return
+ *	1, The host was notified.
+ *	0, The notification was suppressed by the host.
  */
-static inline void virtqueue_host_notify(struct virtqueue *vq)
+static inline int virtqueue_host_notify(struct virtqueue *vq)
 {
 	UK_ASSERT(vq);
 
@@ -251,7 +310,9 @@ static inline void virtqueue_host_notify(struct virtqueue *vq)
 	if (vq->vq_notify_host && virtqueue_notify_enabled(vq)) {
 		uk_pr_debug("notify queue %d\n", vq->queue_id);
 		vq->vq_notify_host(vq->vdev, vq->queue_id);
+		return 1;
 	}
+	return 0;
 }
 
 #ifdef __cplusplus
@@ -322,6 +322,14 @@ static int virtio_9p_vq_alloc(struct virtio_9p_device *d)
 		uk_pr_err(DRIVER_NAME": Failed to set up virtqueue %"PRIu16"\n",
 			  d->hwvq_id);
 		rc = PTR2ERR(d->vq);
+		goto exit;
+	}
+
+	rc = virtqueue_indirect_threshold_set(d->vq,
+			VIRTQUEUE_INDIRECT_THRESHOLD_DEFAULT, a);
+	if (unlikely(rc < 0)) {
+		virtio_vqueue_release(d->vdev, d->vq, a);
+		goto exit;
 	}
 
 	d->vq->priv = d;
@@ -369,7 +377,9 @@ static int virtio_9p_feature_negotiate(struct virtio_9p_device *d)
 	d->tag[tag_len] = '\0';
 
 	d->vdev->features &= host_features;
-	virtio_feature_set(d->vdev, d->vdev->features);
+	rc = virtio_feature_set(d->vdev, d->vdev->features);
+	if (unlikely(rc < 0))
+		goto free_mem;
 	return 0;
 
 free_mem:
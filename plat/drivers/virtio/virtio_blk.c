@@ -470,6 +470,7 @@ static int virtio_blkdev_vqueue_setup(struct uk_blkdev_queue *queue,
 {
 	uint16_t max_desc;
 	struct virtqueue *vq;
+	int rc;
 
 	UK_ASSERT(queue);
 	max_desc = queue->max_nb_desc;
@@ -496,6 +497,14 @@ static int virtio_blkdev_vqueue_setup(struct uk_blkdev_queue *queue,
 		return PTR2ERR(vq);
 	}
 
+	/* Requests consist of a header, the data segments and a status */
+	rc = virtqueue_indirect_threshold_set(vq,
+			VIRTQUEUE_INDIRECT_THRESHOLD_DEFAULT, a);
+	if (unlikely(rc < 0)) {
+		virtio_vqueue_release(queue->vbd->vdev, vq, a);
+		return rc;
+	}
+
 	queue->vq = vq;
 	vq->priv = queue;
 
@@ -843,7 +852,7 @@ static int virtio_blkdev_feature_negotiate(struct virtio_blk_device *vbdev)
 	 * Mask out features supported by both driver and device.
 	 */
 	vbdev->vdev->features &= host_features;
-	virtio_feature_set(vbdev->vdev, vbdev->vdev->features);
+	rc = virtio_feature_set(vbdev->vdev, vbdev->vdev->features);
 
 exit:
 	return rc;
@@ -42,14 +42,25 @@
 #include <virtio/virtio_net.h>
 
 /**
- * VIRTIO_PKT_BUFFER_LEN = VIRTIO_NET_HDR + ETH_HDR + ETH_PKT_PAYLOAD_LEN
+ * VIRTIO_PKT_BUFFER_LEN = VIRTIO_NET_HDR + ETH_HDR + MTU
  * VIRTIO_NET_HDR: 10 bytes in length in legacy mode + 2 byte of padded data.
  *		   12 bytes in length in modern mode.
  */
 #define VIRTIO_HDR_LEN          12
-#define VIRTIO_PKT_BUFFER_LEN ((UK_ETH_PAYLOAD_MAXLEN) \
-			       + (UK_ETH_HDR_UNTAGGED_LEN) \
-			       + (VIRTIO_HDR_LEN))
+#define VIRTIO_PKT_BUFFER_LEN(mtu) ((mtu) \
+				    + (UK_ETH_HDR_UNTAGGED_LEN) \
+				    + (VIRTIO_HDR_LEN))
+/**
+ * Smallest MTU that we accept (minimum IPv4 datagram size)
+ */
+#define VIRTIO_NET_MIN_MTU      68
+/**
+ * Maximum length of a packet that is handed to the device for segmentation:
+ * VIRTIO_NET_HDR + ETH_HDR + maximum IP packet
+ */
+#define VIRTIO_GSO_PKT_BUFFER_LEN ((__U16_MAX) \
+				   + (UK_ETH_HDR_UNTAGGED_LEN) \
+				   + (VIRTIO_HDR_LEN))
 
 #define DRIVER_NAME           "virtio-net"
 
@@ -68,8 +79,28 @@
 #define to_virtionetdev(ndev) \
 	__containerof(ndev, struct virtio_net_device, netdev)
 
+#ifdef CONFIG_LIBUKNETDEV_STATS
+#define VTNET_XSTAT_ADD(queue, field, val) ((queue)->xstats.field += (val))
+/* Number of driver-specific counters per receive-transmit queue pair */
+#define VTNET_XSTATS_PER_QUEUE_PAIR (4)
+#else
+#define VTNET_XSTAT_ADD(queue, field, val) do {} while (0)
+#endif
+
 #define VIRTIO_NET_DRV_FEATURES(features)           \
-	(VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_MAC))
+	(VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_MAC),	\
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_MTU),	\
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_MRG_RXBUF), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_CTRL_VQ), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_MQ),	\
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_CSUM),	\
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_GUEST_CSUM), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_HOST_TSO4), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_HOST_TSO6), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_HOST_ECN), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_GUEST_TSO4), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_GUEST_TSO6), \
+	 VIRTIO_FEATURES_UPDATE(features, VIRTIO_NET_F_GUEST_ECN))
 
 typedef enum {
 	VNET_RX,
@@ -108,6 +139,13 @@ struct uk_netdev_tx_queue {
 	/* The scatter list and its associated fragements */
 	struct uk_sglist sg;
 	struct uk_sglist_seg sgsegs[NET_MAX_FRAGMENTS];
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	/* Driver-specific counters */
+	struct {
+		__u64 reclaimed;
+		__u64 notify_suppressed;
+	} xstats;
+#endif
 };
 
 /**
@@ -126,6 +164,10 @@ struct uk_netdev_rx_queue {
 	uint16_t nb_desc;
 	/* The flag to interrupt on the transmit queue */
 	uint8_t intr_enabled;
+	/* Packets may span multiple receive buffers */
+	uint8_t mrg_rxbuf;
+	/* Length of the virtio-net header */
+	uint8_t hdr_len;
 	/* User-provided receive buffer allocation function */
 	uk_netdev_alloc_rxpkts alloc_rxpkts;
 	void *alloc_rxpkts_argp;
@@ -134,6 +176,13 @@ struct uk_netdev_rx_queue {
 	/* The scatter list and its associated fragements */
 	struct uk_sglist sg;
 	struct uk_sglist_seg sgsegs[NET_MAX_FRAGMENTS];
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	/* Driver-specific counters */
+	struct {
+		__u64 merged_bufs;
+		__u64 notify_suppressed;
+	} xstats;
+#endif
 };
 
 struct virtio_net_device {
@@ -144,7 +193,10 @@ struct virtio_net_device {
 	struct uk_netdev netdev;
 	/* Count of the number of the virtqueues */
 	__u16 max_vqueue_pairs;
-	/* List of the Rx/Tx queue */
+	/* The control virtqueue and its hw identifier */
+	struct virtqueue *ctrlq;
+	__u16 ctrlq_id;
+	/* List of the Rx/Tx queue (count: number of configured queues) */
 	__u16    rx_vqueue_cnt;
 	struct   uk_netdev_rx_queue *rxqs;
 	__u16    tx_vqueue_cnt;
@@ -161,6 +213,16 @@ struct virtio_net_device {
 	__u8 state;
 	/* RX promiscuous mode. */
 	__u8 promisc : 1;
+	/* Negotiated offloads (UK_FEATURE_*) */
+	__u32 offloads;
+	/* Length of the virtio-net header used with the device */
+	__u8 hdr_len;
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	/* Driver-specific counters returned with UK_NETDEV_XSTATS */
+	struct uk_netdev_xstats xstats;
+	struct uk_netdev_xstat xstat[VTNET_XSTATS_PER_QUEUE_PAIR
+				     * CONFIG_LIBUKNETDEV_MAXNBQUEUES];
+#endif
 };
 
 /**
@@ -176,6 +238,8 @@ static int virtio_netdev_configure(struct uk_netdev *n,
 static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 				    const struct uk_netdev_conf *conf);
 static int virtio_netdev_feature_negotiate(struct virtio_net_device *vndev);
+static __u16 virtio_netdev_hw_vqueue_pairs(struct virtio_net_device *vndev,
+					   __u64 features);
 static struct uk_netdev_tx_queue *virtio_netdev_tx_queue_setup(
 					struct uk_netdev *n, uint16_t queue_id,
 					uint16_t nb_desc,
@@ -199,20 +263,31 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 static int virtio_netdev_recv(struct uk_netdev *dev,
 			      struct uk_netdev_rx_queue *queue,
 			      struct uk_netbuf **pkt);
+static int virtio_netdev_xmit_burst(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkt, __u16 *cnt);
+static int virtio_netdev_recv_burst(struct uk_netdev *dev,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkt, __u16 *cnt);
 static const struct uk_hwaddr *virtio_net_mac_get(struct uk_netdev *n);
 static __u16 virtio_net_mtu_get(struct uk_netdev *n);
+static int virtio_net_mtu_set(struct uk_netdev *n, __u16 mtu);
 static unsigned virtio_net_promisc_get(struct uk_netdev *n);
 static int virtio_netdev_rxq_info_get(struct uk_netdev *dev, __u16 queue_id,
 				      struct uk_netdev_queue_info *qinfo);
 static int virtio_netdev_txq_info_get(struct uk_netdev *dev, __u16 queue_id,
 				      struct uk_netdev_queue_info *qinfo);
 static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
-				     struct uk_netbuf **netbuf);
+				     struct uk_netbuf **netbuf, int *used);
 static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 				     struct uk_netbuf *netbuf);
 static int virtio_netdev_recv_done(struct virtqueue *vq, void *priv);
 static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 				   __u16 num, int notify);
+#ifdef CONFIG_LIBUKNETDEV_STATS
+static const void *virtio_net_einfo_get(struct uk_netdev *n,
+					enum uk_netdev_einfo_type einfo);
+#endif
 
 /**
  * Static global constants
@@ -261,9 +336,32 @@ static void virtio_netdev_xmit_free(struct uk_netdev_tx_queue *txq)
 		uk_netbuf_free(pkt);
 		cnt++;
 	}
+	VTNET_XSTAT_ADD(txq, reclaimed, cnt);
 	uk_pr_debug("Free %"__PRIu16" descriptors\n", cnt);
 }
 
+/**
+ * Notifies the host about new buffers on a queue and accounts for the
+ * notification.
+ */
+static inline void virtio_netdev_rxq_notify(struct uk_netdev_rx_queue *rxq)
+{
+	if (virtqueue_host_notify(rxq->vq))
+		uk_netdev_drv_rxq_stats_add(rxq->ndev, rxq->lqueue_id,
+					    notifies, 1);
+	else
+		VTNET_XSTAT_ADD(rxq, notify_suppressed, 1);
+}
+
+static inline void virtio_netdev_txq_notify(struct uk_netdev_tx_queue *txq)
+{
+	if (virtqueue_host_notify(txq->vq))
+		uk_netdev_drv_txq_stats_add(txq->ndev, txq->lqueue_id,
+					    notifies, 1);
+	else
+		VTNET_XSTAT_ADD(txq, notify_suppressed, 1);
+}
+
 #define RX_FILLUP_BATCHLEN 64
 
 static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
@@ -278,17 +376,21 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 	__u16 cnt = 0;
 	__u16 filled = 0;
 
+	__u16 desc_per_buf;
+
 	/**
-	 * Fixed amount of memory is allocated to each received buffer. In
-	 * our case since we don't support jumbo frame or LRO yet we require
-	 * that the buffer feed to the ring descriptor is atleast
-	 * ethernet MTU + virtio net header.
-	 * Because we using 2 descriptor for a single netbuf, our effective
-	 * queue size is just the half.
+	 * Without mergeable receive buffers, each buffer fed to the ring
+	 * has to hold a complete frame, i.e., at least MTU + virtio net
+	 * header, and occupies 2 descriptors, so that our effective queue
+	 * size is just the half. With mergeable receive buffers, header and
+	 * data share a single descriptor and a frame may span several
+	 * buffers.
 	 */
-	nb_desc = ALIGN_DOWN(nb_desc, 2);
+	desc_per_buf = rxq->mrg_rxbuf ? 1 : 2;
+	nb_desc = ALIGN_DOWN(nb_desc, desc_per_buf);
 	while (filled < nb_desc) {
-		req = MIN(nb_desc / 2, RX_FILLUP_BATCHLEN);
+		req = MIN((nb_desc - filled) / desc_per_buf,
+			  RX_FILLUP_BATCHLEN);
 		cnt = rxq->alloc_rxpkts(rxq->alloc_rxpkts_argp, netbuf, req);
 		for (i = 0; i < cnt; i++) {
 			uk_pr_debug("Enqueue netbuf %"PRIu16"/%"PRIu16" (%p) to virtqueue %p...\n",
@@ -307,7 +409,7 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 				status |= UK_NETDEV_STATUS_UNDERRUN;
 				goto out;
 			}
-			filled += 2;
+			filled += desc_per_buf;
 		}
 
 		if (unlikely(cnt < req)) {
@@ -320,41 +422,87 @@ static int virtio_netdev_rx_fillup(struct uk_netdev_rx_queue *rxq,
 
 out:
 	uk_pr_debug("Programmed %"PRIu16" receive netbufs to receive virtqueue %p (status %x)\n",
-		    filled / 2, rxq, status);
+		    filled / desc_per_buf, rxq, status);
 
 	/**
 	 * Notify the host, when we submit new descriptor(s).
 	 */
 	if (notify && filled)
-		virtqueue_host_notify(rxq->vq);
+		virtio_netdev_rxq_notify(rxq);
 
 	return status;
 }
 
-static int virtio_netdev_xmit(struct uk_netdev *dev,
-			      struct uk_netdev_tx_queue *queue,
-			      struct uk_netbuf *pkt)
+/**
+ * Translates the offload requests of a netbuf to the virtio-net header.
+ */
+static int virtio_netdev_tx_offload(struct virtio_net_device *vndev,
+				    struct virtio_net_hdr *vhdr,
+				    const struct uk_netbuf *pkt)
 {
-	struct virtio_net_device *vndev __unused;
+	if (pkt->flags & UK_NETBUF_F_PARTIAL_CSUM) {
+		if (unlikely(!(vndev->offloads & UK_FEATURE_TX_CSUM)))
+			return -ENOTSUP;
+		vhdr->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+		vhdr->csum_start = pkt->csum_start;
+		vhdr->csum_offset = pkt->csum_offset;
+	}
+
+	switch (pkt->flags & UK_NETBUF_F_GSO_MASK) {
+	case 0:
+		return 0;
+	case UK_NETBUF_F_GSO_TCPV4:
+		if (unlikely(!(vndev->offloads & UK_FEATURE_TX_TSO4)))
+			return -ENOTSUP;
+		vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+		break;
+	case UK_NETBUF_F_GSO_TCPV6:
+		if (unlikely(!(vndev->offloads & UK_FEATURE_TX_TSO6)))
+			return -ENOTSUP;
+		vhdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+		break;
+	default:
+		/* UFO is not negotiated (deprecated by hosts) */
+		return -ENOTSUP;
+	}
+
+	/* Segmentation requires the device to compute the checksums */
+	if (unlikely(!(pkt->flags & UK_NETBUF_F_PARTIAL_CSUM)))
+		return -EINVAL;
+	if (pkt->flags & UK_NETBUF_F_GSO_ECN) {
+		if (unlikely(!virtio_has_features(vndev->vdev->features,
+						  VIRTIO_NET_F_HOST_ECN)))
+			return -ENOTSUP;
+		vhdr->gso_type |= VIRTIO_NET_HDR_GSO_ECN;
+	}
+	vhdr->hdr_len = pkt->header_len;
+	vhdr->gso_size = pkt->gso_size;
+	return 0;
+}
+
+/**
+ * Prepends the virtio header to a packet and adds it to the transmit ring
+ * without notifying the host.
+ * Returns the number of free descriptors left in the ring on success. On
+ * failure, the header is removed again and a negative error code is
+ * returned (-ENOSPC if the ring is full).
+ */
+static int virtio_netdev_xmit_enqueue(struct uk_netdev_tx_queue *queue,
+				      struct uk_netbuf *pkt)
+{
+	struct virtio_net_device *vndev;
 	struct virtio_net_hdr *vhdr;
 	struct virtio_net_hdr_padded *padded_hdr;
 	int16_t header_sz = sizeof(*padded_hdr);
 	int rc = 0;
-	int status = 0x0;
 	size_t total_len = 0;
+	size_t max_len;
 	__u8  *buf_start;
 	size_t buf_len;
 
-	UK_ASSERT(dev);
 	UK_ASSERT(pkt && queue);
-
-	vndev = to_virtionetdev(dev);
-	/**
-	 * We are reclaiming the free descriptors from buffers. The function is
-	 * not protected by means of locks. We need to be careful if there are
-	 * multiple context through which we free the tx descriptors.
-	 */
-	virtio_netdev_xmit_free(queue);
+	vndev = to_virtionetdev(queue->ndev);
+	max_len = VIRTIO_PKT_BUFFER_LEN(vndev->mtu);
 
 	buf_start = pkt->data;
 	buf_len = pkt->len;
@@ -364,8 +512,7 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	rc = uk_netbuf_header(pkt, header_sz);
 	if (unlikely(rc != 1)) {
 		uk_pr_err("Failed to prepend virtio header\n");
-		rc = -ENOSPC;
-		goto err_exit;
+		return -ENOSPC;
 	}
 	vhdr = pkt->data;
 
@@ -373,8 +520,18 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	 * Fill the virtio-net-header with the necessary information.
 	 * Zero explicitly set.
 	 */
-	memset(vhdr, 0, sizeof(*vhdr));
+	memset(vhdr, 0, vndev->hdr_len);
 	vhdr->gso_type = VIRTIO_NET_HDR_GSO_NONE;
+	if (pkt->flags & (UK_NETBUF_F_PARTIAL_CSUM | UK_NETBUF_F_GSO_MASK)) {
+		rc = virtio_netdev_tx_offload(vndev, vhdr, pkt);
+		if (unlikely(rc < 0)) {
+			uk_pr_err("Unsupported offload request (flags %x): %d\n",
+				  pkt->flags, rc);
+			goto err_remove_vhdr;
+		}
+		if (vhdr->gso_type != VIRTIO_NET_HDR_GSO_NONE)
+			max_len = VIRTIO_GSO_PKT_BUFFER_LEN;
+	}
 
 	/**
 	 * Prepare the sglist and enqueue the buffer to the virtio-ring.
@@ -389,7 +546,7 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	 * 1 for the virtio header and the other for the actual network packet.
 	 */
 	/* Appending the data to the list. */
-	rc = uk_sglist_append(&queue->sg, vhdr, sizeof(*vhdr));
+	rc = uk_sglist_append(&queue->sg, vhdr, vndev->hdr_len);
 	if (unlikely(rc != 0)) {
 		uk_pr_err("Failed to append to the sg list\n");
 		goto err_remove_vhdr;
@@ -408,9 +565,9 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	}
 
 	total_len = uk_sglist_length(&queue->sg);
-	if (unlikely(total_len > VIRTIO_PKT_BUFFER_LEN)) {
-		uk_pr_err("Packet size too big: %lu, max:%u\n",
-			  total_len, VIRTIO_PKT_BUFFER_LEN);
+	if (unlikely(total_len > max_len)) {
+		uk_pr_err("Packet size too big: %lu, max:%lu\n",
+			  total_len, max_len);
 		rc = -ENOTSUP;
 		goto err_remove_vhdr;
 	}
@@ -420,43 +577,98 @@ static int virtio_netdev_xmit(struct uk_netdev *dev,
 	 */
 	rc = virtqueue_buffer_enqueue(queue->vq, pkt, &queue->sg,
 				      queue->sg.sg_nseg, 0);
+	if (likely(rc >= 0))
+		return rc;
+
+	if (rc == -ENOSPC)
+		uk_pr_debug("No more descriptor available\n");
+	else
+		uk_pr_err("Failed to enqueue descriptors into the ring: %d\n",
+			  rc);
+
+err_remove_vhdr:
+	UK_ASSERT(rc < 0);
+	uk_netbuf_header(pkt, -header_sz);
+	return rc;
+}
+
+static int virtio_netdev_xmit(struct uk_netdev *dev,
+			      struct uk_netdev_tx_queue *queue,
+			      struct uk_netbuf *pkt)
+{
+	int status = 0x0;
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(pkt && queue);
+
+	/**
+	 * We are reclaiming the free descriptors from buffers. The function is
+	 * not protected by means of locks. We need to be careful if there are
+	 * multiple context through which we free the tx descriptors.
+	 */
+	virtio_netdev_xmit_free(queue);
+
+	rc = virtio_netdev_xmit_enqueue(queue, pkt);
 	if (likely(rc >= 0)) {
 		status |= UK_NETDEV_STATUS_SUCCESS;
 		/**
 		 * Notify the host the new buffer.
 		 */
-		virtqueue_host_notify(queue->vq);
+		virtio_netdev_txq_notify(queue);
 		/**
 		 * When there is further space available in the ring
 		 * return UK_NETDEV_STATUS_MORE.
 		 */
 		status |= likely(rc > 0) ? UK_NETDEV_STATUS_MORE : 0x0;
-	} else if (rc == -ENOSPC) {
-		uk_pr_debug("No more descriptor available\n");
+	} else if (rc != -ENOSPC) {
+		return rc;
+	}
+	return status;
+}
+
+static int virtio_netdev_xmit_burst(struct uk_netdev *dev,
+				    struct uk_netdev_tx_queue *queue,
+				    struct uk_netbuf **pkt, __u16 *cnt)
+{
+	int status = 0x0;
+	int rc = 0;
+	__u16 i;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkt && cnt);
+
+	/* Reclaim descriptors once for the whole burst */
+	virtio_netdev_xmit_free(queue);
+
+	for (i = 0; i < *cnt; ++i) {
+		rc = virtio_netdev_xmit_enqueue(queue, pkt[i]);
+		if (unlikely(rc < 0))
+			break;
+	}
+
+	if (likely(i > 0)) {
+		status |= UK_NETDEV_STATUS_SUCCESS;
 		/**
-		 * Remove header before exiting because we could not send
+		 * Notify the host only once for all the buffers of the burst.
 		 */
-		uk_netbuf_header(pkt, -header_sz);
-	} else {
-		uk_pr_err("Failed to enqueue descriptors into the ring: %d\n",
-			  rc);
-		goto err_remove_vhdr;
+		virtio_netdev_txq_notify(queue);
+		status |= (rc > 0) ? UK_NETDEV_STATUS_MORE : 0x0;
+	} else if (rc != -ENOSPC) {
+		UK_ASSERT(rc < 0);
+		return rc;
 	}
-	return status;
 
-err_remove_vhdr:
-	uk_netbuf_header(pkt, -header_sz);
-err_exit:
-	UK_ASSERT(rc < 0);
-	return rc;
+	*cnt = i;
+	return status;
 }
 
 static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 				     struct uk_netbuf *netbuf)
 {
 	int rc = 0;
-	struct virtio_net_hdr_padded *rxhdr;
-	int16_t header_sz = sizeof(*rxhdr);
+	void *rxhdr;
+	int16_t header_sz;
 	__u8 *buf_start;
 	size_t buf_len = 0;
 	struct uk_sglist *sg;
@@ -475,6 +687,8 @@ static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	/**
 	 * Retrieve the buffer header length.
 	 */
+	header_sz = rxq->mrg_rxbuf ? sizeof(struct virtio_net_hdr_mrg_rxbuf)
+				   : sizeof(struct virtio_net_hdr_padded);
 	rc = uk_netbuf_header(netbuf, header_sz);
 	if (unlikely(rc != 1)) {
 		uk_pr_err("Failed to allocate space to prepend virtio header\n");
@@ -485,18 +699,169 @@ static int virtio_netdev_rxq_enqueue(struct uk_netdev_rx_queue *rxq,
 	sg = &rxq->sg;
 	uk_sglist_reset(sg);
 
-	/* Appending the header buffer to the sglist */
-	uk_sglist_append(sg, rxhdr, sizeof(struct virtio_net_hdr));
+	if (rxq->mrg_rxbuf) {
+		/**
+		 * The header is directly followed by the data. Only the first
+		 * buffer of a packet carries a header, the following ones are
+		 * filled with data from their beginning on.
+		 */
+		uk_sglist_append(sg, rxhdr, header_sz + buf_len);
+	} else {
+		/* Appending the header buffer to the sglist */
+		uk_sglist_append(sg, rxhdr, rxq->hdr_len);
 
-	/* Appending the data buffer to the sglist */
-	uk_sglist_append(sg, buf_start, buf_len);
+		/* Appending the data buffer to the sglist */
+		uk_sglist_append(sg, buf_start, buf_len);
+	}
 
 	rc = virtqueue_buffer_enqueue(rxq->vq, netbuf, sg, 0, sg->sg_nseg);
 	return rc;
 }
 
+/**
+ * Translates the offload information of a received virtio-net header to
+ * netbuf meta data.
+ */
+static void virtio_netdev_rx_offload(struct uk_netbuf *buf,
+				     const struct virtio_net_hdr *vhdr)
+{
+	buf->flags = 0;
+	if (likely(!vhdr->flags && vhdr->gso_type == VIRTIO_NET_HDR_GSO_NONE))
+		return;
+
+	if (vhdr->flags & VIRTIO_NET_HDR_F_DATA_VALID)
+		buf->flags |= UK_NETBUF_F_DATA_VALID;
+	if (vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) {
+		buf->flags |= UK_NETBUF_F_PARTIAL_CSUM;
+		buf->csum_start = vhdr->csum_start;
+		buf->csum_offset = vhdr->csum_offset;
+	}
+
+	switch (vhdr->gso_type & ~VIRTIO_NET_HDR_GSO_ECN) {
+	case VIRTIO_NET_HDR_GSO_TCPV4:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV4;
+		break;
+	case VIRTIO_NET_HDR_GSO_TCPV6:
+		buf->flags |= UK_NETBUF_F_GSO_TCPV6;
+		break;
+	case VIRTIO_NET_HDR_GSO_UDP:
+		buf->flags |= UK_NETBUF_F_GSO_UDP;
+		break;
+	default:
+		return;
+	}
+	if (vhdr->gso_type & VIRTIO_NET_HDR_GSO_ECN)
+		buf->flags |= UK_NETBUF_F_GSO_ECN;
+	buf->gso_size = vhdr->gso_size;
+	buf->header_len = vhdr->hdr_len;
+}
+
+/**
+ * Puts the buffers of a packet that was dropped by the receive filter or
+ * because it was malformed back to the receive ring, without going through
+ * the allocator.
+ * @return
+ *	The number of descriptors that got programmed again.
+ */
+static int virtio_netdev_rxq_recycle(struct uk_netdev_rx_queue *rxq,
+				     struct uk_netbuf *pkt)
+{
+	struct uk_netbuf *buf, *next;
+	int filled = 0;
+	__u16 desc_per_buf = rxq->mrg_rxbuf ? 1 : 2;
+
+	for (buf = pkt; buf; buf = next) {
+		next = uk_netbuf_disconnect(buf);
+
+		/**
+		 * Restore the layout of an allocated buffer: Following
+		 * mergeable buffers carried data at the place of the header.
+		 */
+		if (rxq->mrg_rxbuf && buf != pkt)
+			buf->data = (__u8 *) buf->data
+				    + sizeof(struct virtio_net_hdr_mrg_rxbuf);
+		buf->len = buf->buflen - uk_netbuf_headroom(buf);
+		buf->flags = 0;
+
+		if (unlikely(virtio_netdev_rxq_enqueue(rxq, buf) < 0)) {
+			uk_netbuf_free(buf);
+			continue;
+		}
+		filled += desc_per_buf;
+	}
+	return filled;
+}
+
+/**
+ * Collects the remaining buffers of a packet that was received with
+ * mergeable receive buffers and chains them to the first one.
+ * @param used
+ *	Updated with the number of used slots in the ring.
+ * @return
+ *	0 on success.
+ *	-EBADMSG The packet was malformed, its buffers were put back to the
+ *	ring.
+ */
+static int virtio_netdev_rxq_merge(struct uk_netdev_rx_queue *rxq,
+				   struct uk_netbuf *head, __u32 len, int *used)
+{
+	struct virtio_net_hdr_mrg_rxbuf *mhdr = head->data;
+	struct uk_netbuf *last = head;
+	struct uk_netbuf *buf;
+	__u16 nb_bufs;
+	int rc;
+
+	/* The head keeps the layout of an allocated buffer for recycling */
+	rc = uk_netbuf_header(head, -((int16_t)sizeof(*mhdr)));
+	UK_ASSERT(rc == 1);
+
+	if (unlikely(len < sizeof(*mhdr) + UK_ETH_HDR_UNTAGGED_LEN)) {
+		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
+		goto err_recycle;
+	}
+	nb_bufs = mhdr->num_buffers;
+	if (unlikely(nb_bufs == 0)) {
+		uk_pr_err("Received packet without buffers\n");
+		goto err_recycle;
+	}
+
+	virtio_netdev_rx_offload(head, &mhdr->hdr);
+	head->len = len - sizeof(*mhdr);
+
+	while (--nb_bufs > 0) {
+		rc = virtqueue_buffer_dequeue(rxq->vq, (void **) &buf, &len);
+		if (unlikely(rc < 0)) {
+			uk_pr_err("Missing %"__PRIu16" buffers of received packet\n",
+				  nb_bufs);
+			goto err_recycle;
+		}
+		*used = rc;
+		buf->len = len;
+		buf->flags = 0;
+		uk_netbuf_connect(last, buf);
+		last = buf;
+		VTNET_XSTAT_ADD(rxq, merged_bufs, 1);
+	}
+	return 0;
+
+err_recycle:
+	uk_netdev_drv_rxq_stats_add(rxq->ndev, rxq->lqueue_id, drops, 1);
+	*used += virtio_netdev_rxq_recycle(rxq, head);
+	return -EBADMSG;
+}
+
+/**
+ * Dequeues the next packet from the ring.
+ * @param used
+ *	Updated with the number of used slots in the ring whenever a packet
+ *	was dequeued.
+ * @return
+ *	0 on success, `*netbuf` is NULL if no packet is available.
+ *	-EBADMSG The packet was malformed, its buffers were put back to the
+ *	ring.
+ */
 static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
-				     struct uk_netbuf **netbuf)
+				     struct uk_netbuf **netbuf, int *used)
 {
 	int ret;
 	int rc = 0;
@@ -504,32 +869,84 @@ static int virtio_netdev_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
 	__u32 len;
 
 	UK_ASSERT(netbuf);
+	UK_ASSERT(used);
 
+	*netbuf = NULL;
 	ret = virtqueue_buffer_dequeue(rxq->vq, (void **) &buf, &len);
 	if (ret < 0) {
 		uk_pr_debug("No data available in the queue\n");
-		*netbuf = NULL;
-		return rxq->nb_desc;
+		return 0;
 	}
-	if (unlikely((len < VIRTIO_HDR_LEN + UK_ETH_HDR_UNTAGGED_LEN)
-		     || (len > VIRTIO_PKT_BUFFER_LEN))) {
-		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
-		return -EINVAL;
+	*used = ret;
+	if (rxq->mrg_rxbuf) {
+		rc = virtio_netdev_rxq_merge(rxq, buf, len, used);
+		if (unlikely(rc < 0))
+			return rc;
+		*netbuf = buf;
+		return 0;
 	}
 
 	/**
-	 * Removing the virtio header from the buffer and adjusting length.
-	 * We pad "VTNET_RX_HEADER_PAD" to the rx buffer while enqueuing for
-	 * alignment of the packet data. We compensate for this, by adding the
-	 *  padding to the length on dequeue.
+	 * Removing the virtio header from the buffer. We pad
+	 * "VTNET_RX_HEADER_PAD" to the rx buffer while enqueuing for
+	 * alignment of the packet data, the device wrote only the header
+	 * without the padding.
 	 */
-	buf->len = len + VTNET_RX_HEADER_PAD;
+	virtio_netdev_rx_offload(buf, buf->data);
 	rc = uk_netbuf_header(buf,
 			      -((int16_t)sizeof(struct virtio_net_hdr_padded)));
 	UK_ASSERT(rc == 1);
+
+	if (unlikely((len < VIRTIO_HDR_LEN + UK_ETH_HDR_UNTAGGED_LEN)
+		     || (len > (__u32) VIRTIO_PKT_BUFFER_LEN(
+				to_virtionetdev(rxq->ndev)->max_mtu)))) {
+		uk_pr_err("Received invalid packet size: %"__PRIu32"\n", len);
+		uk_netdev_drv_rxq_stats_add(rxq->ndev, rxq->lqueue_id,
+					    drops, 1);
+		*used += virtio_netdev_rxq_recycle(rxq, buf);
+		return -EBADMSG;
+	}
+	buf->len = len - rxq->hdr_len;
 	*netbuf = buf;
+	return 0;
+}
 
-	return ret;
+/**
+ * Dequeues the next packet that passes the receive filter of the queue.
+ * Dropped and malformed packets are recycled, steered packets are taken
+ * over by libuknetdev.
+ * @param netbuf
+ *	Set to the packet, NULL if no packet is available.
+ * @param used
+ *	Updated with the number of used slots in the ring whenever a packet
+ *	was dequeued.
+ */
+static void virtio_netdev_rxq_dequeue_filtered(struct uk_netdev_rx_queue *rxq,
+					       struct uk_netbuf **netbuf,
+					       int *used)
+{
+	int budget = rxq->nb_desc;
+
+	do {
+		if (unlikely(virtio_netdev_rxq_dequeue(rxq, netbuf, used) < 0))
+			continue;
+		if (!*netbuf)
+			return;
+
+		switch (uk_netdev_drv_rx_filter(rxq->ndev, rxq->lqueue_id,
+						*netbuf)) {
+		case UK_NETDEV_RX_PASS:
+			return;
+		case UK_NETDEV_RX_DROP:
+			*used += virtio_netdev_rxq_recycle(rxq, *netbuf);
+			break;
+		default:
+			break;
+		}
+		*netbuf = NULL;
+	} while (--budget > 0);
+
+	/* Give the caller the chance to re-program the ring */
 }
 
 static int virtio_netdev_recv(struct uk_netdev *dev,
@@ -537,6 +954,7 @@ static int virtio_netdev_recv(struct uk_netdev *dev,
 			      struct uk_netbuf **pkt)
 {
 	int status = 0x0;
+	int used = queue->nb_desc;
 	int rc = 0;
 
 	UK_ASSERT(dev && queue);
@@ -545,13 +963,9 @@ static int virtio_netdev_recv(struct uk_netdev *dev,
 	/* Queue interrupts have to be off when calling receive */
 	UK_ASSERT(!(queue->intr_enabled & VTNET_INTR_EN));
 
-	rc = virtio_netdev_rxq_dequeue(queue, pkt);
-	if (unlikely(rc < 0)) {
-		uk_pr_err("Failed to dequeue the packet: %d\n", rc);
-		goto err_exit;
-	}
+	virtio_netdev_rxq_dequeue_filtered(queue, pkt, &used);
 	status |= (*pkt) ? UK_NETDEV_STATUS_SUCCESS : 0x0;
-	status |= virtio_netdev_rx_fillup(queue, (queue->nb_desc - rc), 1);
+	status |= virtio_netdev_rx_fillup(queue, (queue->nb_desc - used), 1);
 
 	/* Enable interrupt only when user had previously enabled it */
 	if (queue->intr_enabled & VTNET_INTR_USR_EN_MASK) {
@@ -562,20 +976,16 @@ static int virtio_netdev_recv(struct uk_netdev *dev,
 			 * Packet arrive after reading the queue and before
 			 * enabling the interrupt
 			 */
-			rc = virtio_netdev_rxq_dequeue(queue, pkt);
-			if (unlikely(rc < 0)) {
-				uk_pr_err("Failed to dequeue the packet: %d\n",
-					  rc);
-				goto err_exit;
-			}
-			status |= UK_NETDEV_STATUS_SUCCESS;
+			used = queue->nb_desc;
+			virtio_netdev_rxq_dequeue_filtered(queue, pkt, &used);
+			status |= (*pkt) ? UK_NETDEV_STATUS_SUCCESS : 0x0;
 
 			/*
 			 * Since we received something, we need to fillup
 			 * and notify
 			 */
 			status |= virtio_netdev_rx_fillup(queue,
-							  (queue->nb_desc - rc),
+							  queue->nb_desc - used,
 							  1);
 
 			/* Need to enable the interrupt on the last packet */
@@ -593,10 +1003,58 @@ static int virtio_netdev_recv(struct uk_netdev *dev,
 		status |= UK_NETDEV_STATUS_MORE;
 	}
 	return status;
+}
 
-err_exit:
-	UK_ASSERT(rc < 0);
-	return rc;
+static int virtio_netdev_recv_burst(struct uk_netdev *dev,
+				    struct uk_netdev_rx_queue *queue,
+				    struct uk_netbuf **pkt, __u16 *cnt)
+{
+	int status = 0x0;
+	int used;
+	int rc = 0;
+	__u16 i = 0;
+
+	UK_ASSERT(dev && queue);
+	UK_ASSERT(pkt && cnt);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(queue->intr_enabled & VTNET_INTR_EN));
+
+	/* Number of descriptors in use, nothing to re-program until we
+	 * dequeued a packet
+	 */
+	used = queue->nb_desc;
+dequeue:
+	for (; i < *cnt; ++i) {
+		virtio_netdev_rxq_dequeue_filtered(queue, &pkt[i], &used);
+		if (!pkt[i])
+			break;
+	}
+
+	/* Re-program all free descriptors at once and notify the host */
+	status |= virtio_netdev_rx_fillup(queue, (queue->nb_desc - used), 1);
+
+	if (i == *cnt) {
+		/* The burst is full, there might be further packets */
+		status |= UK_NETDEV_STATUS_MORE;
+	} else if (queue->intr_enabled & VTNET_INTR_USR_EN_MASK) {
+		/* The queue is drained: Enable the interrupt again */
+		rc = virtqueue_intr_enable(queue->vq);
+		if (rc == 1) {
+			/**
+			 * Packet arrived after reading the queue and before
+			 * enabling the interrupt
+			 */
+			if (i == 0)
+				goto dequeue;
+			status |= UK_NETDEV_STATUS_MORE;
+		}
+	}
+
+	*cnt = i;
+	if (i > 0)
+		status |= UK_NETDEV_STATUS_SUCCESS;
+	return status;
 }
 
 static struct uk_netdev_rx_queue *virtio_netdev_rx_queue_setup(
@@ -613,7 +1071,7 @@ static struct uk_netdev_rx_queue *virtio_netdev_rx_queue_setup(
 	UK_ASSERT(conf->alloc_rxpkts);
 
 	vndev = to_virtionetdev(n);
-	if (queue_id >= vndev->max_vqueue_pairs) {
+	if (queue_id >= vndev->rx_vqueue_cnt) {
 		uk_pr_err("Invalid virtqueue identifier: %"__PRIu16"\n",
 			  queue_id);
 		rc = -EINVAL;
@@ -628,6 +1086,9 @@ static struct uk_netdev_rx_queue *virtio_netdev_rx_queue_setup(
 		goto err_exit;
 	}
 	rxq  = &vndev->rxqs[rc];
+	rxq->mrg_rxbuf = virtio_has_features(vndev->vdev->features,
+					     VIRTIO_NET_F_MRG_RXBUF);
+	rxq->hdr_len = vndev->hdr_len;
 	rxq->alloc_rxpkts = conf->alloc_rxpkts;
 	rxq->alloc_rxpkts_argp = conf->alloc_rxpkts_argp;
 
@@ -665,17 +1126,27 @@ static int virtio_netdev_vqueue_setup(struct virtio_net_device *vndev,
 	uint16_t max_desc, hwvq_id;
 	struct virtqueue *vq;
 
+	/**
+	 * User queue `queue_id` is always mapped to the virtqueue pair with
+	 * the same index, independent of the order of the setup calls.
+	 */
+	id = queue_id;
 	if (queue_type == VNET_RX) {
-		id = vndev->rx_vqueue_cnt;
 		callback = virtio_netdev_recv_done;
 		max_desc = vndev->rxqs[id].max_nb_desc;
 		hwvq_id = vndev->rxqs[id].hwvq_id;
+		vq = vndev->rxqs[id].vq;
 	} else {
-		id = vndev->tx_vqueue_cnt;
 		/* We don't support the callback from the txqueue yet */
 		callback = NULL;
 		max_desc = vndev->txqs[id].max_nb_desc;
 		hwvq_id = vndev->txqs[id].hwvq_id;
+		vq = vndev->txqs[id].vq;
+	}
+
+	if (unlikely(vq)) {
+		uk_pr_err("Virtqueue %"__PRIu16" is already set up\n", hwvq_id);
+		return -EBUSY;
 	}
 
 	if (unlikely(max_desc < nr_desc)) {
@@ -701,26 +1172,36 @@ static int virtio_netdev_vqueue_setup(struct virtio_net_device *vndev,
 	}
 
 	if (queue_type == VNET_RX) {
+		/**
+		 * Receive buffers have a fixed layout of at most two segments.
+		 * Indirect tables would save a ring slot per buffer but cost
+		 * the device an additional lookup per received packet, so
+		 * they stay disabled.
+		 */
 		vq->priv = &vndev->rxqs[id];
 		vndev->rxqs[id].ndev = &vndev->netdev;
 		vndev->rxqs[id].vq = vq;
 		vndev->rxqs[id].nb_desc = nr_desc;
 		vndev->rxqs[id].lqueue_id = queue_id;
-		vndev->rx_vqueue_cnt++;
 	} else {
+		rc = virtqueue_indirect_threshold_set(vq,
+				VIRTQUEUE_INDIRECT_THRESHOLD_DEFAULT, a);
+		if (unlikely(rc < 0)) {
+			virtio_vqueue_release(vndev->vdev, vq, a);
+			return rc;
+		}
 		vndev->txqs[id].vq = vq;
 		vndev->txqs[id].ndev = &vndev->netdev;
 		vndev->txqs[id].nb_desc = nr_desc;
 		vndev->txqs[id].lqueue_id = queue_id;
-		vndev->tx_vqueue_cnt++;
 	}
 	return id;
 }
 
 static struct uk_netdev_tx_queue *virtio_netdev_tx_queue_setup(
-				struct uk_netdev *n, uint16_t queue_id __unused,
-				uint16_t nb_desc __unused,
-				struct uk_netdev_txqueue_conf *conf __unused)
+				struct uk_netdev *n, uint16_t queue_id,
+				uint16_t nb_desc,
+				struct uk_netdev_txqueue_conf *conf)
 {
 	struct uk_netdev_tx_queue *txq = NULL;
 	struct virtio_net_device *vndev;
@@ -728,7 +1209,7 @@ static struct uk_netdev_tx_queue *virtio_netdev_tx_queue_setup(
 
 	UK_ASSERT(n);
 	vndev = to_virtionetdev(n);
-	if (queue_id >= vndev->max_vqueue_pairs) {
+	if (queue_id >= vndev->tx_vqueue_cnt) {
 		uk_pr_err("Invalid virtqueue identifier: %"__PRIu16"\n",
 			  queue_id);
 		rc = -EINVAL;
@@ -762,7 +1243,7 @@ static int virtio_netdev_rxq_info_get(struct uk_netdev *dev,
 	UK_ASSERT(dev);
 	UK_ASSERT(qinfo);
 	vndev = to_virtionetdev(dev);
-	if (unlikely(queue_id >= vndev->max_vqueue_pairs)) {
+	if (unlikely(queue_id >= vndev->rx_vqueue_cnt)) {
 		uk_pr_err("Invalid virtqueue id: %"__PRIu16"\n", queue_id);
 		rc = -EINVAL;
 		goto exit;
@@ -778,7 +1259,7 @@ exit:
 }
 
 static int virtio_netdev_txq_info_get(struct uk_netdev *dev,
-				      __u16 queue_id __unused,
+				      __u16 queue_id,
 				      struct uk_netdev_queue_info *qinfo)
 {
 	struct virtio_net_device *vndev;
@@ -789,7 +1270,7 @@ static int virtio_netdev_txq_info_get(struct uk_netdev *dev,
 	UK_ASSERT(qinfo);
 
 	vndev = to_virtionetdev(dev);
-	if (unlikely(queue_id >= vndev->max_vqueue_pairs)) {
+	if (unlikely(queue_id >= vndev->tx_vqueue_cnt)) {
 		uk_pr_err("Invalid queue_id %"__PRIu16"\n", queue_id);
 		rc = -EINVAL;
 		goto exit;
@@ -803,6 +1284,47 @@ exit:
 	return rc;
 }
 
+#ifdef CONFIG_LIBUKNETDEV_STATS
+static void virtio_net_xstat_set(struct uk_netdev_xstat *xstat,
+				 const char *name, __u16 queue_id, __u64 value)
+{
+	xstat->name = name;
+	xstat->queue_id = queue_id;
+	xstat->value = value;
+}
+
+static const void *virtio_net_einfo_get(struct uk_netdev *n,
+					enum uk_netdev_einfo_type einfo)
+{
+	struct virtio_net_device *vndev;
+	struct uk_netdev_xstat *xstat;
+	__u16 i;
+
+	UK_ASSERT(n);
+	vndev = to_virtionetdev(n);
+
+	if (einfo != UK_NETDEV_XSTATS)
+		return NULL;
+
+	xstat = vndev->xstat;
+	for (i = 0; i < vndev->rx_vqueue_cnt; i++) {
+		virtio_net_xstat_set(xstat++, "rx_merged_bufs", i,
+				     vndev->rxqs[i].xstats.merged_bufs);
+		virtio_net_xstat_set(xstat++, "rx_notify_suppressed", i,
+				     vndev->rxqs[i].xstats.notify_suppressed);
+	}
+	for (i = 0; i < vndev->tx_vqueue_cnt; i++) {
+		virtio_net_xstat_set(xstat++, "tx_reclaimed", i,
+				     vndev->txqs[i].xstats.reclaimed);
+		virtio_net_xstat_set(xstat++, "tx_notify_suppressed", i,
+				     vndev->txqs[i].xstats.notify_suppressed);
+	}
+	vndev->xstats.count = xstat - vndev->xstat;
+	vndev->xstats.xstat = vndev->xstat;
+	return &vndev->xstats;
+}
+#endif /* CONFIG_LIBUKNETDEV_STATS */
+
 static unsigned virtio_net_promisc_get(struct uk_netdev *n)
 {
 	struct virtio_net_device *d;
@@ -830,10 +1352,86 @@ static __u16 virtio_net_mtu_get(struct uk_netdev *n)
 	return d->mtu;
 }
 
+static int virtio_net_mtu_set(struct uk_netdev *n, __u16 mtu)
+{
+	struct virtio_net_device *d;
+
+	UK_ASSERT(n);
+	d = to_virtionetdev(n);
+
+	if (mtu < VIRTIO_NET_MIN_MTU || mtu > d->max_mtu) {
+		uk_pr_err("Invalid MTU %"__PRIu16" (valid: %u-%"__PRIu16")\n",
+			  mtu, VIRTIO_NET_MIN_MTU, d->max_mtu);
+		return -EINVAL;
+	}
+	/**
+	 * Without mergeable receive buffers, it is up to the user to provide
+	 * receive buffers that are large enough for a frame of this size.
+	 */
+	d->mtu = mtu;
+	return 0;
+}
+
+/**
+ * Removes features whose dependencies are not fulfilled.
+ */
+static __u64 virtio_netdev_features_fixup(__u64 features)
+{
+	/* Multiqueue is configured through the control queue */
+	if (!virtio_has_features(features, VIRTIO_NET_F_CTRL_VQ))
+		features &= ~(1ULL << VIRTIO_NET_F_MQ);
+
+	/* Segmentation offloads require checksum offloads (spec 5.1.3.1) */
+	if (!virtio_has_features(features, VIRTIO_NET_F_CSUM)) {
+		features &= ~(1ULL << VIRTIO_NET_F_HOST_TSO4);
+		features &= ~(1ULL << VIRTIO_NET_F_HOST_TSO6);
+	}
+	if (!virtio_has_features(features, VIRTIO_NET_F_HOST_TSO4)
+	    && !virtio_has_features(features, VIRTIO_NET_F_HOST_TSO6))
+		features &= ~(1ULL << VIRTIO_NET_F_HOST_ECN);
+	/**
+	 * Without mergeable receive buffers, receiving large segments
+	 * requires receive buffers of 64 KiB each. Our receive buffers are
+	 * MTU-sized, so we do not accept them in this case.
+	 */
+	if (!virtio_has_features(features, VIRTIO_NET_F_GUEST_CSUM)
+	    || !virtio_has_features(features, VIRTIO_NET_F_MRG_RXBUF)) {
+		features &= ~(1ULL << VIRTIO_NET_F_GUEST_TSO4);
+		features &= ~(1ULL << VIRTIO_NET_F_GUEST_TSO6);
+	}
+	if (!virtio_has_features(features, VIRTIO_NET_F_GUEST_TSO4)
+	    && !virtio_has_features(features, VIRTIO_NET_F_GUEST_TSO6))
+		features &= ~(1ULL << VIRTIO_NET_F_GUEST_ECN);
+	return features;
+}
+
+/**
+ * Returns the uknetdev offload capabilities for a set of virtio features.
+ */
+static __u32 virtio_netdev_offloads(__u64 features)
+{
+	__u32 offloads = 0;
+
+	if (virtio_has_features(features, VIRTIO_NET_F_CSUM))
+		offloads |= UK_FEATURE_TX_CSUM;
+	if (virtio_has_features(features, VIRTIO_NET_F_GUEST_CSUM))
+		offloads |= UK_FEATURE_RX_CSUM;
+	if (virtio_has_features(features, VIRTIO_NET_F_HOST_TSO4))
+		offloads |= UK_FEATURE_TX_TSO4;
+	if (virtio_has_features(features, VIRTIO_NET_F_HOST_TSO6))
+		offloads |= UK_FEATURE_TX_TSO6;
+	if (virtio_has_features(features, VIRTIO_NET_F_GUEST_TSO4))
+		offloads |= UK_FEATURE_RX_TSO4;
+	if (virtio_has_features(features, VIRTIO_NET_F_GUEST_TSO6))
+		offloads |= UK_FEATURE_RX_TSO6;
+	return offloads;
+}
+
 static int virtio_netdev_feature_negotiate(struct virtio_net_device *vndev)
 {
 	__u64 host_features = 0;
 	__u16 hw_len;
+	__u16 hw_pairs;
 	int rc = 0;
 
 	/**
@@ -878,7 +1476,31 @@ static int virtio_netdev_feature_negotiate(struct virtio_net_device *vndev)
 	 * Mask out features supported by both driver and device.
 	 */
 	vndev->vdev->features &= host_features;
-	virtio_feature_set(vndev->vdev, vndev->vdev->features);
+	vndev->vdev->features =
+		virtio_netdev_features_fixup(vndev->vdev->features);
+	rc = virtio_feature_set(vndev->vdev, vndev->vdev->features);
+	if (unlikely(rc < 0))
+		goto exit;
+	vndev->offloads = virtio_netdev_offloads(vndev->vdev->features);
+
+	/**
+	 * The header carries the num_buffers field with mergeable receive
+	 * buffers and always on a non-legacy device (spec 5.1.6).
+	 */
+	if (virtio_has_features(vndev->vdev->features, VIRTIO_NET_F_MRG_RXBUF)
+	    || virtio_has_features(vndev->vdev->features, VIRTIO_F_VERSION_1))
+		vndev->hdr_len = sizeof(struct virtio_net_hdr_mrg_rxbuf);
+	else
+		vndev->hdr_len = sizeof(struct virtio_net_hdr);
+
+	/**
+	 * The control queue follows the last queue pair of the device
+	 * (which is the first one without multiqueue).
+	 */
+	hw_pairs = virtio_netdev_hw_vqueue_pairs(vndev, vndev->vdev->features);
+	vndev->max_vqueue_pairs = MIN(hw_pairs,
+				      CONFIG_LIBUKNETDEV_MAXNBQUEUES);
+	vndev->ctrlq_id = 2 * hw_pairs;
 exit:
 	return rc;
 }
@@ -889,15 +1511,40 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 	int rc = 0;
 	int i = 0;
 	int vq_avail = 0;
-	int total_vqs = conf->nb_rx_queues + conf->nb_tx_queues;
-	__u16 qdesc_size[total_vqs];
+	int total_vqs;
+	int has_ctrlq;
+	__u16 *qdesc_size;
 
-	if (conf->nb_rx_queues != 1 || conf->nb_tx_queues != 1) {
+	if (conf->nb_rx_queues == 0 || conf->nb_tx_queues == 0
+	    || conf->nb_rx_queues > vndev->max_vqueue_pairs
+	    || conf->nb_tx_queues > vndev->max_vqueue_pairs) {
 		uk_pr_err("Queue combination not supported: %"__PRIu16"/%"__PRIu16" rx/tx\n",
 			  conf->nb_rx_queues, conf->nb_tx_queues);
 
 		return -ENOTSUP;
 	}
+	/**
+	 * The device steers the packets of a flow to the receive queue of the
+	 * pair that transmitted them, so each queue needs its partner.
+	 */
+	if (conf->nb_rx_queues != conf->nb_tx_queues) {
+		uk_pr_err("Different number of queues not supported: %"__PRIu16"/%"__PRIu16" rx/tx\n",
+			  conf->nb_rx_queues, conf->nb_tx_queues);
+		return -EINVAL;
+	}
+
+	/**
+	 * We probe all virtqueues up to the control virtqueue (if any) so
+	 * that the array of descriptor counts can be indexed with the hw
+	 * virtqueue identifier.
+	 */
+	has_ctrlq = virtio_has_features(vndev->vdev->features,
+					VIRTIO_NET_F_CTRL_VQ);
+	total_vqs = has_ctrlq ? vndev->ctrlq_id + 1
+			      : 2 * vndev->max_vqueue_pairs;
+	qdesc_size = uk_malloc(a, sizeof(*qdesc_size) * total_vqs);
+	if (unlikely(!qdesc_size))
+		return -ENOMEM;
 
 	/**
 	 * TODO:
@@ -906,8 +1553,8 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 	 * wiser to move it to the allocator of each individual queue. This
 	 * would better considering NUMA support.
 	 */
-	vndev->rxqs = uk_malloc(a, sizeof(*vndev->rxqs) * conf->nb_rx_queues);
-	vndev->txqs = uk_malloc(a, sizeof(*vndev->txqs) * conf->nb_tx_queues);
+	vndev->rxqs = uk_calloc(a, conf->nb_rx_queues, sizeof(*vndev->rxqs));
+	vndev->txqs = uk_calloc(a, conf->nb_tx_queues, sizeof(*vndev->txqs));
 	if (unlikely(!vndev->rxqs || !vndev->txqs)) {
 		uk_pr_err("Failed to allocate memory for queue management\n");
 		rc = -ENOMEM;
@@ -931,7 +1578,7 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 	 * ...
 	 * Virtqueue-ctrlq
 	 */
-	for (i = 0; i < vndev->max_vqueue_pairs; i++) {
+	for (i = 0; i < conf->nb_rx_queues; i++) {
 		/**
 		 * Initialize the received queue with the information received
 		 * from the device.
@@ -942,7 +1589,8 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 			       (sizeof(vndev->rxqs[i].sgsegs) /
 				sizeof(vndev->rxqs[i].sgsegs[0])),
 			       &vndev->rxqs[i].sgsegs[0]);
-
+	}
+	for (i = 0; i < conf->nb_tx_queues; i++) {
 		/**
 		 * Initialize the transmit queue with the information received
 		 * from the device.
@@ -954,14 +1602,30 @@ static int virtio_netdev_rxtx_alloc(struct virtio_net_device *vndev,
 				sizeof(vndev->txqs[i].sgsegs[0])),
 			       &vndev->txqs[i].sgsegs[0]);
 	}
+
+	if (has_ctrlq) {
+		/* The control queue is only used for synchronous commands */
+		vndev->ctrlq = virtio_vqueue_setup(vndev->vdev, vndev->ctrlq_id,
+						   qdesc_size[vndev->ctrlq_id],
+						   NULL, a);
+		if (unlikely(PTRISERR(vndev->ctrlq))) {
+			uk_pr_err("Failed to set up control virtqueue\n");
+			rc = PTR2ERR(vndev->ctrlq);
+			vndev->ctrlq = NULL;
+			goto err_free_txrx;
+		}
+	}
+	vndev->rx_vqueue_cnt = conf->nb_rx_queues;
+	vndev->tx_vqueue_cnt = conf->nb_tx_queues;
 exit:
+	uk_free(a, qdesc_size);
 	return rc;
 
 err_free_txrx:
-	if (!vndev->rxqs)
-		uk_free(a, vndev->rxqs);
-	if (!vndev->txqs)
-		uk_free(a, vndev->txqs);
+	uk_free(a, vndev->rxqs);
+	uk_free(a, vndev->txqs);
+	vndev->rxqs = NULL;
+	vndev->txqs = NULL;
 	goto exit;
 }
 
@@ -987,10 +1651,6 @@ static int virtio_netdev_configure(struct uk_netdev *n,
 		goto err_negotiate_feature;
 	}
 
-	/* Initialize the count of the virtio-net device */
-	vndev->rx_vqueue_cnt = 0;
-	vndev->tx_vqueue_cnt = 0;
-
 	uk_pr_info("Configured: features=0x%lx max_virtqueue_pairs=%"__PRIu16"\n",
 		   vndev->vdev->features, vndev->max_vqueue_pairs);
 exit:
@@ -1052,13 +1712,79 @@ static void virtio_net_info_get(struct uk_netdev *dev,
 	dev_info->nb_encap_tx = sizeof(struct virtio_net_hdr_padded);
 	dev_info->nb_encap_rx = sizeof(struct virtio_net_hdr_padded);
 	dev_info->ioalign = sizeof(void *); /* word size alignment */
-	dev_info->features = UK_FEATURE_RXQ_INTR_AVAILABLE;
+	dev_info->features = UK_FEATURE_RXQ_INTR_AVAILABLE
+			     | virtio_netdev_offloads(
+				     virtio_netdev_features_fixup(
+					     vndev->vdev->features
+					     & virtio_feature_get(vndev->vdev)));
+}
+
+/**
+ * Sends a command on the control virtqueue and waits for its completion.
+ * @return
+ *	0 The command was acknowledged by the device.
+ *	< 0 The command could not be sent or the device reported an error.
+ */
+static int virtio_netdev_ctrl_send(struct virtio_net_device *vndev,
+				   __u8 class, __u8 cmd,
+				   void *data, __u32 len)
+{
+	struct virtio_net_ctrl_hdr hdr;
+	virtio_net_ctrl_ack ack = VIRTIO_NET_ERR;
+	struct uk_sglist sg;
+	struct uk_sglist_seg sgsegs[6];
+	__u16 read_bufs;
+	void *cookie;
+	int rc;
+
+	UK_ASSERT(vndev->ctrlq);
+
+	hdr.class = class;
+	hdr.cmd = cmd;
+	uk_sglist_init(&sg, ARRAY_SIZE(sgsegs), &sgsegs[0]);
+	rc = uk_sglist_append(&sg, &hdr, sizeof(hdr));
+	if (likely(rc == 0) && data)
+		rc = uk_sglist_append(&sg, data, len);
+	read_bufs = sg.sg_nseg;
+	if (likely(rc == 0))
+		rc = uk_sglist_append(&sg, &ack, sizeof(ack));
+	if (unlikely(rc != 0)) {
+		uk_pr_err("Failed to build control command: %d\n", rc);
+		return rc;
+	}
+
+	rc = virtqueue_buffer_enqueue(vndev->ctrlq, &ack, &sg, read_bufs,
+				      sg.sg_nseg - read_bufs);
+	if (unlikely(rc < 0)) {
+		uk_pr_err("Failed to enqueue control command: %d\n", rc);
+		return rc;
+	}
+	virtqueue_host_notify(vndev->ctrlq);
+
+	/* Commands are rare, so we simply poll for completion */
+	while (virtqueue_buffer_dequeue(vndev->ctrlq, &cookie, NULL) < 0)
+		ukarch_spinwait();
+	UK_ASSERT(cookie == &ack);
+
+	return (ack == VIRTIO_NET_OK) ? 0 : -EIO;
+}
+
+static int virtio_netdev_vqueue_pairs_set(struct virtio_net_device *vndev,
+					  __u16 pairs)
+{
+	struct virtio_net_ctrl_mq mq;
+
+	mq.virtqueue_pairs = pairs;
+	return virtio_netdev_ctrl_send(vndev, VIRTIO_NET_CTRL_MQ,
+				       VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET,
+				       &mq, sizeof(mq));
 }
 
 static int virtio_net_start(struct uk_netdev *n)
 {
 	struct virtio_net_device *d;
 	int i = 0;
+	int rc;
 
 	UK_ASSERT(n != NULL);
 	d = to_virtionetdev(n);
@@ -1069,11 +1795,19 @@ static int virtio_net_start(struct uk_netdev *n)
 	 * enable_tx|rx_intr()
 	 */
 	for (i = 0; i < d->rx_vqueue_cnt; i++) {
+		if (unlikely(!d->rxqs[i].vq)) {
+			uk_pr_err("Receive queue %d is not set up\n", i);
+			return -EINVAL;
+		}
 		virtqueue_intr_disable(d->rxqs[i].vq);
 		d->rxqs[i].intr_enabled = 0;
 	}
 
 	for (i = 0; i < d->tx_vqueue_cnt; i++) {
+		if (unlikely(!d->txqs[i].vq)) {
+			uk_pr_err("Transmit queue %d is not set up\n", i);
+			return -EINVAL;
+		}
 		virtqueue_intr_disable(d->txqs[i].vq);
 		d->txqs[i].intr_enabled = 0;
 	}
@@ -1082,21 +1816,97 @@ static int virtio_net_start(struct uk_netdev *n)
 	 * Set the DRIVER_OK status bit. At this point the device is "live".
 	 */
 	virtio_dev_drv_up(d->vdev);
+
+	/**
+	 * The device processes control commands only after DRIVER_OK, so we
+	 * can enable the additional queue pairs only now.
+	 */
+	if (virtio_has_features(d->vdev->features, VIRTIO_NET_F_MQ)) {
+		rc = virtio_netdev_vqueue_pairs_set(d, d->rx_vqueue_cnt);
+		if (unlikely(rc < 0)) {
+			uk_pr_err("Failed to enable %"__PRIu16" queue pairs: %d\n",
+				  d->rx_vqueue_cnt, rc);
+			return rc;
+		}
+	}
 	uk_pr_info(DRIVER_NAME": %"__PRIu16" started\n", d->uid);
 
 	return 0;
 }
 
+/**
+ * Initializes the MTU with the advice of the device, if there is one.
+ * Otherwise, mergeable receive buffers raise the maximum MTU.
+ */
+static void virtio_netdev_mtu_init(struct virtio_net_device *vndev)
+{
+	__u64 features = vndev->vdev->features
+			 & virtio_feature_get(vndev->vdev);
+	__u16 mtu;
+
+	vndev->max_mtu = UK_ETH_PAYLOAD_MAXLEN;
+	vndev->mtu = UK_ETH_PAYLOAD_MAXLEN;
+	if (virtio_has_features(features, VIRTIO_NET_F_MTU)) {
+		if (unlikely(virtio_config_get(vndev->vdev,
+					__offsetof(struct virtio_net_config,
+						   mtu),
+					&mtu, sizeof(mtu), sizeof(mtu)) < 0))
+			uk_pr_warn("Failed to retrieve the mtu from device\n");
+		else if (unlikely(mtu < VIRTIO_NET_MIN_MTU))
+			uk_pr_warn("Ignoring invalid mtu advice %"__PRIu16"\n",
+				   mtu);
+		else
+			vndev->max_mtu = vndev->mtu = mtu;
+	} else if (virtio_has_features(features, VIRTIO_NET_F_MRG_RXBUF)) {
+		/**
+		 * Without advice, mergeable receive buffers can carry frames
+		 * of any size that fits into the 16-bit length fields. The
+		 * default MTU stays at the Ethernet payload size.
+		 */
+		vndev->max_mtu = __U16_MAX - VIRTIO_HDR_LEN
+				 - UK_ETH_HDR_UNTAGGED_LEN;
+	}
+}
+
+/**
+ * Returns the number of queue pairs of the device, which is 1 unless
+ * multiqueue is part of the given feature set.
+ */
+static __u16 virtio_netdev_hw_vqueue_pairs(struct virtio_net_device *vndev,
+					   __u64 features)
+{
+	__u16 pairs;
+
+	if (!virtio_has_features(virtio_netdev_features_fixup(features),
+				 VIRTIO_NET_F_MQ))
+		return 1;
+
+	if (unlikely(virtio_config_get(vndev->vdev,
+				__offsetof(struct virtio_net_config,
+					   max_virtqueue_pairs),
+				&pairs, sizeof(pairs), sizeof(pairs)) < 0)) {
+		uk_pr_warn("Failed to retrieve the number of queue pairs\n");
+		return 1;
+	}
+	if (unlikely(pairs < VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MIN
+		     || pairs > VIRTIO_NET_CTRL_MQ_VQ_PAIRS_MAX)) {
+		uk_pr_warn("Invalid number of queue pairs: %"__PRIu16"\n",
+			   pairs);
+		return 1;
+	}
+	return pairs;
+}
+
 static inline void virtio_netdev_feature_set(struct virtio_net_device *vndev)
 {
 	vndev->vdev->features = 0;
 	/* Setting the feature the driver support */
 	VIRTIO_NET_DRV_FEATURES(vndev->vdev->features);
-	/**
-	 * TODO:
-	 * Adding multiqueue support for the virtio net driver.
-	 */
-	vndev->max_vqueue_pairs = 1;
+	vndev->max_vqueue_pairs =
+		MIN(virtio_netdev_hw_vqueue_pairs(vndev,
+				vndev->vdev->features
+				& virtio_feature_get(vndev->vdev)),
+		    CONFIG_LIBUKNETDEV_MAXNBQUEUES);
 }
 
 static const struct uk_netdev_ops virtio_netdev_ops = {
@@ -1110,8 +1920,12 @@ static const struct uk_netdev_ops virtio_netdev_ops = {
 	.promiscuous_get = virtio_net_promisc_get,
 	.hwaddr_get = virtio_net_mac_get,
 	.mtu_get = virtio_net_mtu_get,
+	.mtu_set = virtio_net_mtu_set,
 	.txq_info_get = virtio_netdev_txq_info_get,
 	.rxq_info_get = virtio_netdev_rxq_info_get,
+#ifdef CONFIG_LIBUKNETDEV_STATS
+	.einfo_get = virtio_net_einfo_get,
+#endif
 };
 
 static int virtio_net_add_dev(struct virtio_dev *vdev)
@@ -1130,6 +1944,8 @@ static int virtio_net_add_dev(struct virtio_dev *vdev)
 	/* register netdev */
 	vndev->netdev.rx_one = virtio_netdev_recv;
 	vndev->netdev.tx_one = virtio_netdev_xmit;
+	vndev->netdev.rx_burst = virtio_netdev_recv_burst;
+	vndev->netdev.tx_burst = virtio_netdev_xmit_burst;
 	vndev->netdev.ops = &virtio_netdev_ops;
 
 	rc = uk_netdev_drv_register(&vndev->netdev, a, drv_name);
@@ -1139,10 +1955,9 @@ static int virtio_net_add_dev(struct virtio_dev *vdev)
 	}
 	vndev->uid = rc;
 	rc = 0;
-	vndev->max_mtu = UK_ETH_PAYLOAD_MAXLEN;
-	vndev->mtu = vndev->max_mtu;
 	vndev->promisc = 0;
 	virtio_netdev_feature_set(vndev);
+	virtio_netdev_mtu_init(vndev);
 	uk_pr_info("virtio-net device registered with libuknet\n");
 
 exit:
@@ -60,6 +60,31 @@ struct virtio_pci_dev {
 	__u16 pci_isr_addr;
 	/* Pci device information */
 	struct pci_device *pdev;
+	/* Common configuration structure (non-legacy device) */
+	void *common_cfg;
+	/* ISR status register (non-legacy device) */
+	void *isr;
+	/* Device-specific configuration (non-legacy device) */
+	void *device_cfg;
+	/* Base of the notification structure (non-legacy device) */
+	void *notify_base;
+	/* Multiplier for the queue notification offsets */
+	__u32 notify_off_multiplier;
+	/* Notification offset of each virtqueue */
+	__u16 *notify_off;
+	/* Number of entries in the notify_off array */
+	__u16 notify_off_cnt;
+	/* Interrupt handlers are registered */
+	__u8 irq_setup;
+	/**
+	 * MSI-X is enabled: vector 0 signals configuration changes, vector
+	 * i + 1 signals virtqueue i.
+	 */
+	__u8 msix_enabled;
+	/* Virtqueues served by the MSI-X vectors, indexed by queue id */
+	struct virtqueue **msix_vqs;
+	/* Number of entries in the msix_vqs array */
+	__u16 msix_vq_cnt;
 };
 
 /**
@@ -79,8 +104,8 @@ static int vpci_legacy_pci_config_set(struct virtio_dev *vdev, __u16 offset,
 static int vpci_legacy_pci_config_get(struct virtio_dev *vdev, __u16 offset,
 				      void *buf, __u32 len, __u8 type_len);
 static __u64 vpci_legacy_pci_features_get(struct virtio_dev *vdev);
-static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
-					 __u64 features);
+static int vpci_legacy_pci_features_set(struct virtio_dev *vdev,
+					__u64 features);
 static int vpci_legacy_pci_vq_find(struct virtio_dev *vdev, __u16 num_vq,
 				   __u16 *qdesc_size);
 static void vpci_legacy_pci_status_set(struct virtio_dev *vdev, __u8 status);
@@ -96,6 +121,28 @@ static int virtio_pci_handle(void *arg);
 static int vpci_legacy_notify(struct virtio_dev *vdev, __u16 queue_id);
 static int virtio_pci_legacy_add_dev(struct pci_device *pci_dev,
 				     struct virtio_pci_dev *vpci_dev);
+static void vpci_modern_pci_dev_reset(struct virtio_dev *vdev);
+static int vpci_modern_pci_config_set(struct virtio_dev *vdev, __u16 offset,
+				      const void *buf, __u32 len);
+static int vpci_modern_pci_config_get(struct virtio_dev *vdev, __u16 offset,
+				      void *buf, __u32 len, __u8 type_len);
+static __u64 vpci_modern_pci_features_get(struct virtio_dev *vdev);
+static int vpci_modern_pci_features_set(struct virtio_dev *vdev,
+					__u64 features);
+static int vpci_modern_pci_vq_find(struct virtio_dev *vdev, __u16 num_vq,
+				   __u16 *qdesc_size);
+static void vpci_modern_pci_status_set(struct virtio_dev *vdev, __u8 status);
+static __u8 vpci_modern_pci_status_get(struct virtio_dev *vdev);
+static struct virtqueue *vpci_modern_vq_setup(struct virtio_dev *vdev,
+					      __u16 queue_id,
+					      __u16 num_desc,
+					      virtqueue_callback_t callback,
+					      struct uk_alloc *a);
+static void vpci_modern_vq_release(struct virtio_dev *vdev,
+		struct virtqueue *vq, struct uk_alloc *a);
+static int vpci_modern_notify(struct virtio_dev *vdev, __u16 queue_id);
+static int virtio_pci_modern_add_dev(struct pci_device *pci_dev,
+				     struct virtio_pci_dev *vpci_dev);
 
 /**
  * Configuration operations legacy PCI device.
@@ -113,6 +160,38 @@ static struct virtio_config_ops vpci_legacy_ops = {
 	.vq_release   = vpci_legacy_vq_release,
 };
 
+/**
+ * Configuration operations modern PCI device.
+ */
+static struct virtio_config_ops vpci_modern_ops = {
+	.device_reset = vpci_modern_pci_dev_reset,
+	.config_get   = vpci_modern_pci_config_get,
+	.config_set   = vpci_modern_pci_config_set,
+	.features_get = vpci_modern_pci_features_get,
+	.features_set = vpci_modern_pci_features_set,
+	.status_get   = vpci_modern_pci_status_get,
+	.status_set   = vpci_modern_pci_status_set,
+	.vqs_find     = vpci_modern_pci_vq_find,
+	.vq_setup     = vpci_modern_vq_setup,
+	.vq_release   = vpci_modern_vq_release,
+};
+
+/**
+ * Access to the common configuration structure of a modern PCI device.
+ */
+#define vpci_common_read8(vpdev, off) \
+	ioreg_read8((__u8 *)(vpdev)->common_cfg + (off))
+#define vpci_common_read16(vpdev, off) \
+	ioreg_read16((__u16 *)((__u8 *)(vpdev)->common_cfg + (off)))
+#define vpci_common_read32(vpdev, off) \
+	ioreg_read32((__u32 *)((__u8 *)(vpdev)->common_cfg + (off)))
+#define vpci_common_write8(vpdev, off, val) \
+	ioreg_write8((__u8 *)(vpdev)->common_cfg + (off), (val))
+#define vpci_common_write16(vpdev, off, val) \
+	ioreg_write16((__u16 *)((__u8 *)(vpdev)->common_cfg + (off)), (val))
+#define vpci_common_write32(vpdev, off, val) \
+	ioreg_write32((__u32 *)((__u8 *)(vpdev)->common_cfg + (off)), (val))
+
 static int vpci_legacy_notify(struct virtio_dev *vdev, __u16 queue_id)
 {
 	struct virtio_pci_dev *vpdev;
@@ -125,6 +204,107 @@ static int vpci_legacy_notify(struct virtio_dev *vdev, __u16 queue_id)
 	return 0;
 }
 
+/**
+ * Handler of a MSI-X vector that is dedicated to a single virtqueue.
+ */
+static int virtio_pci_vq_handle(void *arg)
+{
+	struct virtqueue *vq = *(struct virtqueue **) arg;
+
+	/* The vector is not shared, so the interrupt is always ours */
+	if (vq)
+		virtqueue_ring_interrupt(vq);
+	return 1;
+}
+
+static int virtio_pci_config_handle(void *arg)
+{
+	uk_pr_warn("Unsupported config change interrupt received on virtio-pci device %p\n",
+		   arg);
+	return 1;
+}
+
+/**
+ * Register the interrupt handlers of the device. We use a MSI-X vector per
+ * virtqueue if possible, and fall back to the shared legacy interrupt.
+ */
+static int virtio_pci_irq_setup(struct virtio_pci_dev *vpdev, __u16 num_vqs)
+{
+	unsigned long *irqs;
+	int rc, i;
+
+	if (vpdev->irq_setup)
+		return 0;
+
+	irqs = uk_malloc(a, (num_vqs + 1) * sizeof(*irqs));
+	vpdev->msix_vqs = uk_calloc(a, num_vqs, sizeof(*vpdev->msix_vqs));
+	if (!irqs || !vpdev->msix_vqs)
+		goto legacy;
+
+	rc = pci_msix_enable(vpdev->pdev, irqs, num_vqs + 1);
+	if (rc < 0) {
+		uk_pr_info("Virtio-pci device %p uses legacy interrupts: %d\n",
+			   vpdev, rc);
+		goto legacy;
+	}
+
+	rc = ukplat_irq_register(irqs[0], virtio_pci_config_handle, vpdev);
+	if (rc != 0)
+		goto err_msix;
+	for (i = 0; i < num_vqs; i++) {
+		rc = ukplat_irq_register(irqs[i + 1], virtio_pci_vq_handle,
+					 &vpdev->msix_vqs[i]);
+		if (rc != 0)
+			goto err_unregister;
+	}
+	uk_free(a, irqs);
+	vpdev->msix_vq_cnt = num_vqs;
+	vpdev->msix_enabled = 1;
+	vpdev->irq_setup = 1;
+	return 0;
+
+err_unregister:
+	while (i-- > 0)
+		ukplat_irq_unregister(irqs[i + 1], virtio_pci_vq_handle,
+				      &vpdev->msix_vqs[i]);
+	ukplat_irq_unregister(irqs[0], virtio_pci_config_handle, vpdev);
+err_msix:
+	uk_pr_warn("Failed to register the MSI-X interrupts of virtio-pci device %p, using legacy interrupts: %d\n",
+		   vpdev, rc);
+	pci_msix_disable(vpdev->pdev, irqs);
+legacy:
+	uk_free(a, irqs);
+	uk_free(a, vpdev->msix_vqs);
+	vpdev->msix_vqs = NULL;
+	rc = ukplat_irq_register(vpdev->pdev->irq, virtio_pci_handle, vpdev);
+	if (rc != 0) {
+		uk_pr_err("Failed to register the interrupt\n");
+		return rc;
+	}
+	vpdev->irq_setup = 1;
+	return 0;
+}
+
+/**
+ * Route the interrupts of a virtqueue to its MSI-X vector.
+ */
+static int virtio_pci_vq_msix_set(struct virtio_pci_dev *vpdev,
+				  struct virtqueue *vq, __u16 vector)
+{
+	long flags;
+
+	if (vector == VIRTIO_MSI_NO_VECTOR) {
+		uk_pr_err("Failed to assign a MSI-X vector to virtqueue %"__PRIu16"\n",
+			  vq->queue_id);
+		return -EBUSY;
+	}
+
+	flags = ukplat_lcpu_save_irqf();
+	vpdev->msix_vqs[vq->queue_id] = vq;
+	ukplat_lcpu_restore_irqf(flags);
+	return 0;
+}
+
 static int virtio_pci_handle(void *arg)
 {
 	struct virtio_pci_dev *d = (struct virtio_pci_dev *) arg;
@@ -135,7 +315,11 @@ static int virtio_pci_handle(void *arg)
 	UK_ASSERT(arg);
 
 	/* Reading the isr status is used to acknowledge the interrupt */
-	isr_status = virtio_cread8((void *)(unsigned long)d->pci_isr_addr, 0);
+	if (d->isr)
+		isr_status = ioreg_read8(d->isr);
+	else
+		isr_status = virtio_cread8((void *)(unsigned long)
+					   d->pci_isr_addr, 0);
 	/* We don't support configuration interrupt on the device */
 	if (isr_status & VIRTIO_PCI_ISR_CONFIG) {
 		uk_pr_warn("Unsupported config change interrupt received on virtio-pci device %p\n",
@@ -160,10 +344,17 @@ static struct virtqueue *vpci_legacy_vq_setup(struct virtio_dev *vdev,
 	struct virtqueue *vq;
 	__phys_addr addr;
 	long flags;
+	int rc;
 
 	UK_ASSERT(vdev != NULL);
 
 	vpdev = to_virtiopcidev(vdev);
+	if (unlikely(vpdev->msix_enabled && queue_id >= vpdev->msix_vq_cnt)) {
+		uk_pr_err("Virtqueue %"__PRIu16" has no interrupt vector\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+
 	vq = virtqueue_create(queue_id, num_desc, VIRTIO_PCI_VRING_ALIGN,
 			      callback, vpci_legacy_notify, vdev, a);
 	if (PTRISERR(vq)) {
@@ -177,6 +368,18 @@ static struct virtqueue *vpci_legacy_vq_setup(struct virtio_dev *vdev,
 	/* Select the queue of interest */
 	virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
 			VIRTIO_PCI_QUEUE_SEL, queue_id);
+	if (vpdev->msix_enabled) {
+		virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
+				VIRTIO_MSI_QUEUE_VECTOR, queue_id + 1);
+		rc = virtio_pci_vq_msix_set(vpdev, vq,
+				virtio_cread16((void *)(unsigned long)
+					       vpdev->pci_base_addr,
+					       VIRTIO_MSI_QUEUE_VECTOR));
+		if (rc != 0) {
+			virtqueue_destroy(vq, a);
+			return ERR2PTR(rc);
+		}
+	}
 	virtio_cwrite32((void *)(unsigned long)vpdev->pci_base_addr,
 			VIRTIO_PCI_QUEUE_PFN,
 			addr >> VIRTIO_PCI_QUEUE_ADDR_SHIFT);
@@ -207,6 +410,8 @@ static void vpci_legacy_vq_release(struct virtio_dev *vdev,
 
 	flags = ukplat_lcpu_save_irqf();
 	UK_TAILQ_REMOVE(&vpdev->vdev.vqs, vq, next);
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[vq->queue_id] = NULL;
 	ukplat_lcpu_restore_irqf(flags);
 
 	virtqueue_destroy(vq, a);
@@ -221,12 +426,13 @@ static int vpci_legacy_pci_vq_find(struct virtio_dev *vdev, __u16 num_vqs,
 	UK_ASSERT(vdev);
 	vpdev = to_virtiopcidev(vdev);
 
-	/* Registering the interrupt for the queue */
-	rc = ukplat_irq_register(vpdev->pdev->irq, virtio_pci_handle, vpdev);
-	if (rc != 0) {
-		uk_pr_err("Failed to register the interrupt\n");
+	/* Registering the interrupts for the queues */
+	rc = virtio_pci_irq_setup(vpdev, num_vqs);
+	if (rc != 0)
 		return rc;
-	}
+	if (vpdev->msix_enabled)
+		virtio_cwrite16((void *)(unsigned long)vpdev->pci_base_addr,
+				VIRTIO_MSI_CONFIG_VECTOR, 0);
 
 	for (i = 0; i < num_vqs; i++) {
 		virtio_cwrite16((void *) (unsigned long)vpdev->pci_base_addr,
@@ -247,12 +453,14 @@ static int vpci_legacy_pci_config_set(struct virtio_dev *vdev, __u16 offset,
 				      const void *buf, __u32 len)
 {
 	struct virtio_pci_dev *vpdev = NULL;
+	__u16 cfg_off;
 
 	UK_ASSERT(vdev);
 	vpdev = to_virtiopcidev(vdev);
+	cfg_off = VIRTIO_PCI_CONFIG_OFF(vpdev->msix_enabled) + offset;
 
 	_virtio_cwrite_bytes((void *)(unsigned long)vpdev->pci_base_addr,
-			     VIRTIO_PCI_CONFIG_OFF + offset, buf, len, 1);
+			     cfg_off, buf, len, 1);
 
 	return 0;
 }
@@ -261,21 +469,22 @@ static int vpci_legacy_pci_config_get(struct virtio_dev *vdev, __u16 offset,
 				      void *buf, __u32 len, __u8 type_len)
 {
 	struct virtio_pci_dev *vpdev = NULL;
+	__u16 cfg_off;
 	int rc = 0;
 
 	UK_ASSERT(vdev);
 	vpdev = to_virtiopcidev(vdev);
+	cfg_off = VIRTIO_PCI_CONFIG_OFF(vpdev->msix_enabled) + offset;
 
 	/* Reading an entity less than 4 bytes are atomic */
 	if (type_len == len && type_len <= 4) {
 		_virtio_cread_bytes(
 				(void *) (unsigned long)vpdev->pci_base_addr,
-				VIRTIO_PCI_CONFIG_OFF + offset, buf, len,
-				type_len);
+				cfg_off, buf, len, type_len);
 	} else {
 		rc = virtio_cread_bytes_many(
 				(void *) (unsigned long)vpdev->pci_base_addr,
-				VIRTIO_PCI_CONFIG_OFF + offset,	buf, len);
+				cfg_off, buf, len);
 	}
 	return rc;
 }
@@ -345,8 +554,8 @@ static __u64 vpci_legacy_pci_features_get(struct virtio_dev *vdev)
 	return features;
 }
 
-static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
-					 __u64 features)
+static int vpci_legacy_pci_features_set(struct virtio_dev *vdev,
+					__u64 features)
 {
 	struct virtio_pci_dev *vpdev = NULL;
 
@@ -356,6 +565,407 @@ static void vpci_legacy_pci_features_set(struct virtio_dev *vdev,
 	features = virtqueue_feature_negotiate(features);
 	virtio_cwrite32((void *) (unsigned long)vpdev->pci_base_addr,
 			VIRTIO_PCI_GUEST_FEATURES, (__u32)features);
+	return 0;
+}
+
+static int vpci_modern_notify(struct virtio_dev *vdev, __u16 queue_id)
+{
+	struct virtio_pci_dev *vpdev;
+	__u8 *addr;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	UK_ASSERT(queue_id < vpdev->notify_off_cnt);
+
+	addr = (__u8 *)vpdev->notify_base +
+		vpdev->notify_off[queue_id] * vpdev->notify_off_multiplier;
+	ioreg_write16((__u16 *)addr, queue_id);
+
+	return 0;
+}
+
+static struct virtqueue *vpci_modern_vq_setup(struct virtio_dev *vdev,
+					      __u16 queue_id,
+					      __u16 num_desc,
+					      virtqueue_callback_t callback,
+					      struct uk_alloc *a)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	struct virtqueue *vq;
+	__phys_addr desc, driver, device;
+	long flags;
+	int rc;
+
+	UK_ASSERT(vdev != NULL);
+
+	vpdev = to_virtiopcidev(vdev);
+	if (unlikely(queue_id >= vpdev->notify_off_cnt)) {
+		uk_pr_err("Virtqueue %"__PRIu16" was not discovered\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+
+	if (unlikely(vpdev->msix_enabled && queue_id >= vpdev->msix_vq_cnt)) {
+		uk_pr_err("Virtqueue %"__PRIu16" has no interrupt vector\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+
+	vq = virtqueue_create(queue_id, num_desc, VIRTIO_PCI_VRING_ALIGN,
+			      callback, vpci_modern_notify, vdev, a);
+	if (PTRISERR(vq)) {
+		uk_pr_err("Failed to create the virtqueue: %d\n",
+			  PTR2ERR(vq));
+		goto err_exit;
+	}
+
+	/* The areas of the queue can be placed anywhere in memory */
+	virtqueue_ring_addrs(vq, &desc, &driver, &device);
+	vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_Q_SELECT, queue_id);
+	vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_Q_SIZE, num_desc);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_DESCLO, (__u32)desc);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_DESCHI,
+			    (__u32)(desc >> 32));
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_AVAILLO, (__u32)driver);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_AVAILHI,
+			    (__u32)(driver >> 32));
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_USEDLO, (__u32)device);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_Q_USEDHI,
+			    (__u32)(device >> 32));
+	if (vpdev->msix_enabled) {
+		vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_Q_MSIX,
+				    queue_id + 1);
+		rc = virtio_pci_vq_msix_set(vpdev, vq,
+				vpci_common_read16(vpdev,
+						   VIRTIO_PCI_COMMON_Q_MSIX));
+		if (rc != 0) {
+			virtqueue_destroy(vq, a);
+			return ERR2PTR(rc);
+		}
+	}
+	vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_Q_ENABLE, 1);
+
+	flags = ukplat_lcpu_save_irqf();
+	UK_TAILQ_INSERT_TAIL(&vpdev->vdev.vqs, vq, next);
+	ukplat_lcpu_restore_irqf(flags);
+
+err_exit:
+	return vq;
+}
+
+static void vpci_modern_vq_release(struct virtio_dev *vdev,
+		struct virtqueue *vq, struct uk_alloc *a)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	long flags;
+
+	UK_ASSERT(vq != NULL);
+	UK_ASSERT(a != NULL);
+	vpdev = to_virtiopcidev(vdev);
+
+	/**
+	 * NOTE: A queue of a modern device cannot be disabled individually,
+	 * the driver has to reset the device before releasing all queues.
+	 */
+	flags = ukplat_lcpu_save_irqf();
+	UK_TAILQ_REMOVE(&vpdev->vdev.vqs, vq, next);
+	if (vpdev->msix_enabled)
+		vpdev->msix_vqs[vq->queue_id] = NULL;
+	ukplat_lcpu_restore_irqf(flags);
+
+	virtqueue_destroy(vq, a);
+}
+
+static int vpci_modern_pci_vq_find(struct virtio_dev *vdev, __u16 num_vqs,
+				   __u16 *qdesc_size)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	int vq_cnt = 0, i = 0, rc = 0;
+	__u16 *notify_off;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+
+	notify_off = uk_calloc(a, num_vqs, sizeof(*notify_off));
+	if (!notify_off) {
+		uk_pr_err("Failed to allocate notification offsets\n");
+		return -ENOMEM;
+	}
+
+	/* Registering the interrupts for the queues */
+	rc = virtio_pci_irq_setup(vpdev, num_vqs);
+	if (rc != 0) {
+		uk_free(a, notify_off);
+		return rc;
+	}
+	if (vpdev->msix_enabled)
+		vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_MSIX, 0);
+
+	for (i = 0; i < num_vqs; i++) {
+		vpci_common_write16(vpdev, VIRTIO_PCI_COMMON_Q_SELECT, i);
+		qdesc_size[i] = vpci_common_read16(vpdev,
+						   VIRTIO_PCI_COMMON_Q_SIZE);
+		if (unlikely(!qdesc_size[i])) {
+			uk_pr_err("Virtqueue %d not available\n", i);
+			continue;
+		}
+		notify_off[i] = vpci_common_read16(vpdev,
+						   VIRTIO_PCI_COMMON_Q_NOFF);
+		vq_cnt++;
+	}
+
+	uk_free(a, vpdev->notify_off);
+	vpdev->notify_off = notify_off;
+	vpdev->notify_off_cnt = num_vqs;
+	return vq_cnt;
+}
+
+static int vpci_modern_pci_config_set(struct virtio_dev *vdev, __u16 offset,
+				      const void *buf, __u32 len)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	__u32 i;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	if (unlikely(!vpdev->device_cfg))
+		return -ENOTSUP;
+
+	for (i = 0; i < len; i++)
+		ioreg_write8((__u8 *)vpdev->device_cfg + offset + i,
+			     ((const __u8 *)buf)[i]);
+
+	return 0;
+}
+
+static int vpci_modern_pci_config_get(struct virtio_dev *vdev, __u16 offset,
+				      void *buf, __u32 len, __u8 type_len)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	__u8 *addr;
+	__u8 gen;
+	__u32 i;
+	int cnt = 0;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	if (unlikely(!vpdev->device_cfg))
+		return -ENOTSUP;
+	addr = (__u8 *)vpdev->device_cfg + offset;
+
+	/* Reading an entity less than 4 bytes are atomic */
+	if (type_len == len && type_len <= 4) {
+		switch (type_len) {
+		case 1:
+			*(__u8 *)buf = ioreg_read8(addr);
+			break;
+		case 2:
+			*(__u16 *)buf = ioreg_read16((__u16 *)addr);
+			break;
+		case 4:
+			*(__u32 *)buf = ioreg_read32((__u32 *)addr);
+			break;
+		default:
+			return -EINVAL;
+		}
+		return 0;
+	}
+
+	/**
+	 * The configuration generation changes if the device modified the
+	 * configuration while we were reading it.
+	 */
+	for (cnt = 0; cnt < MAX_TRY_COUNT; cnt++) {
+		gen = vpci_common_read8(vpdev,
+					VIRTIO_PCI_COMMON_CFGGENERATION);
+		for (i = 0; i < len; i++)
+			((__u8 *)buf)[i] = ioreg_read8(addr + i);
+		if (gen == vpci_common_read8(vpdev,
+					     VIRTIO_PCI_COMMON_CFGGENERATION))
+			return len;
+	}
+	return -EAGAIN;
+}
+
+static __u8 vpci_modern_pci_status_get(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	return vpci_common_read8(vpdev, VIRTIO_PCI_COMMON_STATUS);
+}
+
+static void vpci_modern_pci_status_set(struct virtio_dev *vdev, __u8 status)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	__u8 curr_status = 0;
+
+	/* Reset should be performed using the reset interface */
+	UK_ASSERT(vdev || status != VIRTIO_CONFIG_STATUS_RESET);
+
+	vpdev = to_virtiopcidev(vdev);
+	curr_status = vpci_modern_pci_status_get(vdev);
+	status |= curr_status;
+	vpci_common_write8(vpdev, VIRTIO_PCI_COMMON_STATUS, status);
+}
+
+static void vpci_modern_pci_dev_reset(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+
+	UK_ASSERT(vdev);
+
+	vpdev = to_virtiopcidev(vdev);
+	vpci_common_write8(vpdev, VIRTIO_PCI_COMMON_STATUS,
+			   VIRTIO_CONFIG_STATUS_RESET);
+	/* The reset is complete when the device reads back 0 */
+	while (vpci_common_read8(vpdev, VIRTIO_PCI_COMMON_STATUS)
+	       != VIRTIO_CONFIG_STATUS_RESET)
+		;
+}
+
+static __u64 vpci_modern_pci_features_get(struct virtio_dev *vdev)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+	__u64 features;
+
+	UK_ASSERT(vdev);
+
+	vpdev = to_virtiopcidev(vdev);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_DFSELECT, 0);
+	features = vpci_common_read32(vpdev, VIRTIO_PCI_COMMON_DF);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_DFSELECT, 1);
+	features |= (__u64) vpci_common_read32(vpdev, VIRTIO_PCI_COMMON_DF)
+		    << 32;
+	return features;
+}
+
+static int vpci_modern_pci_features_set(struct virtio_dev *vdev,
+					__u64 features)
+{
+	struct virtio_pci_dev *vpdev = NULL;
+
+	UK_ASSERT(vdev);
+	vpdev = to_virtiopcidev(vdev);
+	/* Mask out features not supported by the virtqueue driver */
+	features = virtqueue_feature_negotiate(features);
+	/* A modern device requires the driver to accept VIRTIO_F_VERSION_1 */
+	VIRTIO_FEATURES_UPDATE(features, VIRTIO_F_VERSION_1);
+	VIRTIO_FEATURES_UPDATE(vdev->features, VIRTIO_F_VERSION_1);
+
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_GFSELECT, 0);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_GF, (__u32)features);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_GFSELECT, 1);
+	vpci_common_write32(vpdev, VIRTIO_PCI_COMMON_GF,
+			    (__u32)(features >> 32));
+
+	/* The device confirms that it accepts the feature subset */
+	vpci_modern_pci_status_set(vdev, VIRTIO_CONFIG_STATUS_FEATURES_OK);
+	if (!(vpci_modern_pci_status_get(vdev)
+	      & VIRTIO_CONFIG_STATUS_FEATURES_OK)) {
+		uk_pr_err("Virtio device %p rejected the features 0x%"__PRIx64"\n",
+			  vdev, features);
+		vpci_modern_pci_status_set(vdev, VIRTIO_CONFIG_STATUS_FAIL);
+		return -ENOTSUP;
+	}
+	return 0;
+}
+
+/**
+ * Locate the register block referenced by a virtio vendor capability.
+ */
+static void *virtio_pci_modern_cap_map(struct pci_device *pci_dev,
+				       __u8 cap, __u32 min_len)
+{
+	__u32 offset, length;
+	__sz bar_len;
+	__u8 bar;
+	__u8 *base;
+
+	bar = pci_config_read8(pci_dev, cap + VIRTIO_PCI_CAP_BAR);
+	offset = pci_config_read32(pci_dev, cap + VIRTIO_PCI_CAP_OFFSET);
+	length = pci_config_read32(pci_dev, cap + VIRTIO_PCI_CAP_LENGTH);
+	if (length < min_len) {
+		uk_pr_err("Virtio capability at 0x%02x too small: %"__PRIu32"\n",
+			  cap, length);
+		return NULL;
+	}
+
+	base = pci_bar_map(pci_dev, bar, &bar_len);
+	if (!base)
+		return NULL;
+	if (offset > bar_len || length > bar_len - offset) {
+		uk_pr_err("Virtio capability at 0x%02x exceeds BAR%d\n",
+			  cap, (int) bar);
+		return NULL;
+	}
+	return base + offset;
+}
+
+static int virtio_pci_modern_add_dev(struct pci_device *pci_dev,
+				     struct virtio_pci_dev *vpci_dev)
+{
+	__u8 cap, type;
+	__u8 common = 0, notify = 0, isr = 0, device = 0;
+	void *common_cfg, *notify_base, *isr_addr, *device_cfg = NULL;
+	__u16 cmd;
+
+	/* Find the first capability of each type */
+	for (cap = pci_cap_next(pci_dev, PCI_CAP_ID_VNDR, 0); cap;
+	     cap = pci_cap_next(pci_dev, PCI_CAP_ID_VNDR, cap)) {
+		type = pci_config_read8(pci_dev, cap + VIRTIO_PCI_CAP_CFG_TYPE);
+		if (type == VIRTIO_PCI_CAP_COMMON_CFG && !common)
+			common = cap;
+		else if (type == VIRTIO_PCI_CAP_NOTIFY_CFG && !notify)
+			notify = cap;
+		else if (type == VIRTIO_PCI_CAP_ISR_CFG && !isr)
+			isr = cap;
+		else if (type == VIRTIO_PCI_CAP_DEVICE_CFG && !device)
+			device = cap;
+	}
+	if (!common || !notify || !isr) {
+		uk_pr_debug("No modern interface on virtio-pci device %04x\n",
+			    pci_dev->id.device_id);
+		return -ENOTSUP;
+	}
+
+	common_cfg = virtio_pci_modern_cap_map(pci_dev, common,
+					       VIRTIO_PCI_COMMON_Q_USEDHI + 4);
+	notify_base = virtio_pci_modern_cap_map(pci_dev, notify, 2);
+	isr_addr = virtio_pci_modern_cap_map(pci_dev, isr, 1);
+	if (device)
+		device_cfg = virtio_pci_modern_cap_map(pci_dev, device, 0);
+	if (!common_cfg || !notify_base || !isr_addr
+	    || (device && !device_cfg))
+		return -ENOTSUP;
+
+	vpci_dev->common_cfg = common_cfg;
+	vpci_dev->notify_base = notify_base;
+	vpci_dev->isr = isr_addr;
+	vpci_dev->device_cfg = device_cfg;
+	vpci_dev->notify_off_multiplier = pci_config_read32(pci_dev,
+					notify + VIRTIO_PCI_NOTIFY_CAP_MULT);
+
+	/* Enable access to the BARs and DMA */
+	cmd = pci_config_read16(pci_dev, PCI_COMMAND);
+	pci_config_write16(pci_dev, PCI_COMMAND,
+			   cmd | PCI_COMMAND_MEMORY | PCI_COMMAND_MASTER);
+
+	/* Setting the configuration operation */
+	vpci_dev->vdev.cops = &vpci_modern_ops;
+
+	uk_pr_info("Added virtio-pci device %04x (modern)\n",
+		   pci_dev->id.device_id);
+
+	/* Mapping the virtio device identifier */
+	if (pci_dev->id.device_id >= VIRTIO_PCI_MODERN_DEVICEID_START)
+		vpci_dev->vdev.id.virtio_device_id = pci_dev->id.device_id
+			- VIRTIO_PCI_MODERN_DEVICEID_START;
+	else
+		vpci_dev->vdev.id.virtio_device_id =
+			pci_dev->id.subsystem_device_id;
+	return 0;
 }
 
 static int virtio_pci_legacy_add_dev(struct pci_device *pci_dev,
@@ -389,7 +999,7 @@ static int virtio_pci_add_dev(struct pci_device *pci_dev)
 
 	UK_ASSERT(pci_dev != NULL);
 
-	vpci_dev = uk_malloc(a, sizeof(*vpci_dev));
+	vpci_dev = uk_calloc(a, 1, sizeof(*vpci_dev));
 	if (!vpci_dev) {
 		uk_pr_err("Failed to allocate virtio-pci device\n");
 		return -ENOMEM;
@@ -400,14 +1010,17 @@ static int virtio_pci_add_dev(struct pci_device *pci_dev)
 	vpci_dev->pci_base_addr = pci_dev->base;
 
 	/**
-	 * Probing for the legacy virtio device. We separate the legacy probing
-	 * with the possibility of supporting the modern PCI device in the
-	 * future.
+	 * Probing for the modern virtio device first. Transitional devices
+	 * also expose the legacy interface, which we use as a fallback.
 	 */
-	rc = virtio_pci_legacy_add_dev(pci_dev, vpci_dev);
+	rc = virtio_pci_modern_add_dev(pci_dev, vpci_dev);
 	if (rc != 0) {
-		uk_pr_err("Failed to probe (legacy) pci device: %d\n", rc);
-		goto free_pci_dev;
+		rc = virtio_pci_legacy_add_dev(pci_dev, vpci_dev);
+		if (rc != 0) {
+			uk_pr_err("Failed to probe (legacy) pci device: %d\n",
+				  rc);
+			goto free_pci_dev;
+		}
 	}
 
 	rc = virtio_bus_register_device(&vpci_dev->vdev);
@@ -43,6 +43,7 @@
 #include <uk/plat/io.h>
 #include <virtio/virtio_ring.h>
 #include <virtio/virtqueue.h>
+#include <virtio/virtio_bus.h>
 
 #define VIRTQUEUE_MAX_SIZE  32768
 #define to_virtqueue_vring(vq)			\
@@ -51,20 +52,41 @@
 struct virtqueue_desc_info {
 	void *cookie;
 	__u16 desc_count;
+	/* Next free buffer id (packed layout) */
+	__u16 next;
 };
 
 struct virtqueue_vring {
 	struct virtqueue vq;
 	/* Descriptor Ring */
 	struct vring vring;
+	/* Descriptor Ring (packed layout) */
+	struct vring_packed vring_packed;
+	/* The ring uses the packed layout */
+	__u8 packed;
 	/* Reference to the vring */
 	void   *vring_mem;
 	/* Keep track of available descriptors */
 	__u16 desc_avail;
-	/* Index of the next available slot */
+	/* Index of the next available slot (next free buffer id if packed) */
 	__u16 head_free_desc;
 	/* Index of the last used descriptor by the host */
 	__u16 last_used_desc_idx;
+	/* Packed layout: next ring slot to make available */
+	__u16 next_avail_idx;
+	/* Packed layout: descriptors made available since the last notify */
+	__u16 num_added;
+	/* Packed layout: wrap counters of the driver and the device */
+	__u8 avail_wrap_counter;
+	__u8 used_wrap_counter;
+	/* Available index at the time of the last host notification */
+	__u16 last_notified_avail_idx;
+	/* Notifications are suppressed with event indexes */
+	__u8 event_idx;
+	/* Indirect descriptor tables, one per ring slot (if negotiated) */
+	struct vring_desc *indirect;
+	/* Minimum number of segments for using an indirect table */
+	__u16 indirect_threshold;
 	/* Cookie to identify driver buffer */
 	struct virtqueue_desc_info vq_info[];
 };
@@ -84,6 +106,37 @@ static inline int virtqueue_buffer_enqueue_segments(
 						    __u16 write_bufs);
 static void virtqueue_vring_init(struct virtqueue_vring *vrq, __u16 nr_desc,
 				 __u16 align);
+static void virtqueue_vring_packed_init(struct virtqueue_vring *vrq,
+					__u16 nr_desc);
+
+static inline __u16 virtqueue_vring_num(struct virtqueue_vring *vrq)
+{
+	return vrq->packed ? vrq->vring_packed.num : vrq->vring.num;
+}
+
+/**
+ * Packed layout: the descriptor at idx was used by the device if both its
+ * available and used flag match the wrap counter.
+ */
+static inline int virtqueue_packed_desc_is_used(struct virtqueue_vring *vrq,
+						__u16 idx, __u8 wrap_counter)
+{
+	volatile __virtio_le16 *flags = &vrq->vring_packed.desc[idx].flags;
+	__u16 f = *flags;
+
+	return !!(f & VRING_PACKED_DESC_F_AVAIL) == wrap_counter
+		&& !!(f & VRING_PACKED_DESC_F_USED) == wrap_counter;
+}
+
+/**
+ * Packed layout: flags marking a descriptor as available for the given
+ * wrap counter.
+ */
+static inline __u16 virtqueue_packed_avail_flags(__u8 wrap_counter)
+{
+	return wrap_counter ? VRING_PACKED_DESC_F_AVAIL
+			    : VRING_PACKED_DESC_F_USED;
+}
 
 /**
  * Driver implementation
@@ -95,7 +148,20 @@ void virtqueue_intr_disable(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
+	if (vrq->packed) {
+		vrq->vring_packed.driver->flags =
+			VRING_PACKED_EVENT_FLAG_DISABLE;
+		return;
+	}
+
 	vrq->vring.avail->flags |= (VRING_AVAIL_F_NO_INTERRUPT);
+	/**
+	 * With event indexes, the device ignores the flag. We move the used
+	 * event index behind the used entries that we already consumed so
+	 * that the device signals only after a full wrap-around.
+	 */
+	if (vrq->event_idx)
+		vring_used_event(&vrq->vring) = vrq->last_used_desc_idx - 1;
 }
 
 int virtqueue_intr_enable(struct virtqueue *vq)
@@ -108,9 +174,33 @@ int virtqueue_intr_enable(struct virtqueue *vq)
 	vrq = to_virtqueue_vring(vq);
 	/* Check if there are no more packets enabled */
 	if (!virtqueue_hasdata(vq)) {
-		if (vrq->vring.avail->flags | VRING_AVAIL_F_NO_INTERRUPT) {
+		if (vrq->packed) {
+			/* Request an interrupt for the next used entry */
+			if (vrq->event_idx) {
+				vrq->vring_packed.driver->off_wrap =
+					vrq->last_used_desc_idx |
+					(vrq->used_wrap_counter
+					 << VRING_PACKED_EVENT_F_WRAP_CTR);
+				wmb();
+				vrq->vring_packed.driver->flags =
+					VRING_PACKED_EVENT_FLAG_DESC;
+			} else {
+				vrq->vring_packed.driver->flags =
+					VRING_PACKED_EVENT_FLAG_ENABLE;
+			}
+			mb();
+			if (virtqueue_hasdata(vq)) {
+				virtqueue_intr_disable(vq);
+				rc = 1;
+			}
+		} else if (vrq->vring.avail->flags
+			   | VRING_AVAIL_F_NO_INTERRUPT) {
 			vrq->vring.avail->flags &=
 				(~VRING_AVAIL_F_NO_INTERRUPT);
+			/* Request an interrupt for the next used entry */
+			if (vrq->event_idx)
+				vring_used_event(&vrq->vring) =
+					vrq->last_used_desc_idx;
 			/**
 			 * We enabled the interrupts. We ensure it using the
 			 * memory barrier and check if there are any further
@@ -177,16 +267,90 @@ static inline void virtqueue_detach_desc(struct virtqueue_vring *vrq,
 	vrq->head_free_desc = head_idx;
 }
 
+static int virtqueue_packed_notify_enabled(struct virtqueue_vring *vrq)
+{
+	volatile struct vring_packed_desc_event *device;
+	__u16 old_idx, new_idx, off_wrap, event_idx;
+
+	device = vrq->vring_packed.device;
+	new_idx = vrq->next_avail_idx;
+	old_idx = new_idx - vrq->num_added;
+	vrq->num_added = 0;
+
+	if (vrq->event_idx) {
+		off_wrap = device->off_wrap;
+		event_idx = off_wrap & ~(1 << VRING_PACKED_EVENT_F_WRAP_CTR);
+		/**
+		 * Bring the event offset into the index space of our current
+		 * wrap-around before comparing it.
+		 */
+		if ((off_wrap >> VRING_PACKED_EVENT_F_WRAP_CTR)
+		    != vrq->avail_wrap_counter)
+			event_idx -= vrq->vring_packed.num;
+		return vring_need_event(event_idx, new_idx, old_idx);
+	}
+	return (device->flags != VRING_PACKED_EVENT_FLAG_DISABLE);
+}
+
 int virtqueue_notify_enabled(struct virtqueue *vq)
 {
 	struct virtqueue_vring *vrq;
+	volatile __virtio_le16 *avail_event;
+	__u16 old_idx, new_idx;
 
 	UK_ASSERT(vq);
 	vrq = to_virtqueue_vring(vq);
 
+	if (vrq->packed)
+		return virtqueue_packed_notify_enabled(vrq);
+
+	if (vrq->event_idx) {
+		/**
+		 * Notify only if the device asked for it with an available
+		 * event index within the entries that we added since the
+		 * last notification.
+		 */
+		old_idx = vrq->last_notified_avail_idx;
+		new_idx = vrq->vring.avail->idx;
+		vrq->last_notified_avail_idx = new_idx;
+		avail_event = &vring_avail_event(&vrq->vring);
+		return vring_need_event(*avail_event, new_idx, old_idx);
+	}
 	return ((vrq->vring.used->flags & VRING_USED_F_NO_NOTIFY) == 0);
 }
 
+static inline void virtqueue_buffer_enqueue_indirect(
+		struct virtqueue_vring *vrq,
+		__u16 head, struct uk_sglist *sg, __u16 read_bufs,
+		__u16 write_bufs)
+{
+	int i = 0, total_desc = 0;
+	struct uk_sglist_seg *segs;
+	struct vring_desc *table;
+
+	total_desc = read_bufs + write_bufs;
+	table = &vrq->indirect[head * CONFIG_VIRTIO_INDIRECT_DESC_MAX];
+
+	for (i = 0; i < total_desc; i++) {
+		segs = &sg->sg_segs[i];
+		table[i].addr = segs->ss_paddr;
+		table[i].len = segs->ss_len;
+		table[i].flags = 0;
+		if (i >= read_bufs)
+			table[i].flags |= VRING_DESC_F_WRITE;
+
+		if (i < total_desc - 1) {
+			table[i].flags |= VRING_DESC_F_NEXT;
+			table[i].next = i + 1;
+		}
+	}
+
+	/* The table occupies a single descriptor of the ring */
+	vrq->vring.desc[head].addr = ukplat_virt_to_phys(table);
+	vrq->vring.desc[head].len = total_desc * sizeof(*table);
+	vrq->vring.desc[head].flags = VRING_DESC_F_INDIRECT;
+}
+
 static inline int virtqueue_buffer_enqueue_segments(
 		struct virtqueue_vring *vrq,
 		__u16 head, struct uk_sglist *sg, __u16 read_bufs,
@@ -220,6 +384,10 @@ int virtqueue_hasdata(struct virtqueue *vq)
 	UK_ASSERT(vq);
 
 	vring = to_virtqueue_vring(vq);
+	if (vring->packed)
+		return virtqueue_packed_desc_is_used(vring,
+						     vring->last_used_desc_idx,
+						     vring->used_wrap_counter);
 	return (vring->last_used_desc_idx != vring->vring.used->idx);
 }
 
@@ -227,10 +395,8 @@ __u64 virtqueue_feature_negotiate(__u64 feature_set)
 {
 	__u64 feature = (1ULL << VIRTIO_TRANSPORT_F_START) - 1;
 
-	/**
-	 * Currently out vring driver does not support any ring feature. We will
-	 * add support to transport feature in the future.
-	 */
+	/* Transport features supported by our vring implementation */
+	feature |= VIRTQUEUE_FEATURES;
 	feature &= feature_set;
 	return feature;
 }
@@ -260,6 +426,64 @@ __phys_addr virtqueue_physaddr(struct virtqueue *vq)
 	return ukplat_virt_to_phys(vrq->vring_mem);
 }
 
+void virtqueue_ring_addrs(struct virtqueue *vq, __phys_addr *desc,
+			  __phys_addr *driver, __phys_addr *device)
+{
+	struct virtqueue_vring *vrq = NULL;
+
+	UK_ASSERT(vq);
+	UK_ASSERT(desc && driver && device);
+
+	vrq = to_virtqueue_vring(vq);
+	if (vrq->packed) {
+		*desc = ukplat_virt_to_phys(vrq->vring_packed.desc);
+		*driver = ukplat_virt_to_phys(vrq->vring_packed.driver);
+		*device = ukplat_virt_to_phys(vrq->vring_packed.device);
+	} else {
+		*desc = ukplat_virt_to_phys(vrq->vring.desc);
+		*driver = ukplat_virt_to_phys(vrq->vring.avail);
+		*device = ukplat_virt_to_phys(vrq->vring.used);
+	}
+}
+
+static int virtqueue_packed_buffer_dequeue(struct virtqueue_vring *vrq,
+					   void **cookie, __u32 *len)
+{
+	struct virtqueue_desc_info *vq_info;
+	struct vring_packed_desc *desc;
+	__u16 id;
+
+	if (!virtqueue_packed_desc_is_used(vrq, vrq->last_used_desc_idx,
+					   vrq->used_wrap_counter))
+		return -ENOMSG;
+	desc = &vrq->vring_packed.desc[vrq->last_used_desc_idx];
+	/**
+	 * We are reading the buffer id and length written by the host
+	 * before it flipped the descriptor flags.
+	 */
+	rmb();
+	id = desc->id;
+	UK_ASSERT(id < vrq->vring_packed.num);
+	vq_info = &vrq->vq_info[id];
+	if (len)
+		*len = desc->len;
+	*cookie = vq_info->cookie;
+	vq_info->cookie = NULL;
+
+	/* The device consumed the whole chain of the buffer */
+	vrq->desc_avail += vq_info->desc_count;
+	vrq->last_used_desc_idx += vq_info->desc_count;
+	if (vrq->last_used_desc_idx >= vrq->vring_packed.num) {
+		vrq->last_used_desc_idx -= vrq->vring_packed.num;
+		vrq->used_wrap_counter ^= 1;
+	}
+
+	/* Return the buffer id to the free list */
+	vq_info->next = vrq->head_free_desc;
+	vrq->head_free_desc = id;
+	return (vrq->vring_packed.num - vrq->desc_avail);
+}
+
 int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
 {
 	struct virtqueue_vring *vrq = NULL;
@@ -270,6 +494,9 @@ int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
 	UK_ASSERT(cookie);
 	vrq = to_virtqueue_vring(vq);
 
+	if (vrq->packed)
+		return virtqueue_packed_buffer_dequeue(vrq, cookie, len);
+
 	/* No new descriptor since last dequeue operation */
 	if (!virtqueue_hasdata(vq))
 		return -ENOMSG;
@@ -289,45 +516,154 @@ int virtqueue_buffer_dequeue(struct virtqueue *vq, void **cookie, __u32 *len)
 	return (vrq->vring.num - vrq->desc_avail);
 }
 
+static int virtqueue_packed_buffer_enqueue(struct virtqueue_vring *vrq,
+					   void *cookie, struct uk_sglist *sg,
+					   __u16 read_bufs, __u16 write_bufs,
+					   int indirect)
+{
+	struct vring_packed_desc *ring = vrq->vring_packed.desc;
+	struct vring_packed_desc *table;
+	struct uk_sglist_seg *segs;
+	__u16 id, head, idx, flags, head_flags = 0;
+	__u8 wrap_counter;
+	int i, total_desc;
+
+	total_desc = read_bufs + write_bufs;
+	/* Get a free buffer id */
+	id = vrq->head_free_desc;
+	UK_ASSERT(id < vrq->vring_packed.num);
+	vrq->head_free_desc = vrq->vq_info[id].next;
+	vrq->vq_info[id].cookie = cookie;
+	vrq->vq_info[id].desc_count = indirect ? 1 : total_desc;
+
+	head = idx = vrq->next_avail_idx;
+	wrap_counter = vrq->avail_wrap_counter;
+
+	if (indirect) {
+		/* The table has the same size as the split layout tables */
+		table = (struct vring_packed_desc *)
+			&vrq->indirect[id * CONFIG_VIRTIO_INDIRECT_DESC_MAX];
+		for (i = 0; i < total_desc; i++) {
+			segs = &sg->sg_segs[i];
+			table[i].addr = segs->ss_paddr;
+			table[i].len = segs->ss_len;
+			table[i].id = 0;
+			table[i].flags = (i >= read_bufs) ?
+					 VRING_DESC_F_WRITE : 0;
+		}
+		ring[idx].addr = ukplat_virt_to_phys(table);
+		ring[idx].len = total_desc * sizeof(*table);
+		ring[idx].id = id;
+		head_flags = VRING_DESC_F_INDIRECT |
+			     virtqueue_packed_avail_flags(wrap_counter);
+		total_desc = 1;
+		if (++idx >= vrq->vring_packed.num) {
+			idx = 0;
+			wrap_counter ^= 1;
+		}
+	} else {
+		for (i = 0; i < total_desc; i++) {
+			segs = &sg->sg_segs[i];
+			ring[idx].addr = segs->ss_paddr;
+			ring[idx].len = segs->ss_len;
+			ring[idx].id = id;
+			flags = virtqueue_packed_avail_flags(wrap_counter);
+			if (i >= read_bufs)
+				flags |= VRING_DESC_F_WRITE;
+			if (i < total_desc - 1)
+				flags |= VRING_DESC_F_NEXT;
+			/**
+			 * The flags of the head are written last, they make
+			 * the whole chain available to the device.
+			 */
+			if (i == 0)
+				head_flags = flags;
+			else
+				ring[idx].flags = flags;
+
+			if (++idx >= vrq->vring_packed.num) {
+				idx = 0;
+				wrap_counter ^= 1;
+			}
+		}
+	}
+
+	/* Metadata maintenance for the virtqueue */
+	vrq->next_avail_idx = idx;
+	vrq->avail_wrap_counter = wrap_counter;
+	vrq->desc_avail -= total_desc;
+	vrq->num_added += total_desc;
+
+	/**
+	 * Write barrier to make sure the descriptors are written before the
+	 * device can see the head as available.
+	 */
+	wmb();
+	ring[head].flags = head_flags;
+
+	uk_pr_debug("Buffer id:%d, head:%d, new head:%d, total_desc:%d\n",
+		    id, head, idx, total_desc);
+	return vrq->desc_avail;
+}
+
 int virtqueue_buffer_enqueue(struct virtqueue *vq, void *cookie,
 			     struct uk_sglist *sg, __u16 read_bufs,
 			     __u16 write_bufs)
 {
 	__u32 total_desc = 0;
+	__u32 ring_desc;
 	__u16 head_idx = 0, idx = 0;
 	struct virtqueue_vring *vrq = NULL;
+	int indirect;
 
 	UK_ASSERT(vq);
 
 	vrq = to_virtqueue_vring(vq);
 	total_desc = read_bufs + write_bufs;
-	if (unlikely(total_desc < 1 || total_desc > vrq->vring.num)) {
+	indirect = vrq->indirect && vrq->indirect_threshold
+		   && total_desc >= vrq->indirect_threshold
+		   && total_desc <= CONFIG_VIRTIO_INDIRECT_DESC_MAX;
+	ring_desc = indirect ? 1 : total_desc;
+	if (unlikely(total_desc < 1
+		     || total_desc > virtqueue_vring_num(vrq))) {
 		uk_pr_err("%"__PRIu32" invalid number of descriptor\n",
 			  total_desc);
 		return -EINVAL;
-	} else if (vrq->desc_avail < total_desc) {
+	} else if (vrq->desc_avail < ring_desc) {
 		uk_pr_err("Available descriptor:%"__PRIu16", Requested descriptor:%"__PRIu32"\n",
-			  vrq->desc_avail, total_desc);
+			  vrq->desc_avail, ring_desc);
 		return -ENOSPC;
 	}
+	UK_ASSERT(cookie);
+
+	if (vrq->packed)
+		return virtqueue_packed_buffer_enqueue(vrq, cookie, sg,
+						       read_bufs, write_bufs,
+						       indirect);
+
 	/* Get the head of free descriptor */
 	head_idx = vrq->head_free_desc;
-	UK_ASSERT(cookie);
 	/* Additional information to reconstruct the data buffer */
 	vrq->vq_info[head_idx].cookie = cookie;
-	vrq->vq_info[head_idx].desc_count = total_desc;
+	vrq->vq_info[head_idx].desc_count = ring_desc;
 
 	/**
 	 * We separate the descriptor management to enqueue segment(s).
 	 */
-	idx = virtqueue_buffer_enqueue_segments(vrq, head_idx, sg,
-			read_bufs, write_bufs);
+	if (indirect) {
+		virtqueue_buffer_enqueue_indirect(vrq, head_idx, sg,
+						  read_bufs, write_bufs);
+		idx = vrq->vring.desc[head_idx].next;
+	} else {
+		idx = virtqueue_buffer_enqueue_segments(vrq, head_idx, sg,
+							read_bufs, write_bufs);
+	}
 	/* Metadata maintenance for the virtqueue */
 	vrq->head_free_desc = idx;
-	vrq->desc_avail -= total_desc;
+	vrq->desc_avail -= ring_desc;
 
 	uk_pr_debug("Old head:%d, new head:%d, total_desc:%d\n",
-		    head_idx, idx, total_desc);
+		    head_idx, idx, ring_desc);
 
 	virtqueue_ring_update_avail(vrq, head_idx);
 	return vrq->desc_avail;
@@ -343,6 +679,7 @@ static void virtqueue_vring_init(struct virtqueue_vring *vrq, __u16 nr_desc,
 	vrq->desc_avail = vrq->vring.num;
 	vrq->head_free_desc = 0;
 	vrq->last_used_desc_idx = 0;
+	vrq->last_notified_avail_idx = 0;
 	for (i = 0; i < nr_desc - 1; i++)
 		vrq->vring.desc[i].next = i + 1;
 	/**
@@ -352,6 +689,27 @@ static void virtqueue_vring_init(struct virtqueue_vring *vrq, __u16 nr_desc,
 	vrq->vring.desc[nr_desc - 1].next = VIRTQUEUE_MAX_SIZE;
 }
 
+static void virtqueue_vring_packed_init(struct virtqueue_vring *vrq,
+					__u16 nr_desc)
+{
+	int i = 0;
+
+	vring_packed_init(&vrq->vring_packed, nr_desc, vrq->vring_mem);
+
+	vrq->desc_avail = vrq->vring_packed.num;
+	vrq->head_free_desc = 0;
+	vrq->last_used_desc_idx = 0;
+	vrq->next_avail_idx = 0;
+	vrq->num_added = 0;
+	/* Both wrap counters start at 1 */
+	vrq->avail_wrap_counter = 1;
+	vrq->used_wrap_counter = 1;
+	/* Chain all buffer ids in the free list */
+	for (i = 0; i < nr_desc - 1; i++)
+		vrq->vq_info[i].next = i + 1;
+	vrq->vq_info[nr_desc - 1].next = VIRTQUEUE_MAX_SIZE;
+}
+
 struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 				   virtqueue_callback_t callback,
 				   virtqueue_notify_host_t notify,
@@ -377,8 +735,14 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 	 * allocation.
 	 */
 	vrq->vring_mem = NULL;
-
-	ring_size = vring_size(nr_descs, align);
+	vrq->indirect = NULL;
+	vrq->packed = vdev && virtio_has_features(vdev->features,
+						  VIRTIO_F_RING_PACKED);
+
+	if (vrq->packed)
+		ring_size = vring_packed_size(nr_descs);
+	else
+		ring_size = vring_size(nr_descs, align);
 	if (uk_posix_memalign(a, &vrq->vring_mem,
 			      __PAGE_SIZE, ring_size) != 0) {
 		uk_pr_err("Allocation of vring failed\n");
@@ -386,7 +750,14 @@ struct virtqueue *virtqueue_create(__u16 queue_id, __u16 nr_descs, __u16 align,
 		goto err_freevq;
 	}
 	memset(vrq->vring_mem, 0, ring_size);
-	virtqueue_vring_init(vrq, nr_descs, align);
+	if (vrq->packed)
+		virtqueue_vring_packed_init(vrq, nr_descs);
+	else
+		virtqueue_vring_init(vrq, nr_descs, align);
+	vrq->event_idx = vdev && virtio_has_features(vdev->features,
+						     VIRTIO_F_EVENT_IDX);
+	/* Indirect tables are allocated once the driver asks for them */
+	vrq->indirect_threshold = 0;
 
 	vq = &vrq->vq;
 	vq->queue_id = queue_id;
@@ -411,11 +782,49 @@ void virtqueue_destroy(struct virtqueue *vq, struct uk_alloc *a)
 
 	/* Free the ring */
 	uk_free(a, vrq->vring_mem);
+	uk_free(a, vrq->indirect);
 
 	/* Free the virtqueue metadata */
 	uk_free(a, vrq);
 }
 
+int virtqueue_indirect_threshold_set(struct virtqueue *vq, __u16 threshold,
+				     struct uk_alloc *a)
+{
+	struct virtqueue_vring *vrq;
+	__u16 nr_descs;
+
+	UK_ASSERT(vq);
+
+	vrq = to_virtqueue_vring(vq);
+	if (threshold == 0 || CONFIG_VIRTIO_INDIRECT_DESC_MAX == 0
+	    || !vq->vdev || !virtio_has_features(vq->vdev->features,
+						 VIRTIO_F_INDIRECT_DESC)) {
+		vrq->indirect_threshold = 0;
+		return 0;
+	}
+
+	/**
+	 * The tables are kept once allocated: Requests that are still in
+	 * flight may refer to them.
+	 */
+	if (!vrq->indirect) {
+		UK_ASSERT(a);
+		nr_descs = vrq->packed ? vrq->vring_packed.num
+				       : vrq->vring.num;
+		vrq->indirect = uk_memalign(a, sizeof(struct vring_desc),
+					    nr_descs
+					    * CONFIG_VIRTIO_INDIRECT_DESC_MAX
+					    * sizeof(struct vring_desc));
+		if (!vrq->indirect) {
+			uk_pr_err("Allocation of indirect descriptors failed\n");
+			return -ENOMEM;
+		}
+	}
+	vrq->indirect_threshold = threshold;
+	return 0;
+}
+
 int virtqueue_is_full(struct virtqueue *vq)
 {
 	struct virtqueue_vring *vrq;
@@ -42,4 +42,10 @@
 #define GDT_DESC_DATA_VAL       0x00cf93000000ffff
 
 
-#define IDT_NUM_ENTRIES         48
+/*
+ * 32 exceptions followed by the IRQ vectors. The table covers all vectors
+ * so that the spurious vector of the local APIC (whose low 4 bits are
+ * hardwired to 1 on older APICs) has a gate.
+ */
+#define IDT_NUM_ENTRIES         256
+#define IDT_SPURIOUS_VECTOR     0xFF
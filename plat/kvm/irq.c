@@ -72,6 +72,32 @@ int ukplat_irq_register(unsigned long irq, irq_handler_func_t func, void *arg)
 	return 0;
 }
 
+int ukplat_irq_unregister(unsigned long irq, irq_handler_func_t func,
+			  void *arg)
+{
+	struct irq_handler *h;
+	unsigned long flags;
+
+	UK_ASSERT(irq < __MAX_IRQ);
+
+	flags = ukplat_lcpu_save_irqf();
+	UK_SLIST_FOREACH(h, &irq_handlers[irq], entries) {
+		if (h->func == func && h->arg == arg)
+			break;
+	}
+	if (!h) {
+		ukplat_lcpu_restore_irqf(flags);
+		return -ENOENT;
+	}
+	UK_SLIST_REMOVE(&irq_handlers[irq], h, struct irq_handler, entries);
+	if (UK_SLIST_EMPTY(&irq_handlers[irq]))
+		intctrl_mask_irq(irq);
+	ukplat_lcpu_restore_irqf(flags);
+
+	uk_free(allocator, h);
+	return 0;
+}
+
 /*
  * TODO: This is a temporary solution used to identify non TSC clock
  * interrupts in order to stop waiting for interrupts with deadline.
@@ -26,12 +26,16 @@
 #include <uk/plat/common/irq.h>
 #include <uk/print.h>
 #include <uk/plat/bootstrap.h>
+#include <uk/alloc.h>
 
 static void cpu_halt(void) __noreturn;
 
 /* TODO: implement CPU reset */
 void ukplat_terminate(enum ukplat_gstate request __unused)
 {
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP || CONFIG_LIBUKALLOC_PROFILE_DUMP
+	uk_alloc_shutdown_dump();
+#endif
 	uk_pr_info("Unikraft halted\n");
 
 	/* Try to make system off */
@@ -23,8 +23,14 @@
 /* Taken from solo5 platform_intr.c */
 
 #include <stdint.h>
+#include <errno.h>
 #include <x86/cpu.h>
+#include <x86/irq.h>
 #include <kvm/intctrl.h>
+#include <kvm-x86/traps.h>
+#include <uk/plat/common/irq.h>
+#include <uk/assert.h>
+#include <uk/bitops.h>
 
 #define PIC1             0x20    /* IO base address for master PIC */
 #define PIC2             0xA0    /* IO base address for slave PIC */
@@ -48,6 +54,65 @@
 #define ICW4_BUF_MASTER  0x0C /* Buffered mode/master */
 #define ICW4_SFN         0x10 /* Special fully nested (not) */
 
+#define PIC_IRQS         16   /* IRQs routed through the PIC */
+#define IRQ_VECTOR_BASE  32   /* Vector of IRQ 0 */
+
+/* Local APIC, used to deliver message-signaled interrupts */
+#define MSR_APIC_BASE         0x1B
+#define APIC_BASE_X2APIC      (1UL << 10)
+#define APIC_BASE_ENABLE      (1UL << 11)
+#define APIC_BASE_ADDR_MASK   (~0xFFFUL)
+#define APIC_REG_ID           0x20
+#define APIC_REG_EOI          0xB0
+#define APIC_REG_SVR          0xF0
+#define APIC_SVR_ENABLE       0x100
+/* x2APIC registers are accessed as MSRs */
+#define MSR_X2APIC_REG(reg)   (0x800 + ((reg) >> 4))
+
+/* MSI message address: fixed delivery to the destination APIC id */
+#define MSI_ADDR_BASE         0xFEE00000UL
+#define MSI_ADDR_DEST_SHIFT   12
+
+static unsigned long apic_base;
+static int apic_x2apic;
+/* Allocated message-signaled IRQs */
+static unsigned long msi_irqs[UK_BITS_TO_LONGS(__MAX_IRQ)];
+
+static __u32 apic_read(unsigned int reg)
+{
+	if (apic_x2apic)
+		return (__u32) rdmsrl(MSR_X2APIC_REG(reg));
+	return ioreg_read32((__u32 *)(apic_base + reg));
+}
+
+static void apic_write(unsigned int reg, __u32 val)
+{
+	if (apic_x2apic)
+		wrmsrl(MSR_X2APIC_REG(reg), val);
+	else
+		ioreg_write32((__u32 *)(apic_base + reg), val);
+}
+
+static void apic_init(void)
+{
+	__u64 base;
+
+	base = rdmsrl(MSR_APIC_BASE);
+	if (!(base & APIC_BASE_ENABLE)) {
+		base |= APIC_BASE_ENABLE;
+		wrmsrl(MSR_APIC_BASE, base);
+	}
+	apic_x2apic = !!(base & APIC_BASE_X2APIC);
+	apic_base = base & APIC_BASE_ADDR_MASK;
+
+	/*
+	 * The firmware usually leaves the APIC software-enabled in virtual
+	 * wire mode for the PIC. Make sure that it accepts interrupts.
+	 */
+	if (!(apic_read(APIC_REG_SVR) & APIC_SVR_ENABLE))
+		apic_write(APIC_REG_SVR, APIC_SVR_ENABLE | IDT_SPURIOUS_VECTOR);
+}
+
 /*
  * arguments:
  * offset1 - vector offset for master PIC vectors on the master become
@@ -83,11 +148,46 @@ static void PIC_remap(int offset1, int offset2)
 
 void intctrl_init(void)
 {
-	PIC_remap(32, 40);
+	PIC_remap(IRQ_VECTOR_BASE, IRQ_VECTOR_BASE + 8);
+	apic_init();
+}
+
+int _ukplat_msi_alloc(unsigned long *irq, __u64 *msg_addr, __u32 *msg_data)
+{
+	unsigned long free_irq;
+	__u32 apic_id;
+
+	free_irq = uk_find_next_zero_bit(msi_irqs, __MAX_IRQ, PIC_IRQS);
+	if (free_irq >= __MAX_IRQ)
+		return -ENOSPC;
+
+	apic_id = apic_read(APIC_REG_ID);
+	if (!apic_x2apic)
+		apic_id >>= 24;
+
+	uk_set_bit(free_irq, msi_irqs);
+	*irq = free_irq;
+	*msg_addr = MSI_ADDR_BASE | (apic_id << MSI_ADDR_DEST_SHIFT);
+	/* Fixed delivery mode, edge triggered */
+	*msg_data = IRQ_VECTOR_BASE + *irq;
+	return 0;
+}
+
+void _ukplat_msi_free(unsigned long irq)
+{
+	UK_ASSERT(irq >= PIC_IRQS && irq < __MAX_IRQ);
+	UK_ASSERT(uk_test_bit(irq, msi_irqs));
+
+	uk_clear_bit(irq, msi_irqs);
 }
 
 void intctrl_ack_irq(unsigned int irq)
 {
+	if (irq >= PIC_IRQS) {
+		apic_write(APIC_REG_EOI, 0);
+		return;
+	}
+
 	if (!IRQ_ON_MASTER(irq))
 		outb(PIC2_COMMAND, PIC_EOI);
 
@@ -98,6 +198,10 @@ void intctrl_mask_irq(unsigned int irq)
 {
 	__u16 port;
 
+	/* Message-signaled interrupts are masked by the device */
+	if (irq >= PIC_IRQS)
+		return;
+
 	port = IRQ_PORT(irq);
 	outb(port, inb(port) | (1 << IRQ_OFFSET(irq)));
 }
@@ -106,6 +210,9 @@ void intctrl_clear_irq(unsigned int irq)
 {
 	__u16 port;
 
+	if (irq >= PIC_IRQS)
+		return;
+
 	port = IRQ_PORT(irq);
 	outb(port, inb(port) & ~(1 << IRQ_OFFSET(irq)));
 }
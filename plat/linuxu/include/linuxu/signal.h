@@ -42,6 +42,7 @@
 
 /* Signal numbers */
 #define SIGALRM       14
+#define SIGIO         29
 
 /* type definitions */
 typedef unsigned long k_sigset_t;
@@ -49,6 +50,16 @@ typedef struct {
 	unsigned long fds_bits[128 / sizeof(long)];
 } k_fd_set;
 
+#define K_FD_SETSIZE  (8 * sizeof(k_fd_set))
+#define k_fd_zero(set) \
+	memset((set), 0, sizeof(k_fd_set))
+#define k_fd_set(fd, set) \
+	((set)->fds_bits[(fd) / (8 * sizeof(long))] |= \
+	 (1UL << ((fd) % (8 * sizeof(long)))))
+#define k_fd_isset(fd, set) \
+	(!!((set)->fds_bits[(fd) / (8 * sizeof(long))] & \
+	    (1UL << ((fd) % (8 * sizeof(long))))))
+
 /* sigaction */
 typedef void (*uk_sighandler_t)(int);
 typedef void (*uk_sigrestore_t)(void);
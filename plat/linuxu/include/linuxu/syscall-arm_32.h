@@ -40,10 +40,14 @@
 #define __SC_WRITE      4
 #define __SC_OPEN       5
 #define __SC_CLOSE      6
+#define __SC_GETPID    20
 #define __SC_MMAP     192 /* use mmap2() since mmap() is obsolete */
 #define __SC_MUNMAP    91
 #define __SC_EXIT       1
 #define __SC_IOCTL     54
+#define __SC_FCNTL     55
+#define __SC_READV    145
+#define __SC_WRITEV   146
 #define __SC_RT_SIGPROCMASK   126
 #define __SC_ARCH_PRCTL       172
 #define __SC_RT_SIGACTION     174
@@ -45,7 +45,11 @@
 #define __SC_RT_SIGACTION   13
 #define __SC_RT_SIGPROCMASK 14
 #define __SC_IOCTL  16
+#define __SC_READV  19
+#define __SC_WRITEV 20
+#define __SC_GETPID 39
 #define __SC_EXIT   60
+#define __SC_FCNTL  72
 #define __SC_ARCH_PRCTL       158
 #define __SC_TIMER_CREATE     222
 #define __SC_TIMER_SETTIME    223
@@ -62,6 +62,69 @@ static inline ssize_t sys_write(int fd, const char *buf, size_t len)
 				  (long) (len));
 }
 
+/*
+ * Linux error numbers returned by the syscalls. They can differ from the
+ * values of the libc (e.g., nolibc uses the BSD numbering).
+ */
+#define K_EINTR       (4)
+#define K_EAGAIN      (11)
+#define K_EFAULT      (14)
+#define K_EINVAL      (22)
+
+struct k_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+static inline ssize_t sys_readv(int fd, const struct k_iovec *iov, int iovcnt)
+{
+	return (ssize_t) syscall3(__SC_READV,
+				  (long) (fd),
+				  (long) (iov),
+				  (long) (iovcnt));
+}
+
+static inline ssize_t sys_writev(int fd, const struct k_iovec *iov,
+				 int iovcnt)
+{
+	return (ssize_t) syscall3(__SC_WRITEV,
+				  (long) (fd),
+				  (long) (iov),
+				  (long) (iovcnt));
+}
+
+#define K_O_RDWR      (02)
+#define K_O_NONBLOCK  (04000)
+#define K_O_ASYNC     (020000)
+static inline int sys_open(const char *pathname, int flags, int mode)
+{
+	return (int) syscall3(__SC_OPEN,
+			      (long) (pathname),
+			      (long) (flags),
+			      (long) (mode));
+}
+
+static inline int sys_close(int fd)
+{
+	return (int) syscall1(__SC_CLOSE,
+			      (long) (fd));
+}
+
+#define K_F_SETFL     (4)
+#define K_F_SETOWN    (8)
+static inline int sys_fcntl(int fd, int cmd, long arg)
+{
+	return (int) syscall3(__SC_FCNTL,
+			      (long) (fd),
+			      (long) (cmd),
+			      (long) (arg));
+}
+
+static inline int sys_getpid(void)
+{
+	return (int) syscall0(__SC_GETPID);
+}
+
 static inline int sys_exit(int status)
 {
 	return (int) syscall1(__SC_EXIT,
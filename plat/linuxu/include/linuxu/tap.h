@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LINUXU_TAP_H__
+#define __LINUXU_TAP_H__
+
+#include <uk/arch/types.h>
+#include <linuxu/ioctl.h>
+
+/*
+ * Definitions of the Linux TUN/TAP interface (include/uapi/linux/if_tun.h,
+ * include/uapi/linux/virtio_net.h). They are not taken from a libc because
+ * the values must match the host kernel and not the unikernel's libc.
+ */
+#define TAP_DEV_PATH           "/dev/net/tun"
+
+#define K_IFNAMSIZ             16
+
+/* ioctls */
+#define TUNSETIFF              0x400454ca
+#define TUNSETOFFLOAD          0x400454d0
+#define TUNSETVNETHDRSZ        0x400454d8
+
+/* TUNSETIFF flags */
+#define IFF_TUN                0x0001
+#define IFF_TAP                0x0002
+#define IFF_NO_PI              0x1000
+#define IFF_MULTI_QUEUE        0x0100
+#define IFF_VNET_HDR           0x4000
+
+/* TUNSETOFFLOAD flags */
+#define TUN_F_CSUM             0x01
+#define TUN_F_TSO4             0x02
+#define TUN_F_TSO6             0x04
+#define TUN_F_TSO_ECN          0x08
+
+/* Only the interface name and the flags of struct ifreq are used */
+struct k_ifreq {
+	char ifr_name[K_IFNAMSIZ];
+	union {
+		__s16 ifr_flags;
+		char __pad[24];
+	};
+};
+
+/**
+ * Header that precedes each frame on a TAP file descriptor that was set up
+ * with IFF_VNET_HDR. It has the layout of the legacy virtio-net header.
+ */
+struct tap_vnet_hdr {
+#define TAP_VNET_HDR_F_NEEDS_CSUM  1
+#define TAP_VNET_HDR_F_DATA_VALID  2
+	__u8 flags;
+#define TAP_VNET_HDR_GSO_NONE      0
+#define TAP_VNET_HDR_GSO_TCPV4     1
+#define TAP_VNET_HDR_GSO_UDP       3
+#define TAP_VNET_HDR_GSO_TCPV6     4
+#define TAP_VNET_HDR_GSO_ECN       0x80
+	__u8 gso_type;
+	__u16 hdr_len;
+	__u16 gso_size;
+	__u16 csum_start;
+	__u16 csum_offset;
+};
+
+#endif /* __LINUXU_TAP_H__ */
@@ -38,7 +38,7 @@
 #include <linuxu/syscall.h>
 #include <linuxu/signal.h>
 
-#define IRQS_NUM    16
+#define IRQS_NUM    32
 
 /* IRQ handlers declarations */
 struct irq_handler {
@@ -187,6 +187,32 @@ err:
 	return -rc;
 }
 
+int ukplat_irq_unregister(unsigned long irq, irq_handler_func_t func,
+			  void *arg)
+{
+	struct irq_handler *h;
+	unsigned long flags;
+
+	if (irq >= IRQS_NUM)
+		return -EINVAL;
+
+	/* The signal action stays installed, later signals are unhandled */
+	flags = ukplat_lcpu_save_irqf();
+	UK_SLIST_FOREACH(h, &irq_handlers[irq], entries) {
+		if (h->func == func && h->arg == arg)
+			break;
+	}
+	if (!h) {
+		ukplat_lcpu_restore_irqf(flags);
+		return -ENOENT;
+	}
+	UK_SLIST_REMOVE(&irq_handlers[irq], h, struct irq_handler, entries);
+	ukplat_lcpu_restore_irqf(flags);
+
+	uk_free(allocator, h);
+	return 0;
+}
+
 int ukplat_irq_init(struct uk_alloc *a)
 {
 	UK_ASSERT(!irq_enabled);
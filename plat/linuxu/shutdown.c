@@ -37,6 +37,7 @@
 #include <linuxu/syscall.h>
 #include <uk/arch/lcpu.h>
 #include <uk/plat/bootstrap.h>
+#include <uk/alloc.h>
 #include <uk/print.h>
 
 #include <linuxu/console.h>
@@ -45,6 +46,10 @@ __noreturn void ukplat_terminate(enum ukplat_gstate request)
 {
 	int ret;
 
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP || CONFIG_LIBUKALLOC_PROFILE_DUMP
+	uk_alloc_shutdown_dump();
+#endif
+
 	_liblinuxuplat_fini_console();
 
 	switch (request) {
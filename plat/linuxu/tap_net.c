@@ -0,0 +1,906 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/*
+ * Copyright (c) 2026, The Unikraft Authors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Network device driver for Linux TAP interfaces. Each queue pair of a
+ * uknetdev device is backed by one file descriptor that is attached to the
+ * TAP interface (multiple with IFF_MULTI_QUEUE). Frames are exchanged with
+ * readv()/writev() together with a virtio-net header (IFF_VNET_HDR) that
+ * carries checksum and segmentation offload information. Receive interrupts
+ * are delivered with SIGIO.
+ */
+
+#include <string.h>
+#include <uk/print.h>
+#include <uk/assert.h>
+#include <uk/essentials.h>
+#include <uk/list.h>
+#include <uk/bus.h>
+#include <uk/libparam.h>
+#include <uk/netbuf.h>
+#include <uk/netdev.h>
+#include <uk/netdev_core.h>
+#include <uk/netdev_driver.h>
+#include <uk/plat/lcpu.h>
+#include <uk/plat/irq.h>
+#include <linuxu/syscall.h>
+#include <linuxu/signal.h>
+#include <linuxu/tap.h>
+
+#define DRIVER_NAME          "tap-net"
+
+#define TAPNET_MAX_QUEUE_PAIRS  16
+#define TAPNET_MTU              1500
+#define TAPNET_MIN_FRAME_LEN    UK_ETH_HDR_UNTAGGED_LEN
+#define TAPNET_MAX_NB_DESC      4096
+
+/* Number of receive buffers that are allocated at once */
+#define TAPNET_RX_BATCHLEN      32
+/* Maximum number of netbufs in a transmitted chain */
+#define TAPNET_TX_MAX_IOV       64
+
+#define TAPNET_INTR_EN          (1 << 0)
+#define TAPNET_INTR_USR_EN      (1 << 1)
+
+#define to_tapnetdev(ndev) \
+	__containerof(ndev, struct tap_net_device, netdev)
+
+struct tap_net_device;
+
+struct uk_netdev_rx_queue {
+	struct tap_net_device *tdev;
+	/* File descriptor of the queue pair */
+	int fd;
+	/* User queue identifier */
+	__u16 lqueue_id;
+	/* Interrupt state: TAPNET_INTR_* */
+	__u8 intr_enabled;
+	/* User-provided receive buffer allocation function */
+	uk_netdev_alloc_rxpkts alloc_rxpkts;
+	void *alloc_rxpkts_argp;
+	/* Pre-allocated receive buffers */
+	__u16 nb_stash;
+	struct uk_netbuf *stash[TAPNET_RX_BATCHLEN];
+};
+
+struct uk_netdev_tx_queue {
+	struct tap_net_device *tdev;
+	/* File descriptor of the queue pair */
+	int fd;
+	/* User queue identifier */
+	__u16 lqueue_id;
+};
+
+struct tap_net_device {
+	/* Network device */
+	struct uk_netdev netdev;
+	/* List of TAP devices, scanned on SIGIO */
+	UK_TAILQ_ENTRY(struct tap_net_device) next;
+	/* Host interface name */
+	char ifname[K_IFNAMSIZ];
+	/* Network device identifier */
+	__u16 uid;
+	/* Flags used for attaching queues to the interface */
+	__s16 ifflags;
+	/* Maximum number of queue pairs */
+	__u16 max_qpairs;
+	/* File descriptors of the queue pairs */
+	int fds[TAPNET_MAX_QUEUE_PAIRS];
+	__u16 nb_fds;
+	/* Configured queues */
+	__u16 rxq_cnt;
+	__u16 txq_cnt;
+	struct uk_netdev_rx_queue *rxqs;
+	struct uk_netdev_tx_queue *txqs;
+	/* Guest MAC address */
+	struct uk_hwaddr hw_addr;
+	__u16 mtu;
+};
+
+UK_TAILQ_HEAD(tap_net_device_list, struct tap_net_device);
+
+static struct tap_net_device_list tapnet_list =
+	UK_TAILQ_HEAD_INITIALIZER(tapnet_list);
+static const char *drv_name = DRIVER_NAME;
+static struct uk_alloc *a;
+
+/*
+ * Comma-separated list of the host TAP interfaces to attach to, e.g.:
+ * linuxu.tap_ifnames=tap0,tap1
+ */
+static char *tap_ifnames = CONFIG_LINUXU_TAPNET_IFNAMES;
+UK_LIB_PARAM_STR(tap_ifnames);
+
+/**
+ * Checks without blocking whether a frame can be read from a file
+ * descriptor.
+ * @return
+ *	1 A frame is available.
+ *	0 The queue is empty.
+ */
+static int tapnet_fd_readable(int fd)
+{
+	struct k_timespec timeout = { 0, 0 };
+	k_fd_set readfds;
+
+	k_fd_zero(&readfds);
+	k_fd_set(fd, &readfds);
+	return sys_pselect6(fd + 1, &readfds, NULL, NULL, &timeout, NULL) > 0;
+}
+
+/**
+ * Opens a file descriptor and attaches it as a queue to the TAP interface.
+ * @return
+ *	>= 0 The file descriptor.
+ *	< 0 A negative host error code.
+ */
+static int tapnet_fd_open(const char *ifname, __s16 ifflags)
+{
+	struct k_ifreq ifr;
+	int hdrsz = sizeof(struct tap_vnet_hdr);
+	int fd;
+	int rc;
+
+	fd = sys_open(TAP_DEV_PATH, K_O_RDWR | K_O_NONBLOCK, 0);
+	if (fd < 0)
+		return fd;
+	/* Readiness is checked with pselect6() */
+	if (unlikely((unsigned long) fd >= K_FD_SETSIZE)) {
+		rc = -K_EINVAL;
+		goto err_close;
+	}
+
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, ifname, K_IFNAMSIZ - 1);
+	ifr.ifr_flags = ifflags;
+	rc = sys_ioctl(fd, TUNSETIFF, &ifr);
+	if (rc < 0)
+		goto err_close;
+	rc = sys_ioctl(fd, TUNSETVNETHDRSZ, &hdrsz);
+	if (rc < 0)
+		goto err_close;
+	/* Accept partially checksummed frames from the host */
+	rc = sys_ioctl(fd, TUNSETOFFLOAD,
+		       (void *) (unsigned long) TUN_F_CSUM);
+	if (rc < 0)
+		goto err_close;
+
+	/* Receive a SIGIO when a frame arrives */
+	rc = sys_fcntl(fd, K_F_SETOWN, sys_getpid());
+	if (rc < 0)
+		goto err_close;
+	rc = sys_fcntl(fd, K_F_SETFL, K_O_RDWR | K_O_NONBLOCK | K_O_ASYNC);
+	if (rc < 0)
+		goto err_close;
+	return fd;
+
+err_close:
+	sys_close(fd);
+	return rc;
+}
+
+static int tapnet_sigio_handle(void *arg __unused)
+{
+	struct tap_net_device *tdev;
+	struct uk_netdev_rx_queue *rxq;
+	struct k_timespec timeout = { 0, 0 };
+	k_fd_set readfds;
+	int nfds = 0;
+	__u16 i;
+
+	/* Poll all queues that wait for an interrupt with a single syscall */
+	k_fd_zero(&readfds);
+	UK_TAILQ_FOREACH(tdev, &tapnet_list, next) {
+		for (i = 0; i < tdev->rxq_cnt; i++) {
+			rxq = &tdev->rxqs[i];
+			if (!(rxq->intr_enabled & TAPNET_INTR_EN))
+				continue;
+			k_fd_set(rxq->fd, &readfds);
+			nfds = MAX(nfds, rxq->fd + 1);
+		}
+	}
+	if (!nfds ||
+	    sys_pselect6(nfds, &readfds, NULL, NULL, &timeout, NULL) <= 0)
+		return 1;
+
+	UK_TAILQ_FOREACH(tdev, &tapnet_list, next) {
+		for (i = 0; i < tdev->rxq_cnt; i++) {
+			rxq = &tdev->rxqs[i];
+			if (!(rxq->intr_enabled & TAPNET_INTR_EN)
+			    || !k_fd_isset(rxq->fd, &readfds))
+				continue;
+			/* Interrupts stay off until the user re-enables them */
+			rxq->intr_enabled &= ~TAPNET_INTR_EN;
+			uk_netdev_drv_rx_event(&tdev->netdev, rxq->lqueue_id);
+		}
+	}
+
+	/* SIGIO is used by this driver only */
+	return 1;
+}
+
+static int tapnet_tx_offload(struct tap_vnet_hdr *vhdr,
+			     const struct uk_netbuf *pkt)
+{
+	if (pkt->flags & UK_NETBUF_F_PARTIAL_CSUM) {
+		vhdr->flags = TAP_VNET_HDR_F_NEEDS_CSUM;
+		vhdr->csum_start = pkt->csum_start;
+		vhdr->csum_offset = pkt->csum_offset;
+	}
+
+	switch (pkt->flags & UK_NETBUF_F_GSO_MASK) {
+	case 0:
+		return 0;
+	case UK_NETBUF_F_GSO_TCPV4:
+		vhdr->gso_type = TAP_VNET_HDR_GSO_TCPV4;
+		break;
+	case UK_NETBUF_F_GSO_TCPV6:
+		vhdr->gso_type = TAP_VNET_HDR_GSO_TCPV6;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	/* Segmentation requires the host to compute the checksums */
+	if (unlikely(!(pkt->flags & UK_NETBUF_F_PARTIAL_CSUM)))
+		return -EINVAL;
+	if (pkt->flags & UK_NETBUF_F_GSO_ECN)
+		vhdr->gso_type |= TAP_VNET_HDR_GSO_ECN;
+	vhdr->hdr_len = pkt->header_len;
+	vhdr->gso_size = pkt->gso_size;
+	return 0;
+}
+
+/**
+ * Writes a packet together with its virtio-net header to the TAP interface.
+ * The packet is released on success.
+ * @return
+ *	0 The packet was sent.
+ *	< 0 A negative error code (-ENOSPC if the host queue is full).
+ */
+static int tapnet_xmit_one(struct uk_netdev_tx_queue *txq,
+			   struct uk_netbuf *pkt)
+{
+	struct tap_vnet_hdr vhdr;
+	struct k_iovec iov[TAPNET_TX_MAX_IOV + 1];
+	struct uk_netbuf *nb;
+	ssize_t len;
+	int cnt = 1;
+	int rc;
+
+	memset(&vhdr, 0, sizeof(vhdr));
+	rc = tapnet_tx_offload(&vhdr, pkt);
+	if (unlikely(rc < 0)) {
+		uk_pr_err(DRIVER_NAME": Unsupported offload request: %d\n",
+			  rc);
+		return rc;
+	}
+	iov[0].iov_base = &vhdr;
+	iov[0].iov_len = sizeof(vhdr);
+	UK_NETBUF_CHAIN_FOREACH(nb, pkt) {
+		if (unlikely(cnt > TAPNET_TX_MAX_IOV))
+			return -EINVAL;
+		iov[cnt].iov_base = nb->data;
+		iov[cnt].iov_len = nb->len;
+		cnt++;
+	}
+
+	len = sys_writev(txq->fd, iov, cnt);
+	if (unlikely(len < 0)) {
+		if (len == -K_EAGAIN)
+			return -ENOSPC;
+		uk_pr_err(DRIVER_NAME": Failed to send a frame: host error %d\n",
+			  (int) -len);
+		uk_netdev_drv_txq_stats_add(&txq->tdev->netdev,
+					    txq->lqueue_id, errors, 1);
+		return -EIO;
+	}
+
+	uk_netbuf_free(pkt);
+	return 0;
+}
+
+static int tapnet_xmit(struct uk_netdev *dev,
+		       struct uk_netdev_tx_queue *queue,
+		       struct uk_netbuf *pkt)
+{
+	int rc;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(pkt && queue);
+
+	rc = tapnet_xmit_one(queue, pkt);
+	if (likely(rc == 0))
+		return UK_NETDEV_STATUS_SUCCESS | UK_NETDEV_STATUS_MORE;
+	return (rc == -ENOSPC) ? 0x0 : rc;
+}
+
+static int tapnet_xmit_burst(struct uk_netdev *dev,
+			     struct uk_netdev_tx_queue *queue,
+			     struct uk_netbuf **pkt, __u16 *cnt)
+{
+	int rc = 0;
+	__u16 i;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(queue && pkt && cnt);
+
+	for (i = 0; i < *cnt; ++i) {
+		rc = tapnet_xmit_one(queue, pkt[i]);
+		if (unlikely(rc < 0))
+			break;
+	}
+
+	if (unlikely(i == 0 && rc != -ENOSPC))
+		return rc;
+
+	*cnt = i;
+	if (i == 0)
+		return 0x0;
+	return UK_NETDEV_STATUS_SUCCESS
+	       | ((rc == 0) ? UK_NETDEV_STATUS_MORE : 0x0);
+}
+
+static void tapnet_rx_offload(struct uk_netbuf *buf,
+			      const struct tap_vnet_hdr *vhdr)
+{
+	buf->flags = 0;
+	if (vhdr->flags & TAP_VNET_HDR_F_DATA_VALID)
+		buf->flags |= UK_NETBUF_F_DATA_VALID;
+	if (vhdr->flags & TAP_VNET_HDR_F_NEEDS_CSUM) {
+		buf->flags |= UK_NETBUF_F_PARTIAL_CSUM;
+		buf->csum_start = vhdr->csum_start;
+		buf->csum_offset = vhdr->csum_offset;
+	}
+}
+
+/**
+ * Refills the stash of receive buffers.
+ * @return
+ *	The number of buffers in the stash.
+ */
+static __u16 tapnet_rx_fillup(struct uk_netdev_rx_queue *rxq)
+{
+	__u16 cnt = TAPNET_RX_BATCHLEN - rxq->nb_stash;
+
+	if (cnt > 0)
+		rxq->nb_stash += rxq->alloc_rxpkts(rxq->alloc_rxpkts_argp,
+						   &rxq->stash[rxq->nb_stash],
+						   cnt);
+	return rxq->nb_stash;
+}
+
+/**
+ * Reads a single frame from the TAP interface into a stashed buffer.
+ * @return
+ *	0 A frame was received and returned with `pkt`.
+ *	-EAGAIN The queue is empty.
+ *	-EMSGSIZE The frame was malformed or did not fit into the buffer and
+ *	    got dropped.
+ *	-EIO Any other error.
+ */
+static int tapnet_rxq_dequeue(struct uk_netdev_rx_queue *rxq,
+			      struct uk_netbuf **pkt)
+{
+	struct tap_vnet_hdr vhdr;
+	struct k_iovec iov[2];
+	struct uk_netbuf *buf;
+	ssize_t len;
+
+	UK_ASSERT(rxq->nb_stash > 0);
+	buf = rxq->stash[rxq->nb_stash - 1];
+
+	iov[0].iov_base = &vhdr;
+	iov[0].iov_len = sizeof(vhdr);
+	iov[1].iov_base = buf->data;
+	iov[1].iov_len = buf->len;
+	len = sys_readv(rxq->fd, iov, 2);
+	if (len < 0) {
+		if (len == -K_EAGAIN)
+			return -EAGAIN;
+		if (len == -K_EFAULT)
+			return -EMSGSIZE;
+		uk_pr_err(DRIVER_NAME": Failed to receive a frame: host error %d\n",
+			  (int) -len);
+		return -EIO;
+	}
+	if (unlikely(len < (ssize_t) (sizeof(vhdr) + TAPNET_MIN_FRAME_LEN)))
+		return -EMSGSIZE;
+
+	rxq->nb_stash--;
+	buf->len = len - sizeof(vhdr);
+	tapnet_rx_offload(buf, &vhdr);
+	*pkt = buf;
+	return 0;
+}
+
+static int tapnet_recv_burst(struct uk_netdev *dev,
+			     struct uk_netdev_rx_queue *queue,
+			     struct uk_netbuf **pkt, __u16 *cnt)
+{
+	int status = 0x0;
+	unsigned long flags;
+	int rc = 0;
+	__u16 i = 0;
+
+	UK_ASSERT(dev && queue);
+	UK_ASSERT(pkt && cnt);
+
+	/* Queue interrupts have to be off when calling receive */
+	UK_ASSERT(!(queue->intr_enabled & TAPNET_INTR_EN));
+
+dequeue:
+	while (i < *cnt) {
+		if (unlikely(!queue->nb_stash && !tapnet_rx_fillup(queue))) {
+			status |= UK_NETDEV_STATUS_UNDERRUN;
+			break;
+		}
+		rc = tapnet_rxq_dequeue(queue, &pkt[i]);
+		if (rc == -EMSGSIZE) {
+			uk_netdev_drv_rxq_stats_add(dev, queue->lqueue_id,
+						    drops, 1);
+			continue;
+		}
+		if (rc < 0)
+			break;
+
+		switch (uk_netdev_drv_rx_filter(dev, queue->lqueue_id,
+						pkt[i])) {
+		case UK_NETDEV_RX_PASS:
+			i++;
+			break;
+		case UK_NETDEV_RX_DROP:
+			/* Return the buffer with its full size to the stash */
+			pkt[i]->len = pkt[i]->buflen
+				      - uk_netbuf_headroom(pkt[i]);
+			queue->stash[queue->nb_stash++] = pkt[i];
+			break;
+		default:
+			break;
+		}
+	}
+	if (unlikely(rc < 0 && rc != -EAGAIN && i == 0))
+		return rc;
+
+	if (i == *cnt) {
+		/* The burst is full, there might be further packets */
+		status |= UK_NETDEV_STATUS_MORE;
+	} else if (queue->intr_enabled & TAPNET_INTR_USR_EN) {
+		/* The queue is drained: Enable the interrupt again */
+		flags = ukplat_lcpu_save_irqf();
+		if (!tapnet_fd_readable(queue->fd))
+			queue->intr_enabled |= TAPNET_INTR_EN;
+		ukplat_lcpu_restore_irqf(flags);
+
+		if (!(queue->intr_enabled & TAPNET_INTR_EN)) {
+			/**
+			 * Frame arrived after reading the queue and before
+			 * enabling the interrupt
+			 */
+			if (i == 0 && !(status & UK_NETDEV_STATUS_UNDERRUN))
+				goto dequeue;
+			status |= UK_NETDEV_STATUS_MORE;
+		}
+	}
+
+	*cnt = i;
+	if (i > 0)
+		status |= UK_NETDEV_STATUS_SUCCESS;
+	return status;
+}
+
+static int tapnet_recv(struct uk_netdev *dev,
+		       struct uk_netdev_rx_queue *queue,
+		       struct uk_netbuf **pkt)
+{
+	__u16 cnt = 1;
+	int status;
+
+	status = tapnet_recv_burst(dev, queue, pkt, &cnt);
+	if (status >= 0 && cnt == 0)
+		*pkt = NULL;
+	return status;
+}
+
+static int tapnet_rx_intr_enable(struct uk_netdev *n,
+				 struct uk_netdev_rx_queue *queue)
+{
+	unsigned long flags;
+	int rc = 0;
+
+	UK_ASSERT(n);
+	/* If the interrupt is enabled */
+	if (queue->intr_enabled & TAPNET_INTR_EN)
+		return 0;
+
+	/**
+	 * Enable the user configuration bit. This would cause the interrupt to
+	 * be enabled automatically when the queue got drained, if the
+	 * interrupt could not be enabled now due to data in the queue.
+	 * SIGIO is held back while checking so that no frame goes unnoticed.
+	 */
+	flags = ukplat_lcpu_save_irqf();
+	queue->intr_enabled = TAPNET_INTR_USR_EN;
+	if (tapnet_fd_readable(queue->fd))
+		rc = 1;
+	else
+		queue->intr_enabled |= TAPNET_INTR_EN;
+	ukplat_lcpu_restore_irqf(flags);
+
+	return rc;
+}
+
+static int tapnet_rx_intr_disable(struct uk_netdev *n,
+				  struct uk_netdev_rx_queue *queue)
+{
+	UK_ASSERT(n);
+	queue->intr_enabled &= ~(TAPNET_INTR_USR_EN | TAPNET_INTR_EN);
+	return 0;
+}
+
+static struct uk_netdev_rx_queue *tapnet_rx_queue_setup(
+				struct uk_netdev *n, uint16_t queue_id,
+				uint16_t nb_desc __unused,
+				struct uk_netdev_rxqueue_conf *conf)
+{
+	struct tap_net_device *tdev;
+	struct uk_netdev_rx_queue *rxq;
+
+	UK_ASSERT(n);
+	UK_ASSERT(conf);
+	UK_ASSERT(conf->alloc_rxpkts);
+
+	tdev = to_tapnetdev(n);
+	if (queue_id >= tdev->rxq_cnt) {
+		uk_pr_err(DRIVER_NAME": Invalid queue identifier: %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+
+	rxq = &tdev->rxqs[queue_id];
+	rxq->alloc_rxpkts = conf->alloc_rxpkts;
+	rxq->alloc_rxpkts_argp = conf->alloc_rxpkts_argp;
+	tapnet_rx_fillup(rxq);
+	return rxq;
+}
+
+static struct uk_netdev_tx_queue *tapnet_tx_queue_setup(
+				struct uk_netdev *n, uint16_t queue_id,
+				uint16_t nb_desc __unused,
+				struct uk_netdev_txqueue_conf *conf __unused)
+{
+	struct tap_net_device *tdev;
+
+	UK_ASSERT(n);
+	tdev = to_tapnetdev(n);
+	if (queue_id >= tdev->txq_cnt) {
+		uk_pr_err(DRIVER_NAME": Invalid queue identifier: %"__PRIu16"\n",
+			  queue_id);
+		return ERR2PTR(-EINVAL);
+	}
+	return &tdev->txqs[queue_id];
+}
+
+static int tapnet_queue_info_get(struct uk_netdev *dev,
+				 __u16 queue_id,
+				 struct uk_netdev_queue_info *qinfo)
+{
+	struct tap_net_device *tdev;
+
+	UK_ASSERT(dev);
+	UK_ASSERT(qinfo);
+	tdev = to_tapnetdev(dev);
+	if (unlikely(queue_id >= tdev->max_qpairs)) {
+		uk_pr_err(DRIVER_NAME": Invalid queue_id %"__PRIu16"\n",
+			  queue_id);
+		return -EINVAL;
+	}
+
+	/* The host queue is not exposed; descriptors are not used */
+	qinfo->nb_min = 1;
+	qinfo->nb_max = TAPNET_MAX_NB_DESC;
+	qinfo->nb_align = 0;
+	qinfo->nb_is_power_of_two = 0;
+	return 0;
+}
+
+static int tapnet_configure(struct uk_netdev *n,
+			    const struct uk_netdev_conf *conf)
+{
+	struct tap_net_device *tdev;
+	__u16 qpairs, i;
+	int fd;
+
+	UK_ASSERT(n);
+	UK_ASSERT(conf);
+	tdev = to_tapnetdev(n);
+
+	qpairs = MAX(conf->nb_rx_queues, conf->nb_tx_queues);
+	if (qpairs > tdev->max_qpairs) {
+		uk_pr_err(DRIVER_NAME": %s: %"__PRIu16" queue pairs requested, %"__PRIu16" supported\n",
+			  tdev->ifname, qpairs, tdev->max_qpairs);
+		return -ENOTSUP;
+	}
+
+	/* Attach a file descriptor for each additional queue pair */
+	while (tdev->nb_fds < qpairs) {
+		fd = tapnet_fd_open(tdev->ifname, tdev->ifflags);
+		if (fd < 0) {
+			uk_pr_err(DRIVER_NAME": %s: Failed to attach queue %"__PRIu16": host error %d\n",
+				  tdev->ifname, tdev->nb_fds, -fd);
+			return -EIO;
+		}
+		tdev->fds[tdev->nb_fds++] = fd;
+	}
+
+	tdev->rxqs = uk_calloc(a, conf->nb_rx_queues, sizeof(*tdev->rxqs));
+	tdev->txqs = uk_calloc(a, conf->nb_tx_queues, sizeof(*tdev->txqs));
+	if (unlikely((conf->nb_rx_queues && !tdev->rxqs)
+		     || (conf->nb_tx_queues && !tdev->txqs))) {
+		uk_free(a, tdev->rxqs);
+		uk_free(a, tdev->txqs);
+		tdev->rxqs = NULL;
+		tdev->txqs = NULL;
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < conf->nb_rx_queues; i++) {
+		tdev->rxqs[i].tdev = tdev;
+		tdev->rxqs[i].fd = tdev->fds[i];
+		tdev->rxqs[i].lqueue_id = i;
+	}
+	for (i = 0; i < conf->nb_tx_queues; i++) {
+		tdev->txqs[i].tdev = tdev;
+		tdev->txqs[i].fd = tdev->fds[i];
+		tdev->txqs[i].lqueue_id = i;
+	}
+	tdev->rxq_cnt = conf->nb_rx_queues;
+	tdev->txq_cnt = conf->nb_tx_queues;
+
+	uk_pr_info(DRIVER_NAME": %s: Configured with %"__PRIu16" queue pairs\n",
+		   tdev->ifname, qpairs);
+	return 0;
+}
+
+static int tapnet_start(struct uk_netdev *n)
+{
+	struct tap_net_device *tdev;
+	__u16 i;
+
+	UK_ASSERT(n != NULL);
+	tdev = to_tapnetdev(n);
+
+	/*
+	 * By default, interrupts are disabled and it is up to the user or
+	 * network stack to manually enable them with a call to
+	 * enable_tx|rx_intr()
+	 */
+	for (i = 0; i < tdev->rxq_cnt; i++) {
+		if (unlikely(!tdev->rxqs[i].alloc_rxpkts)) {
+			uk_pr_err(DRIVER_NAME": Receive queue %"__PRIu16" is not set up\n",
+				  i);
+			return -EINVAL;
+		}
+		tdev->rxqs[i].intr_enabled = 0;
+	}
+
+	uk_pr_info(DRIVER_NAME": %"__PRIu16" started\n", tdev->uid);
+	return 0;
+}
+
+static void tapnet_info_get(struct uk_netdev *dev,
+			    struct uk_netdev_info *dev_info)
+{
+	struct tap_net_device *tdev;
+
+	UK_ASSERT(dev && dev_info);
+	tdev = to_tapnetdev(dev);
+
+	dev_info->max_rx_queues = tdev->max_qpairs;
+	dev_info->max_tx_queues = tdev->max_qpairs;
+	dev_info->in_queue_pairs = 1;
+	dev_info->max_mtu = tdev->mtu;
+	/* The virtio-net header is read and written with a separate iovec */
+	dev_info->nb_encap_tx = 0;
+	dev_info->nb_encap_rx = 0;
+	dev_info->ioalign = sizeof(void *); /* word size alignment */
+	dev_info->features = UK_FEATURE_RXQ_INTR_AVAILABLE
+			     | UK_FEATURE_TX_CSUM
+			     | UK_FEATURE_RX_CSUM
+			     | UK_FEATURE_TX_TSO4
+			     | UK_FEATURE_TX_TSO6;
+}
+
+static unsigned tapnet_promisc_get(struct uk_netdev *n __unused)
+{
+	/* The TAP interface hands us every frame of the host bridge */
+	return 1;
+}
+
+static const struct uk_hwaddr *tapnet_mac_get(struct uk_netdev *n)
+{
+	UK_ASSERT(n);
+	return &to_tapnetdev(n)->hw_addr;
+}
+
+static int tapnet_mac_set(struct uk_netdev *n,
+			  const struct uk_hwaddr *hwaddr)
+{
+	UK_ASSERT(n && hwaddr);
+	to_tapnetdev(n)->hw_addr = *hwaddr;
+	return 0;
+}
+
+static __u16 tapnet_mtu_get(struct uk_netdev *n)
+{
+	UK_ASSERT(n);
+	return to_tapnetdev(n)->mtu;
+}
+
+static const struct uk_netdev_ops tapnet_ops = {
+	.configure = tapnet_configure,
+	.rxq_configure = tapnet_rx_queue_setup,
+	.txq_configure = tapnet_tx_queue_setup,
+	.start = tapnet_start,
+	.rxq_intr_enable = tapnet_rx_intr_enable,
+	.rxq_intr_disable = tapnet_rx_intr_disable,
+	.info_get = tapnet_info_get,
+	.promiscuous_get = tapnet_promisc_get,
+	.hwaddr_get = tapnet_mac_get,
+	.hwaddr_set = tapnet_mac_set,
+	.mtu_get = tapnet_mtu_get,
+	.txq_info_get = tapnet_queue_info_get,
+	.rxq_info_get = tapnet_queue_info_get,
+};
+
+static int tapnet_add_dev(const char *ifname, __u16 idx)
+{
+	struct tap_net_device *tdev;
+	__u32 pid;
+	int fd;
+	int rc;
+
+	tdev = uk_calloc(a, 1, sizeof(*tdev));
+	if (!tdev)
+		return -ENOMEM;
+	strncpy(tdev->ifname, ifname, K_IFNAMSIZ - 1);
+
+	/* Prefer a multi-queue interface, fall back to a single queue */
+	tdev->ifflags = IFF_TAP | IFF_NO_PI | IFF_VNET_HDR | IFF_MULTI_QUEUE;
+	tdev->max_qpairs = TAPNET_MAX_QUEUE_PAIRS;
+	fd = tapnet_fd_open(tdev->ifname, tdev->ifflags);
+	if (fd == -K_EINVAL) {
+		tdev->ifflags &= ~IFF_MULTI_QUEUE;
+		tdev->max_qpairs = 1;
+		fd = tapnet_fd_open(tdev->ifname, tdev->ifflags);
+	}
+	if (fd < 0) {
+		uk_pr_err(DRIVER_NAME": %s: Failed to open interface: host error %d\n",
+			  tdev->ifname, -fd);
+		rc = -EIO;
+		goto err_free;
+	}
+	tdev->fds[0] = fd;
+	tdev->nb_fds = 1;
+
+	/* Locally administered address, unique per process and device */
+	pid = (__u32) sys_getpid();
+	tdev->hw_addr.addr_bytes[0] = 0x02;
+	tdev->hw_addr.addr_bytes[1] = 0x75;
+	tdev->hw_addr.addr_bytes[2] = 0x6b;
+	tdev->hw_addr.addr_bytes[3] = (pid >> 8) & 0xff;
+	tdev->hw_addr.addr_bytes[4] = pid & 0xff;
+	tdev->hw_addr.addr_bytes[5] = idx & 0xff;
+	tdev->mtu = TAPNET_MTU;
+
+	tdev->netdev.rx_one = tapnet_recv;
+	tdev->netdev.tx_one = tapnet_xmit;
+	tdev->netdev.rx_burst = tapnet_recv_burst;
+	tdev->netdev.tx_burst = tapnet_xmit_burst;
+	tdev->netdev.ops = &tapnet_ops;
+
+	rc = uk_netdev_drv_register(&tdev->netdev, a, drv_name);
+	if (rc < 0) {
+		uk_pr_err(DRIVER_NAME": %s: Failed to register with libuknetdev: %d\n",
+			  tdev->ifname, rc);
+		goto err_close;
+	}
+	tdev->uid = rc;
+	UK_TAILQ_INSERT_TAIL(&tapnet_list, tdev, next);
+
+	uk_pr_info(DRIVER_NAME": %"__PRIu16": Attached to %s (%s)\n",
+		   tdev->uid, tdev->ifname,
+		   (tdev->ifflags & IFF_MULTI_QUEUE) ? "multi-queue"
+						     : "single queue");
+	return 0;
+
+err_close:
+	sys_close(fd);
+err_free:
+	uk_free(a, tdev);
+	return rc;
+}
+
+static int tapnet_probe(void)
+{
+	char ifname[K_IFNAMSIZ];
+	const char *name, *end;
+	size_t len;
+	__u16 idx = 0;
+	int rc;
+
+	if (!tap_ifnames || tap_ifnames[0] == '\0')
+		return 0;
+
+	rc = ukplat_irq_register(SIGIO, tapnet_sigio_handle, NULL);
+	if (rc < 0) {
+		uk_pr_err(DRIVER_NAME": Failed to register SIGIO handler: %d\n",
+			  rc);
+		return rc;
+	}
+
+	for (name = tap_ifnames; *name != '\0'; name = end) {
+		end = strchr(name, ',');
+		if (!end)
+			end = name + strlen(name);
+		len = end - name;
+		if (*end == ',')
+			end++;
+
+		if (len == 0)
+			continue;
+		if (len >= K_IFNAMSIZ) {
+			uk_pr_err(DRIVER_NAME": Interface name too long: %.*s\n",
+				  (int) len, name);
+			continue;
+		}
+		memcpy(ifname, name, len);
+		ifname[len] = '\0';
+		if (tapnet_add_dev(ifname, idx) == 0)
+			idx++;
+	}
+	return 0;
+}
+
+static int tapnet_init(struct uk_alloc *drv_allocator)
+{
+	/* driver initialization */
+	if (!drv_allocator)
+		return -EINVAL;
+
+	a = drv_allocator;
+	return 0;
+}
+
+static struct uk_bus tapnet_bus = {
+	.init = tapnet_init,
+	.probe = tapnet_probe,
+};
+UK_BUS_REGISTER(&tapnet_bus);
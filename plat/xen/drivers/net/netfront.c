@@ -276,6 +276,42 @@ out:
 	return count;
 }
 
+/*
+ * Dequeues the next packet that passes the receive filter of the queue.
+ * Dropped packets are granted to the backend again.
+ * Returns the number of slots that have to be refilled.
+ */
+static int netfront_rxq_dequeue_filtered(struct uk_netdev_rx_queue *rxq,
+		struct uk_netbuf **netbuf)
+{
+	struct uk_netdev *n = &rxq->netfront_dev->netdev;
+	uint16_t budget = rxq->ring_size;
+	int count = 0;
+
+	do {
+		if (!netfront_rxq_dequeue(rxq, netbuf))
+			return count;
+
+		switch (uk_netdev_drv_rx_filter(n, rxq->lqueue_id, *netbuf)) {
+		case UK_NETDEV_RX_PASS:
+			return count + 1;
+		case UK_NETDEV_RX_DROP:
+			if (likely(netfront_rxq_enqueue(rxq, *netbuf) == 0))
+				break;
+			uk_netbuf_free(*netbuf);
+			count++;
+			break;
+		default:
+			/* Steered packets are refilled like received ones */
+			count++;
+			break;
+		}
+		*netbuf = NULL;
+	} while (--budget > 0);
+
+	return count;
+}
+
 static int netfront_rx_fillup(struct uk_netdev_rx_queue *rxq, uint16_t nb_desc)
 {
 	struct uk_netbuf *netbuf[nb_desc];
@@ -339,7 +375,7 @@ static int netfront_recv(struct uk_netdev *n,
 	/* Queue interrupts have to be off when calling receive */
 	UK_ASSERT(!(rxq->intr_enabled & NETFRONT_INTR_EN));
 
-	rc = netfront_rxq_dequeue(rxq, pkt);
+	rc = netfront_rxq_dequeue_filtered(rxq, pkt);
 	UK_ASSERT(rc >= 0);
 
 	status |= (*pkt) ? UK_NETDEV_STATUS_SUCCESS : 0x0;
@@ -354,9 +390,9 @@ static int netfront_recv(struct uk_netdev *n,
 			 * Packet arrive after reading the queue and before
 			 * enabling the interrupt
 			 */
-			rc = netfront_rxq_dequeue(rxq, pkt);
+			rc = netfront_rxq_dequeue_filtered(rxq, pkt);
 			UK_ASSERT(rc >= 0);
-			status |= UK_NETDEV_STATUS_SUCCESS;
+			status |= (*pkt) ? UK_NETDEV_STATUS_SUCCESS : 0x0;
 
 			/*
 			 * Since we received something, we need to fillup
@@ -35,6 +35,7 @@
 #include <string.h>
 #include <uk/arch/lcpu.h>
 #include <uk/plat/bootstrap.h>
+#include <uk/alloc.h>
 #include <errno.h>
 
 #include <xen/xen.h>
@@ -52,6 +53,10 @@ void ukplat_terminate(enum ukplat_gstate request)
 {
 	int reason;
 
+#if CONFIG_LIBUKALLOC_IFSTATS_DUMP || CONFIG_LIBUKALLOC_PROFILE_DUMP
+	uk_alloc_shutdown_dump();
+#endif
+
 	switch (request) {
 	case UKPLAT_HALT:
 		reason = SHUTDOWN_poweroff;